@@ -46,7 +46,6 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
     frame_id = page_table_.at(page_id);
     Page* p = &pages_[frame_id];
     p->pin_count_++;
-    p->is_dirty_ = true;
     replacer_->Pin(frame_id);
     latch_.unlock();
     return p;
@@ -83,15 +82,14 @@ bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
     frame_id = page_table_.at(page_id);
     Page* p = &pages_[frame_id];
     if (p->pin_count_ == 0){
+      latch_.unlock();
       return false;
     }
     p->pin_count_--;
-    p->is_dirty_ = is_dirty;
+    // a clean unpin must not hide the modification of another pinner, the page is written back on eviction
+    p->is_dirty_ = p->is_dirty_ || is_dirty;
     if (p->pin_count_ == 0) {
       replacer_->Unpin(frame_id);
-      if (p->IsDirty()){
-        disk_manager_->WritePage(page_id, p->GetData());
-      }
     }
     latch_.unlock();
     return true;
@@ -171,20 +169,27 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
         return false;
     }
     page_table_.erase(page_id);
+    // an unpinned frame is a victim candidate; it must not be handed out twice
+    replacer_->Pin(frame_id);
     p->page_id_ = INVALID_PAGE_ID;
     p->is_dirty_ = false;
     memset(p->GetData(), 0, PAGE_SIZE);
     free_list_.push_back(frame_id);
   }
   latch_.unlock();
+  disk_manager_->DeallocatePage(page_id);
   return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
   // You can do it!
   latch_.lock();
-  for(auto p : page_table_){
-    this->FlushPage(p.first);
+  for (auto entry : page_table_) {
+    Page *p = &pages_[entry.second];
+    if (p->IsDirty()) {
+      disk_manager_->WritePage(entry.first, p->GetData());
+      p->is_dirty_ = false;
+    }
   }
   latch_.unlock();
 }
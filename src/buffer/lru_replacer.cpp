@@ -14,32 +14,34 @@
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages){}
+LRUReplacer::LRUReplacer(size_t num_pages) { positions_.reserve(num_pages); }
 
 LRUReplacer::~LRUReplacer() = default;
 
-bool LRUReplacer::Victim(frame_id_t *frame_id) { 
-    if(!frames.empty()){
-        *frame_id = frames.front();
-        frames.remove(*frame_id);
-        return true;
-    }
-    return false; 
+bool LRUReplacer::Victim(frame_id_t *frame_id) {
+  if (frames_.empty()) {
+    return false;
+  }
+  *frame_id = frames_.front();
+  frames_.pop_front();
+  positions_.erase(*frame_id);
+  return true;
 }
 
 void LRUReplacer::Pin(frame_id_t frame_id) {
-    frames.remove(frame_id);
+  auto position = positions_.find(frame_id);
+  if (position != positions_.end()) {
+    frames_.erase(position->second);
+    positions_.erase(position);
+  }
 }
 
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-    bool list_contains_frame = std::find(frames.begin(), frames.end(), frame_id) != frames.end();
-    if(!list_contains_frame){
-        frames.push_back(frame_id);
-    }
+  if (positions_.count(frame_id) == 0) {
+    positions_[frame_id] = frames_.insert(frames_.end(), frame_id);
+  }
 }
 
-size_t LRUReplacer::Size() { 
-    return frames.size(); 
- }
+size_t LRUReplacer::Size() { return frames_.size(); }
 
 }  // namespace bustub
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util.cpp
+//
+// Identification: src/common/util/hash_util.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t kStripeLength = 64;
+constexpr size_t kLanes = kStripeLength / sizeof(uint64_t);
+// stripes between two scrambles of the accumulators
+constexpr size_t kStripesPerBlock = 16;
+// stripe i of a block reads the secret at word i, the scramble at kStripesPerBlock and the last stripe one word later
+constexpr size_t kSecretWords = kStripesPerBlock + kLanes + 1;
+constexpr uint64_t kPrime32 = 0x9e3779b1ULL;
+
+struct Secret {
+  uint64_t words_[kSecretWords];
+};
+
+/** @return pseudo-random secret words drawn from splitmix64 */
+constexpr Secret MakeSecret() {
+  Secret secret{};
+  uint64_t state = 0x853c49e6748fea9bULL;
+  for (auto &word : secret.words_) {
+    state += 0x9e3779b97f4a7c15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    word = z ^ (z >> 31);
+  }
+  return secret;
+}
+
+constexpr Secret kSecret = MakeSecret();
+
+/**
+ * Adds one stripe to the accumulators: each lane gets the product of the two 32-bit halves of its
+ * keyed input word, plus the raw input word of its neighbouring lane.
+ */
+inline void Accumulate(uint64_t *acc, const char *stripe, const uint64_t *secret) {
+#ifdef __AVX2__
+  for (size_t i = 0; i < kLanes; i += 4) {
+    __m256i acc_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i));
+    __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(stripe + i * sizeof(uint64_t)));
+    __m256i keyed = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret + i)));
+    __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+    __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    acc_vec = _mm256_add_epi64(acc_vec, _mm256_add_epi64(product, swapped));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + i), acc_vec);
+  }
+#else
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    uint64_t data;
+    memcpy(&data, stripe + lane * sizeof(uint64_t), sizeof(data));
+    uint64_t keyed = data ^ secret[lane];
+    acc[lane ^ 1] += data;
+    acc[lane] += (keyed & 0xffffffffULL) * (keyed >> 32);
+  }
+#endif
+}
+
+/** Mixes the high bits of each accumulator into its low bits, so that products in later blocks see them. */
+inline void Scramble(uint64_t *acc, const uint64_t *secret) {
+#ifdef __AVX2__
+  const __m256i prime = _mm256_set1_epi64x(kPrime32);
+  for (size_t i = 0; i < kLanes; i += 4) {
+    __m256i acc_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i));
+    acc_vec = _mm256_xor_si256(acc_vec, _mm256_srli_epi64(acc_vec, 47));
+    acc_vec = _mm256_xor_si256(acc_vec, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret + i)));
+    // 64-bit multiplication by a 32-bit constant
+    __m256i low = _mm256_mul_epu32(acc_vec, prime);
+    __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(acc_vec, 32), prime);
+    acc_vec = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + i), acc_vec);
+  }
+#else
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    acc[lane] = (acc[lane] ^ (acc[lane] >> 47) ^ secret[lane]) * kPrime32;
+  }
+#endif
+}
+
+}  // namespace
+
+hash_t HashUtil::HashLong(const char *bytes, size_t length) {
+  uint64_t acc[kLanes];
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    acc[lane] = kSecret.words_[lane];
+  }
+  // all stripes but the last, which is the final 64 bytes and may overlap the one before it
+  size_t num_stripes = (length - 1) / kStripeLength;
+  for (size_t stripe = 0; stripe < num_stripes; stripe++) {
+    size_t in_block = stripe % kStripesPerBlock;
+    Accumulate(acc, bytes + stripe * kStripeLength, kSecret.words_ + in_block);
+    if (in_block == kStripesPerBlock - 1) {
+      Scramble(acc, kSecret.words_ + kStripesPerBlock);
+    }
+  }
+  Accumulate(acc, bytes + length - kStripeLength, kSecret.words_ + kStripesPerBlock + 1);
+
+  uint64_t hash = length * kSecret0;
+  for (size_t lane = 0; lane < kLanes; lane += 2) {
+    hash += Mix(acc[lane] ^ kSecret.words_[lane + 1], acc[lane + 1] ^ kSecret.words_[lane + 2]);
+  }
+  hash ^= hash >> 37;
+  hash *= 0x165667919e3779f9ULL;
+  return hash ^ (hash >> 32);
+}
+
+}  // namespace bustub
@@ -0,0 +1,369 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table.cpp
+//
+// Identification: src/container/hash/cuckoo_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/cuckoo_hash_table.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+CUCKOO_HASH_TABLE_TYPE::CuckooHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                        const KeyComparator &comparator, size_t num_buckets,
+                                        HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  // a key needs two different buckets
+  HashTableHeaderPage *header = NewHeaderPage(std::max<size_t>(num_buckets, 2));
+  header_page_id_ = header->GetPageId();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *CUCKOO_HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableHeaderPage *CUCKOO_HASH_TABLE_TYPE::NewHeaderPage(size_t num_buckets) {
+  size_t num_blocks = (num_buckets - 1) / CUCKOO_BLOCK_BUCKETS + 1;
+  if (num_blocks > HEADER_MAX_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Hash table has too many blocks for its header page");
+  }
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id);
+  header->SetSize(num_buckets);
+  for (size_t i = 0; i < num_blocks; i++) {
+    // new pages are zeroed, which is a block of empty buckets
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table block page");
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+    header->AddBlockPageId(block_page_id);
+  }
+  return header;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id) {
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(FetchPage(header_page_id)->GetData());
+  for (size_t block_index = 0; block_index < header->NumBlocks(); block_index++) {
+    buffer_pool_manager_->DeletePage(header->GetBlockPageId(block_index));
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::Buckets(uint64_t hash, size_t num_buckets, size_t buckets[2]) const {
+  buckets[0] = (hash & 0xffffffff) % num_buckets;
+  buckets[1] = (hash >> 32) % num_buckets;
+  if (buckets[1] == buckets[0]) {
+    buckets[1] = (buckets[0] + 1) % num_buckets;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+void CUCKOO_HASH_TABLE_TYPE::LatchBuckets(HashTableHeaderPage *header, uint64_t hash, bool exclusive,
+                                          Visitor &&visit) {
+  size_t buckets[2];
+  Buckets(hash, header->GetSize(), buckets);
+  page_id_t page_ids[2];
+  size_t offsets[2];
+  for (size_t i = 0; i < 2; i++) {
+    page_ids[i] = header->GetBlockPageId(buckets[i] / CUCKOO_BLOCK_BUCKETS);
+    offsets[i] = buckets[i] % CUCKOO_BLOCK_BUCKETS;
+  }
+  // latch in page id order, and a page holding both buckets once
+  size_t order[2] = {0, 1};
+  if (page_ids[1] < page_ids[0]) {
+    std::swap(order[0], order[1]);
+  }
+  size_t num_pages = page_ids[0] == page_ids[1] ? 1 : 2;
+  Page *pages[2];
+  for (size_t i = 0; i < num_pages; i++) {
+    Page *page = FetchPage(page_ids[order[i]]);
+    if (exclusive) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    pages[order[i]] = page;
+  }
+  if (num_pages == 1) {
+    pages[1] = pages[0];
+  }
+
+  BlockPage *blocks[2] = {reinterpret_cast<BlockPage *>(pages[0]->GetData()),
+                          reinterpret_cast<BlockPage *>(pages[1]->GetData())};
+  visit(blocks, offsets);
+
+  for (size_t i = num_pages; i-- > 0;) {
+    Page *page = pages[order[i]];
+    if (exclusive) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), exclusive);
+  }
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  bool found = false;
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  LatchBuckets(reinterpret_cast<HashTableHeaderPage *>(header_page->GetData()), hash, false,
+               [&](BlockPage *blocks[2], const size_t offsets[2]) {
+                 found = blocks[0]->GetValue(offsets[0], key, fingerprint, comparator_, result);
+                 found = blocks[1]->GetValue(offsets[1], key, fingerprint, comparator_, result) || found;
+               });
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  bool exists = false;
+  bool inserted = false;
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  LatchBuckets(reinterpret_cast<HashTableHeaderPage *>(header_page->GetData()), hash, true,
+               [&](BlockPage *blocks[2], const size_t offsets[2]) {
+                 exists = blocks[0]->Contains(offsets[0], key, value, fingerprint, comparator_) ||
+                          blocks[1]->Contains(offsets[1], key, value, fingerprint, comparator_);
+                 if (exists) {
+                   return;
+                 }
+                 // the emptier bucket first, which keeps the buckets balanced
+                 size_t first = blocks[1]->Size(offsets[1]) < blocks[0]->Size(offsets[0]) ? 1 : 0;
+                 inserted = blocks[first]->Insert(offsets[first], key, value, fingerprint) ||
+                            blocks[1 - first]->Insert(offsets[1 - first], key, value, fingerprint);
+               });
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  if (exists || inserted) {
+    num_pairs_ += inserted ? 1 : 0;
+    return inserted;
+  }
+
+  // both buckets are full, displace pairs with the whole table to ourselves
+  table_latch_.WLock();
+  try {
+    inserted = InsertExclusive(key, value, hash);
+  } catch (...) {
+    // the table cannot grow any more; it is unchanged, and stays usable
+    table_latch_.WUnlock();
+    throw;
+  }
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::InsertExclusive(const KeyType &key, const ValueType &value, uint64_t hash) {
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  Page *header_page = FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+  // the buckets may have changed since they were latched
+  bool insertable = true;
+  LatchBuckets(header, hash, false, [&](BlockPage *blocks[2], const size_t offsets[2]) {
+    std::vector<ValueType> values;
+    blocks[0]->GetValue(offsets[0], key, fingerprint, comparator_, &values);
+    blocks[1]->GetValue(offsets[1], key, fingerprint, comparator_, &values);
+    insertable =
+        values.size() < 2 * CUCKOO_BUCKET_SLOTS && std::find(values.begin(), values.end(), value) == values.end();
+  });
+  if (!insertable) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return false;
+  }
+
+  MappingType pair(key, value);
+  bool placed = Place(header, &pair);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (!placed) {
+    Grow(pair);
+  }
+  num_pairs_++;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Place(HashTableHeaderPage *header, MappingType *pair) {
+  size_t num_buckets = header->GetSize();
+  uint64_t hash = hash_fn_.GetHash(pair->first);
+  size_t buckets[2];
+  Buckets(hash, num_buckets, buckets);
+  auto try_insert = [&](size_t bucket) {
+    page_id_t page_id = header->GetBlockPageId(bucket / CUCKOO_BLOCK_BUCKETS);
+    auto *block = reinterpret_cast<BlockPage *>(FetchPage(page_id)->GetData());
+    bool inserted =
+        block->Insert(bucket % CUCKOO_BLOCK_BUCKETS, pair->first, pair->second, BlockPage::Fingerprint(hash));
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    return inserted;
+  };
+  if (try_insert(buckets[0]) || try_insert(buckets[1])) {
+    return true;
+  }
+
+  // swaps the pair with the one in a slot, returning the pair that was there
+  auto swap_at = [&](size_t bucket, size_t slot, const MappingType &new_pair) {
+    page_id_t page_id = header->GetBlockPageId(bucket / CUCKOO_BLOCK_BUCKETS);
+    auto *block = reinterpret_cast<BlockPage *>(FetchPage(page_id)->GetData());
+    size_t offset = bucket % CUCKOO_BLOCK_BUCKETS;
+    MappingType old_pair(block->KeyAt(offset, slot), block->ValueAt(offset, slot));
+    block->SetAt(offset, slot, new_pair.first, new_pair.second,
+                 BlockPage::Fingerprint(hash_fn_.GetHash(new_pair.first)));
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return old_pair;
+  };
+
+  // a random walk: evict a random pair of a full bucket, then try the other bucket of the evicted pair
+  std::vector<std::pair<size_t, size_t>> displaced;
+  size_t bucket = buckets[generator_() % 2];
+  for (size_t step = 0; step < CUCKOO_MAX_DISPLACEMENTS; step++) {
+    size_t slot = generator_() % CUCKOO_BUCKET_SLOTS;
+    displaced.emplace_back(bucket, slot);
+    *pair = swap_at(bucket, slot, *pair);
+
+    hash = hash_fn_.GetHash(pair->first);
+    Buckets(hash, num_buckets, buckets);
+    bucket = buckets[0] == bucket ? buckets[1] : buckets[0];
+    if (try_insert(bucket)) {
+      return true;
+    }
+  }
+  // walk back, so that no pair is lost if the caller cannot make room for the one that is left over
+  for (auto it = displaced.rbegin(); it != displaced.rend(); ++it) {
+    *pair = swap_at(it->first, it->second, *pair);
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::Grow(const MappingType &orphan) {
+  std::vector<MappingType> pairs{orphan};
+  Page *old_header_page = FetchPage(header_page_id_);
+  auto *old_header = reinterpret_cast<HashTableHeaderPage *>(old_header_page->GetData());
+  size_t num_buckets = old_header->GetSize();
+  for (size_t block_index = 0; block_index < old_header->NumBlocks(); block_index++) {
+    page_id_t page_id = old_header->GetBlockPageId(block_index);
+    auto *block = reinterpret_cast<BlockPage *>(FetchPage(page_id)->GetData());
+    // the last block may be partially used
+    size_t block_end = std::min<size_t>(CUCKOO_BLOCK_BUCKETS, num_buckets - block_index * CUCKOO_BLOCK_BUCKETS);
+    for (size_t offset = 0; offset < block_end; offset++) {
+      for (size_t slot = 0; slot < CUCKOO_BUCKET_SLOTS; slot++) {
+        if (block->IsOccupied(offset, slot)) {
+          pairs.emplace_back(block->KeyAt(offset, slot), block->ValueAt(offset, slot));
+        }
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  // double until every pair fits
+  while (true) {
+    num_buckets *= 2;
+    HashTableHeaderPage *header = NewHeaderPage(num_buckets);
+    bool placed = true;
+    for (size_t i = 0; placed && i < pairs.size(); i++) {
+      MappingType pair = pairs[i];
+      placed = Place(header, &pair);
+    }
+    page_id_t header_page_id = header->GetPageId();
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+    if (placed) {
+      DeleteTable(header_page_id_);
+      header_page_id_ = header_page_id;
+      return;
+    }
+    DeleteTable(header_page_id);
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  bool removed = false;
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  LatchBuckets(reinterpret_cast<HashTableHeaderPage *>(header_page->GetData()), hash, true,
+               [&](BlockPage *blocks[2], const size_t offsets[2]) {
+                 removed = blocks[0]->Remove(offsets[0], key, value, fingerprint, comparator_) ||
+                           blocks[1]->Remove(offsets[1], key, value, fingerprint, comparator_);
+               });
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  num_pairs_ -= removed ? 1 : 0;
+  return removed;
+}
+
+/*****************************************************************************
+ * GETSIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::GetSize() {
+  return num_pairs_.load();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::GetNumBuckets() {
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  size_t num_buckets = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData())->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return num_buckets;
+}
+
+template class CuckooHashTable<int, int, IntComparator>;
+
+template class CuckooHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class CuckooHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class CuckooHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class CuckooHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class CuckooHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
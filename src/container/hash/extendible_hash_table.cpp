@@ -0,0 +1,367 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                                uint32_t header_max_depth, uint32_t directory_max_depth,
+                                                uint32_t bucket_max_size)
+    : index_name_(name),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      directory_max_depth_(directory_max_depth),
+      bucket_max_size_(bucket_max_size),
+      hash_fn_(std::move(hash_fn)) {
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table header page");
+  }
+  reinterpret_cast<HeaderPage *>(page->GetData())->Init(header_page_id_, header_max_depth);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  uint32_t hash = Hash(key);
+  Page *header_page = FetchPage(header_page_id_);
+  header_page->RLatch();
+  auto *header = reinterpret_cast<HeaderPage *>(header_page->GetData());
+  page_id_t directory_page_id = header->GetDirectoryPageId(header->HashToDirectoryIndex(hash));
+  header_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  // directories are never removed, so the header latch need not be held past this point
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  Page *directory_page = FetchPage(directory_page_id);
+  directory_page->RLatch();
+  auto *directory = reinterpret_cast<DirectoryPage *>(directory_page->GetData());
+  page_id_t bucket_page_id = directory->GetBucketPageId(directory->HashToBucketIndex(hash));
+  Page *bucket_page = FetchPage(bucket_page_id);
+  bucket_page->RLatch();
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+
+  bool found = reinterpret_cast<BucketPage *>(bucket_page->GetData())->GetValue(key, comparator_, result);
+  bucket_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint32_t hash = Hash(key);
+  page_id_t directory_page_id = GetOrCreateDirectory(hash);
+  while (true) {
+    Page *directory_page = FetchPage(directory_page_id);
+    directory_page->RLatch();
+    auto *directory = reinterpret_cast<DirectoryPage *>(directory_page->GetData());
+    page_id_t bucket_page_id = directory->GetBucketPageId(directory->HashToBucketIndex(hash));
+    Page *bucket_page = FetchPage(bucket_page_id);
+    bucket_page->WLatch();
+    directory_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+
+    auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+    bool duplicate = bucket->Contains(key, value, comparator_);
+    bool inserted = !duplicate && bucket->Insert(key, value);
+    bucket_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+    if (duplicate || inserted) {
+      return inserted;
+    }
+    // the bucket is full: split it and try again
+    if (!SplitBucket(directory_page_id, hash)) {
+      return false;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t EXTENDIBLE_HASH_TABLE_TYPE::GetOrCreateDirectory(uint32_t hash) {
+  Page *header_page = FetchPage(header_page_id_);
+  header_page->RLatch();
+  auto *header = reinterpret_cast<HeaderPage *>(header_page->GetData());
+  uint32_t directory_index = header->HashToDirectoryIndex(hash);
+  page_id_t directory_page_id = header->GetDirectoryPageId(directory_index);
+  header_page->RUnlatch();
+  if (directory_page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return directory_page_id;
+  }
+
+  header_page->WLatch();
+  // another insert may have created it in between
+  directory_page_id = header->GetDirectoryPageId(directory_index);
+  bool created = directory_page_id == INVALID_PAGE_ID;
+  if (created) {
+    Page *directory_page = buffer_pool_manager_->NewPage(&directory_page_id);
+    if (directory_page == nullptr) {
+      header_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(header_page_id_, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table directory page");
+    }
+    page_id_t bucket_page_id;
+    Page *bucket_page = NewBucketPage(&bucket_page_id);
+    bucket_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    auto *directory = reinterpret_cast<DirectoryPage *>(directory_page->GetData());
+    directory->Init(directory_page_id, directory_max_depth_);
+    directory->SetBucketPageId(0, bucket_page_id);
+    buffer_pool_manager_->UnpinPage(directory_page_id, true);
+    header->SetDirectoryPageId(directory_index, directory_page_id);
+  }
+  header_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, created);
+  return directory_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::NewBucketPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table bucket page");
+  }
+  page->WLatch();
+  reinterpret_cast<BucketPage *>(page->GetData())->Init(bucket_max_size_);
+  return page;
+}
+
+/*
+ * Splitting only needs the directory and the bucket: the pairs whose hash has
+ * the next bit set move to a new bucket, and the directory slots that agree
+ * with the bucket on its old local depth bits are divided between the two.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(page_id_t directory_page_id, uint32_t hash) {
+  Page *directory_page = FetchPage(directory_page_id);
+  directory_page->WLatch();
+  auto *directory = reinterpret_cast<DirectoryPage *>(directory_page->GetData());
+  uint32_t bucket_index = directory->HashToBucketIndex(hash);
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_index);
+  Page *bucket_page = FetchPage(bucket_page_id);
+  bucket_page->WLatch();
+  auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+
+  bool splittable = true;
+  bool split = false;
+  // another insert may have split it already, or a remove made room
+  if (bucket->IsFull()) {
+    uint32_t local_depth = directory->GetLocalDepth(bucket_index);
+    if (local_depth == directory->GetGlobalDepth()) {
+      if (local_depth == directory->GetMaxDepth()) {
+        splittable = false;
+      } else {
+        directory->IncrGlobalDepth();
+      }
+    }
+    if (splittable) {
+      page_id_t image_page_id;
+      Page *image_page = NewBucketPage(&image_page_id);
+      auto *image = reinterpret_cast<BucketPage *>(image_page->GetData());
+      uint32_t high_bit = 1U << local_depth;
+      for (uint32_t i = 0; i < directory->Size(); i++) {
+        if (directory->GetBucketPageId(i) == bucket_page_id) {
+          directory->SetLocalDepth(i, local_depth + 1);
+          if ((i & high_bit) != 0) {
+            directory->SetBucketPageId(i, image_page_id);
+          }
+        }
+      }
+      // iterate backwards, since RemoveAt moves the last pair into the hole
+      for (uint32_t i = bucket->Size(); i > 0; i--) {
+        KeyType key = bucket->KeyAt(i - 1);
+        if ((Hash(key) & high_bit) != 0) {
+          image->Insert(key, bucket->ValueAt(i - 1));
+          bucket->RemoveAt(i - 1);
+        }
+      }
+      image_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(image_page_id, true);
+      split = true;
+    }
+  }
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, split);
+  directory_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, split);
+  return splittable;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint32_t hash = Hash(key);
+  Page *header_page = FetchPage(header_page_id_);
+  header_page->RLatch();
+  auto *header = reinterpret_cast<HeaderPage *>(header_page->GetData());
+  page_id_t directory_page_id = header->GetDirectoryPageId(header->HashToDirectoryIndex(hash));
+  header_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  Page *directory_page = FetchPage(directory_page_id);
+  directory_page->RLatch();
+  auto *directory = reinterpret_cast<DirectoryPage *>(directory_page->GetData());
+  page_id_t bucket_page_id = directory->GetBucketPageId(directory->HashToBucketIndex(hash));
+  Page *bucket_page = FetchPage(bucket_page_id);
+  bucket_page->WLatch();
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+
+  auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+  bool removed = bucket->Remove(key, value, comparator_);
+  bool empty = bucket->IsEmpty();
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  if (removed && empty) {
+    MergeBucket(directory_page_id, hash);
+  }
+  return removed;
+}
+
+/*
+ * An empty bucket is dropped in favour of its split image, or the other way
+ * round, as long as both have the same local depth. Merging repeats since the
+ * merged bucket may be able to merge again one level up.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::MergeBucket(page_id_t directory_page_id, uint32_t hash) {
+  Page *directory_page = FetchPage(directory_page_id);
+  directory_page->WLatch();
+  auto *directory = reinterpret_cast<DirectoryPage *>(directory_page->GetData());
+  bool merged = false;
+  while (true) {
+    uint32_t bucket_index = directory->HashToBucketIndex(hash);
+    uint32_t local_depth = directory->GetLocalDepth(bucket_index);
+    uint32_t image_index = directory->GetSplitImageIndex(bucket_index);
+    if (local_depth == 0 || directory->GetLocalDepth(image_index) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_index);
+    page_id_t image_page_id = directory->GetBucketPageId(image_index);
+    Page *bucket_page = FetchPage(bucket_page_id);
+    bucket_page->RLatch();
+    bool bucket_empty = reinterpret_cast<BucketPage *>(bucket_page->GetData())->IsEmpty();
+    bucket_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    Page *image_page = FetchPage(image_page_id);
+    image_page->RLatch();
+    bool image_empty = reinterpret_cast<BucketPage *>(image_page->GetData())->IsEmpty();
+    image_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+
+    // keep the one that may hold pairs; nobody can reach the other without the directory latch
+    page_id_t keep_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    page_id_t drop_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      page_id_t page_id = directory->GetBucketPageId(i);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        directory->SetBucketPageId(i, keep_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(drop_page_id);
+    merged = true;
+  }
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+  }
+  directory_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, merged);
+}
+
+/*****************************************************************************
+ * INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  Page *header_page = FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HeaderPage *>(header_page->GetData());
+  for (uint32_t i = 0; i < header->MaxSize(); i++) {
+    page_id_t directory_page_id = header->GetDirectoryPageId(i);
+    if (directory_page_id != INVALID_PAGE_ID) {
+      Page *directory_page = FetchPage(directory_page_id);
+      reinterpret_cast<DirectoryPage *>(directory_page->GetData())->VerifyIntegrity();
+      buffer_pool_manager_->UnpinPage(directory_page_id, false);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  uint32_t global_depth = 0;
+  Page *header_page = FetchPage(header_page_id_);
+  header_page->RLatch();
+  auto *header = reinterpret_cast<HeaderPage *>(header_page->GetData());
+  for (uint32_t i = 0; i < header->MaxSize(); i++) {
+    page_id_t directory_page_id = header->GetDirectoryPageId(i);
+    if (directory_page_id != INVALID_PAGE_ID) {
+      Page *directory_page = FetchPage(directory_page_id);
+      directory_page->RLatch();
+      global_depth =
+          std::max(global_depth, reinterpret_cast<DirectoryPage *>(directory_page->GetData())->GetGlobalDepth());
+      directory_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(directory_page_id, false);
+    }
+  }
+  header_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return global_depth;
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
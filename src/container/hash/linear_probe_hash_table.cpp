@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -25,22 +26,396 @@ namespace bustub {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+                                      HashFunction<KeyType> hash_fn, HashTableGrowth growth, double max_load_factor)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      growth_(growth),
+      max_load_factor_(max_load_factor) {
+  num_buckets = std::max<size_t>(num_buckets, 1);
+  initial_blocks_ = (num_buckets - 1) / BLOCK_ARRAY_SIZE + 1;
+  num_blocks_ = initial_blocks_;
+  if (growth_ == HashTableGrowth::LinearHashing) {
+    // buckets are whole blocks
+    num_buckets = initial_blocks_ * BLOCK_ARRAY_SIZE;
+  }
+  HashTableHeaderPage *header = NewHeaderPage(num_buckets);
+  header_page_id_ = header->GetPageId();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableHeaderPage *HASH_TABLE_TYPE::NewHeaderPage(size_t num_buckets) {
+  size_t num_blocks = (num_buckets - 1) / BLOCK_ARRAY_SIZE + 1;
+  if (num_blocks > HEADER_MAX_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Hash table has too many blocks for its header page");
+  }
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id);
+  header->SetSize(num_buckets);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    Page *block_page = buffer_pool_manager_->NewPage(&block_page_id);
+    if (block_page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table block page");
+    }
+    reinterpret_cast<BlockPage *>(block_page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+    header->AddBlockPageId(block_page_id);
+  }
+  return header;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+void HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header, uint64_t hash, Visitor &&visit, Page *first_page) {
+  size_t size = header->GetSize();
+  size_t slot = hash % size;
+  size_t remaining = size;
+  while (remaining > 0) {
+    size_t block_index = slot / BLOCK_ARRAY_SIZE;
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    // the last block may be partially used
+    size_t block_end = std::min<size_t>(BLOCK_ARRAY_SIZE, size - block_index * BLOCK_ARRAY_SIZE);
+    page_id_t block_page_id = header->GetBlockPageId(block_index);
+    Page *page = first_page != nullptr ? first_page : FetchPage(block_page_id);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    bool done = false;
+    while (!done && offset < block_end && remaining > 0) {
+      size_t n = std::min<size_t>({HASH_TABLE_BLOCK_GROUP_SIZE, block_end - offset, remaining});
+      done = visit(block, block_page_id, offset, n);
+      offset += n;
+      remaining -= n;
+    }
+    if (first_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(block_page_id, false);
+    }
+    first_page = nullptr;
+    if (done) {
+      return;
+    }
+    slot = (block_index + 1) * BLOCK_ARRAY_SIZE;
+    if (slot >= size) {
+      slot = 0;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+page_id_t HASH_TABLE_TYPE::ProbeBucket(Page *bucket_page, uint64_t hash, Visitor &&visit) {
+  // the low bits of the hash pick the bucket, so start from the high ones
+  slot_offset_t start = (hash >> 32) % BLOCK_ARRAY_SIZE;
+  auto *block = reinterpret_cast<BlockPage *>(bucket_page->GetData());
+  page_id_t block_page_id = bucket_page->GetPageId();
+  for (slot_offset_t offset = start; offset < start + BLOCK_ARRAY_SIZE;) {
+    slot_offset_t bucket_ind = offset < BLOCK_ARRAY_SIZE ? offset : offset - BLOCK_ARRAY_SIZE;
+    size_t n = std::min<size_t>(
+        {HASH_TABLE_BLOCK_GROUP_SIZE, BLOCK_ARRAY_SIZE - bucket_ind, start + BLOCK_ARRAY_SIZE - offset});
+    if (visit(block, block_page_id, bucket_ind, n)) {
+      return INVALID_PAGE_ID;
+    }
+    offset += n;
+  }
+
+  // overflow blocks are filled front to back and are covered by the latch of the primary block
+  page_id_t next_page_id = block->GetNextPageId();
+  while (next_page_id != INVALID_PAGE_ID) {
+    block_page_id = next_page_id;
+    block = reinterpret_cast<BlockPage *>(FetchPage(block_page_id)->GetData());
+    bool done = false;
+    for (slot_offset_t offset = 0; !done && offset < BLOCK_ARRAY_SIZE; offset += HASH_TABLE_BLOCK_GROUP_SIZE) {
+      done = visit(block, block_page_id, offset,
+                   std::min<size_t>(HASH_TABLE_BLOCK_GROUP_SIZE, BLOCK_ARRAY_SIZE - offset));
+    }
+    next_page_id = block->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    if (done) {
+      return INVALID_PAGE_ID;
+    }
+  }
+  return block_page_id;
+}
+
+// keeps the matches before the first never occupied slot, which ends the probe
+static inline uint32_t MatchesBeforeEmpty(uint32_t matches, uint32_t empties) {
+  return empties == 0 ? matches : matches & ((1U << __builtin_ctz(empties)) - 1);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::ReadMatches(BlockPage *block, slot_offset_t offset, size_t n, const KeyType &key,
+                                  uint8_t fingerprint, MappingType *pairs, std::vector<ValueType> *result) {
+  uint32_t matches;
+  uint32_t empties;
+  block->ReadGroup(offset, n, fingerprint, &matches, &empties, pairs);
+  for (matches = MatchesBeforeEmpty(matches, empties); matches != 0; matches &= matches - 1) {
+    uint32_t i = __builtin_ctz(matches);
+    if (comparator_(pairs[i].first, key) == 0) {
+      result->push_back(pairs[i].second);
+    }
+  }
+  return empties != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::FindPair(HashTableHeaderPage *header, Page *bucket_page, uint64_t hash, const KeyType &key,
+                               const ValueType &value, page_id_t *page_id, slot_offset_t *bucket_ind) {
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  bool found = false;
+  MappingType pairs[HASH_TABLE_BLOCK_GROUP_SIZE];
+  auto visit = [&](BlockPage *block, page_id_t block_page_id, slot_offset_t offset, size_t n) {
+    uint32_t matches;
+    uint32_t empties;
+    block->ReadGroup(offset, n, fingerprint, &matches, &empties, pairs);
+    for (matches = MatchesBeforeEmpty(matches, empties); matches != 0; matches &= matches - 1) {
+      uint32_t i = __builtin_ctz(matches);
+      if (comparator_(pairs[i].first, key) == 0 && pairs[i].second == value) {
+        *page_id = block_page_id;
+        *bucket_ind = offset + i;
+        found = true;
+        return true;
+      }
+    }
+    return empties != 0;
+  };
+  if (bucket_page == nullptr) {
+    Probe(header, hash, visit);
+  } else {
+    ProbeBucket(bucket_page, hash, visit);
+  }
+  return found;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  size_t result_size = result->size();
+  MappingType pairs[HASH_TABLE_BLOCK_GROUP_SIZE];
+  auto visit = [&](BlockPage *block, page_id_t block_page_id, slot_offset_t offset, size_t n) {
+    return ReadMatches(block, offset, n, key, fingerprint, pairs, result);
+  };
+
+  if (growth_ == HashTableGrowth::LinearHashing) {
+    Page *header_page = FetchPage(header_page_id_);
+    Page *bucket_page = LatchBucket(reinterpret_cast<HashTableHeaderPage *>(header_page->GetData()), hash, false);
+    ProbeBucket(bucket_page, hash, visit);
+    bucket_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), false);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return result->size() > result_size;
+  }
+
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  Probe(reinterpret_cast<HashTableHeaderPage *>(header_page->GetData()), hash, visit);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return result->size() > result_size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                                std::vector<std::vector<ValueType>> *results) {
+  results->resize(keys.size());
+  bool linear_hashing = growth_ == HashTableGrowth::LinearHashing;
+  // the table latch and the header are taken once for the whole batch
+  if (!linear_hashing) {
+    table_latch_.RLock();
+  }
+  Page *header_page = FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+  size_t size = header->GetSize();
+  uint64_t hashes[HASH_TABLE_PREFETCH_GROUP];
+  Page *pages[HASH_TABLE_PREFETCH_GROUP];
+  MappingType pairs[HASH_TABLE_BLOCK_GROUP_SIZE];
+
+  for (size_t group = 0; group < keys.size(); group += HASH_TABLE_PREFETCH_GROUP) {
+    size_t group_size = std::min<size_t>(HASH_TABLE_PREFETCH_GROUP, keys.size() - group);
+    // (1) hash the keys, pin the blocks where their probes start and start loading their first slots
+    for (size_t i = 0; i < group_size; i++) {
+      hashes[i] = hash_fn_.GetHash(keys[group + i]);
+      size_t slot;
+      if (linear_hashing) {
+        // only a hint: the bucket may split before it is latched
+        slot = BucketIndex(hashes[i], num_blocks_.load()) * BLOCK_ARRAY_SIZE + (hashes[i] >> 32) % BLOCK_ARRAY_SIZE;
+      } else {
+        slot = hashes[i] % size;
+      }
+      pages[i] = FetchPage(header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE));
+      reinterpret_cast<BlockPage *>(pages[i]->GetData())->Prefetch(slot % BLOCK_ARRAY_SIZE);
+    }
+    // (2) probe, by now the first slots are likely in the cache
+    for (size_t i = 0; i < group_size; i++) {
+      const KeyType &key = keys[group + i];
+      uint8_t fingerprint = BlockPage::Fingerprint(hashes[i]);
+      std::vector<ValueType> *result = &(*results)[group + i];
+      auto visit = [&](BlockPage *block, page_id_t block_page_id, slot_offset_t offset, size_t n) {
+        return ReadMatches(block, offset, n, key, fingerprint, pairs, result);
+      };
+      if (linear_hashing) {
+        Page *bucket_page = LatchBucket(header, hashes[i], false);
+        ProbeBucket(bucket_page, hashes[i], visit);
+        bucket_page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), false);
+      } else {
+        Probe(header, hashes[i], visit, pages[i]);
+      }
+      buffer_pool_manager_->UnpinPage(pages[i]->GetPageId(), false);
+    }
+  }
+
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (!linear_hashing) {
+    table_latch_.RUnlock();
+  }
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  if (growth_ == HashTableGrowth::LinearHashing) {
+    Page *header_page = FetchPage(header_page_id_);
+    auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+    Page *bucket_page = LatchBucket(header, hash, true);
+    bool full = false;
+    bool inserted = InsertLocked(header, bucket_page, key, value, &full);
+    bucket_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), inserted);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    // amortize the growth of the table over the inserts
+    if (inserted && ++num_pairs_ > max_load_factor_ * num_blocks_.load() * BLOCK_ARRAY_SIZE) {
+      SplitBucket();
+    }
+    return inserted;
+  }
+
+  table_latch_.RLock();
+  bool inserted;
+  while (true) {
+    Page *header_page = FetchPage(header_page_id_);
+    auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+    size_t size = header->GetSize();
+    bool full = false;
+    {
+      std::lock_guard<std::mutex> guard(key_latches_[hash % HASH_TABLE_KEY_LATCHES]);
+      inserted = InsertLocked(header, nullptr, key, value, &full);
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    if (!full) {
+      break;
+    }
+    table_latch_.RUnlock();
+    table_latch_.WLock();
+    // unless another insert resized the table already
+    header_page = FetchPage(header_page_id_);
+    bool resize = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData())->GetSize() == size;
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    if (resize) {
+      ResizeLocked(size);
+    }
+    table_latch_.WUnlock();
+    table_latch_.RLock();
+  }
+  table_latch_.RUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::InsertLocked(HashTableHeaderPage *header, Page *bucket_page, const KeyType &key,
+                                   const ValueType &value, bool *full) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t fingerprint = BlockPage::Fingerprint(hash);
+  MappingType pairs[HASH_TABLE_BLOCK_GROUP_SIZE];
+  while (true) {
+    // the first slot without a pair, if any
+    page_id_t free_page_id = INVALID_PAGE_ID;
+    slot_offset_t free_slot = 0;
+    bool duplicate = false;
+    auto visit = [&](BlockPage *block, page_id_t block_page_id, slot_offset_t offset, size_t n) {
+      uint32_t matches;
+      uint32_t empties;
+      block->ReadGroup(offset, n, fingerprint, &matches, &empties, pairs);
+      for (matches = MatchesBeforeEmpty(matches, empties); matches != 0; matches &= matches - 1) {
+        uint32_t i = __builtin_ctz(matches);
+        if (comparator_(pairs[i].first, key) == 0 && pairs[i].second == value) {
+          duplicate = true;
+          return true;
+        }
+      }
+      if (free_page_id == INVALID_PAGE_ID) {
+        // only a hint without the latch of the block, checked by the insert below
+        uint32_t tombstones;
+        uint32_t unused;
+        block->MatchGroup(offset, n, HASH_TABLE_FINGERPRINT_TOMBSTONE, &tombstones, &unused);
+        if ((tombstones | empties) != 0) {
+          free_page_id = block_page_id;
+          free_slot = offset + __builtin_ctz(tombstones | empties);
+        }
+      }
+      return empties != 0;
+    };
+
+    page_id_t last_page_id = INVALID_PAGE_ID;
+    if (bucket_page == nullptr) {
+      Probe(header, hash, visit);
+    } else {
+      last_page_id = ProbeBucket(bucket_page, hash, visit);
+    }
+    if (duplicate) {
+      return false;
+    }
+    if (free_page_id == INVALID_PAGE_ID) {
+      if (bucket_page == nullptr) {
+        *full = true;
+        return false;
+      }
+      // the bucket is full, chain another overflow block to it
+      Page *page = buffer_pool_manager_->NewPage(&free_page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table block page");
+      }
+      reinterpret_cast<BlockPage *>(page->GetData())->Init();
+      buffer_pool_manager_->UnpinPage(free_page_id, true);
+      Page *last_page = FetchPage(last_page_id);
+      reinterpret_cast<BlockPage *>(last_page->GetData())->SetNextPageId(free_page_id);
+      buffer_pool_manager_->UnpinPage(last_page_id, true);
+    }
+
+    // with linear hashing, the latch of the bucket covers all its blocks
+    Page *page = FetchPage(free_page_id);
+    if (bucket_page == nullptr) {
+      page->WLatch();
+    }
+    bool inserted = reinterpret_cast<BlockPage *>(page->GetData())->Insert(free_slot, key, value, fingerprint);
+    if (bucket_page == nullptr) {
+      page->WUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(free_page_id, inserted);
+    if (inserted) {
+      return true;
+    }
+    // another insert took the slot first
+  }
 }
 
 /*****************************************************************************
@@ -48,21 +423,204 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  page_id_t page_id;
+  slot_offset_t bucket_ind;
+  if (growth_ == HashTableGrowth::LinearHashing) {
+    Page *header_page = FetchPage(header_page_id_);
+    auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+    Page *bucket_page = LatchBucket(header, hash, true);
+    bool removed = FindPair(header, bucket_page, hash, key, value, &page_id, &bucket_ind);
+    if (removed) {
+      reinterpret_cast<BlockPage *>(FetchPage(page_id)->GetData())->Remove(bucket_ind);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      num_pairs_--;
+    }
+    bucket_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), false);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return removed;
+  }
+
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  bool removed;
+  {
+    // the pair cannot move while the key latch is held
+    std::lock_guard<std::mutex> guard(key_latches_[hash % HASH_TABLE_KEY_LATCHES]);
+    removed = FindPair(reinterpret_cast<HashTableHeaderPage *>(header_page->GetData()), nullptr, hash, key, value,
+                       &page_id, &bucket_ind);
+    if (removed) {
+      Page *page = FetchPage(page_id);
+      page->WLatch();
+      reinterpret_cast<BlockPage *>(page->GetData())->Remove(bucket_ind);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  if (growth_ == HashTableGrowth::LinearHashing) {
+    return;
+  }
+  table_latch_.WLock();
+  ResizeLocked(initial_size);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ResizeLocked(size_t initial_size) {
+  Page *old_header_page = FetchPage(header_page_id_);
+  auto *old_header = reinterpret_cast<HashTableHeaderPage *>(old_header_page->GetData());
+  size_t old_size = old_header->GetSize();
+  // never shrink below the pairs already in the table
+  HashTableHeaderPage *header = NewHeaderPage(std::max(2 * initial_size, old_size));
+
+  for (size_t block_index = 0; block_index < old_header->NumBlocks(); block_index++) {
+    page_id_t block_page_id = old_header->GetBlockPageId(block_index);
+    auto *block = reinterpret_cast<BlockPage *>(FetchPage(block_page_id)->GetData());
+    size_t block_end = std::min<size_t>(BLOCK_ARRAY_SIZE, old_size - block_index * BLOCK_ARRAY_SIZE);
+    for (slot_offset_t bucket_ind = 0; bucket_ind < block_end; bucket_ind++) {
+      if (block->IsReadable(bucket_ind)) {
+        bool full = false;
+        InsertLocked(header, nullptr, block->KeyAt(bucket_ind), block->ValueAt(bucket_ind), &full);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->DeletePage(header_page_id_);
+  header_page_id_ = header->GetPageId();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * LINEAR HASHING
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::BucketIndex(uint64_t hash, size_t num_blocks) const {
+  // the number of buckets at the start of the current round
+  size_t round_blocks = initial_blocks_;
+  while (2 * round_blocks <= num_blocks) {
+    round_blocks *= 2;
+  }
+  // buckets below num_blocks - round_blocks have been split in this round already
+  size_t bucket = hash % (2 * round_blocks);
+  return bucket < num_blocks ? bucket : bucket - round_blocks;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::LatchBucket(HashTableHeaderPage *header, uint64_t hash, bool exclusive) {
+  while (true) {
+    size_t bucket = BucketIndex(hash, num_blocks_.load());
+    page_id_t bucket_page_id = header->GetBlockPageId(bucket);
+    Page *page = FetchPage(bucket_page_id);
+    if (exclusive) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    // the bucket may have been split while waiting for its latch
+    if (BucketIndex(hash, num_blocks_.load()) == bucket) {
+      return page;
+    }
+    if (exclusive) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::SplitBucket() {
+  std::unique_lock<std::mutex> lock(split_latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // another insert is splitting, the next one catches up
+    return;
+  }
+  size_t num_blocks = num_blocks_.load();
+  if (num_pairs_.load() <= max_load_factor_ * num_blocks * BLOCK_ARRAY_SIZE || num_blocks == HEADER_MAX_BLOCKS) {
+    return;
+  }
+  size_t round_blocks = initial_blocks_;
+  while (2 * round_blocks <= num_blocks) {
+    round_blocks *= 2;
+  }
+  size_t bucket = num_blocks - round_blocks;
+
+  // nobody reaches the new bucket before num_blocks_ is raised
+  Page *header_page = FetchPage(header_page_id_);
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table block page");
+  }
+  reinterpret_cast<BlockPage *>(new_page->GetData())->Init();
+  header->AddBlockPageId(new_page_id);
+  header->SetSize((num_blocks + 1) * BLOCK_ARRAY_SIZE);
+
+  page_id_t bucket_page_id = header->GetBlockPageId(bucket);
+  Page *bucket_page = FetchPage(bucket_page_id);
+  bucket_page->WLatch();
+  // take all pairs out of the bucket, freeing its overflow blocks
+  std::vector<MappingType> pairs;
+  for (page_id_t block_page_id = bucket_page_id; block_page_id != INVALID_PAGE_ID;) {
+    auto *block = reinterpret_cast<BlockPage *>(FetchPage(block_page_id)->GetData());
+    for (slot_offset_t bucket_ind = 0; bucket_ind < BLOCK_ARRAY_SIZE; bucket_ind++) {
+      if (block->IsReadable(bucket_ind)) {
+        pairs.emplace_back(block->KeyAt(bucket_ind), block->ValueAt(bucket_ind));
+      }
+    }
+    page_id_t next_page_id = block->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    if (block_page_id != bucket_page_id) {
+      buffer_pool_manager_->DeletePage(block_page_id);
+    }
+    block_page_id = next_page_id;
+  }
+  reinterpret_cast<BlockPage *>(bucket_page->GetData())->Init();
+  for (const auto &pair : pairs) {
+    bool full = false;
+    Page *target = BucketIndex(hash_fn_.GetHash(pair.first), num_blocks + 1) == bucket ? bucket_page : new_page;
+    InsertLocked(header, target, pair.first, pair.second, &full);
+  }
+
+  // publish the new bucket while operations on the split one still wait
+  num_blocks_.store(num_blocks + 1);
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  if (growth_ == HashTableGrowth::LinearHashing) {
+    return num_blocks_.load() * BLOCK_ARRAY_SIZE;
+  }
+  table_latch_.RLock();
+  Page *header_page = FetchPage(header_page_id_);
+  size_t size = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData())->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
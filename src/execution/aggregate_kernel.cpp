@@ -0,0 +1,298 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_kernel.cpp
+//
+// Identification: src/execution/aggregate_kernel.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregate_kernel.h"
+
+#include <limits>
+#include <type_traits>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "common/util/hash_util.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the type of the values whose raw data is a T */
+template <typename T>
+constexpr TypeId TypeIdOf() {
+  if constexpr (std::is_same_v<T, int8_t>) {
+    return TypeId::TINYINT;
+  } else if constexpr (std::is_same_v<T, int16_t>) {
+    return TypeId::SMALLINT;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return TypeId::INTEGER;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return TypeId::BIGINT;
+  } else {
+    static_assert(std::is_same_v<T, double>, "Numbers are integers or doubles.");
+    return TypeId::DECIMAL;
+  }
+}
+
+/** The type that the inputs of type T are accumulated in. */
+template <typename T>
+using Accumulator = std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+
+template <typename A>
+A &AccumulatorOf(AggregateState *state) {
+  if constexpr (std::is_same_v<A, double>) {
+    return state->real_;
+  } else {
+    return state->int_;
+  }
+}
+
+template <typename A>
+A AccumulatorOf(const AggregateState &state) {
+  if constexpr (std::is_same_v<A, double>) {
+    return state.real_;
+  } else {
+    return state.int_;
+  }
+}
+
+[[noreturn]] void ThrowOutOfRange() { throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range."); }
+
+void Init(AggregateState *state, AggregateStorage * /*storage*/) { *state = AggregateState(); }
+
+template <void (*Update)(AggregateState *, AggregateStorage *, const Value &)>
+void UpdateBatch(AggregateState *states, const uint32_t *groups, const std::vector<Value> &inputs,
+                 const std::vector<uint32_t> &rows, AggregateStorage *storage) {
+  for (size_t i = 0; i < rows.size(); i++) {
+    Update(&states[groups[i]], storage, inputs[rows[i]]);
+  }
+}
+
+/*
+ * COUNT
+ */
+
+void UpdateCount(AggregateState *state, AggregateStorage * /*storage*/, const Value & /*input*/) { state->count_++; }
+
+void MergeCount(AggregateState *state, AggregateStorage * /*storage*/, const AggregateState &partial,
+                const AggregateStorage & /*partial_storage*/) {
+  state->count_ += partial.count_;
+}
+
+Value FinalizeCount(const AggregateState &state, const AggregateStorage & /*storage*/) {
+  if (state.count_ > BUSTUB_INT32_MAX) {
+    ThrowOutOfRange();
+  }
+  return ValueFactory::GetIntegerValue(static_cast<int32_t>(state.count_));
+}
+
+/*
+ * SUM, MIN, MAX and AVG over numbers
+ */
+
+/** Adds count inputs, whose sum, minimum or maximum is value, to a state. */
+template <AggregationType Agg, typename A>
+void Accumulate(AggregateState *state, A value, int64_t count) {
+  A &acc = AccumulatorOf<A>(state);
+  if constexpr (Agg == AggregationType::SumAggregate || Agg == AggregationType::AvgAggregate) {
+    if constexpr (std::is_same_v<A, double>) {
+      acc += value;
+    } else if (__builtin_add_overflow(acc, value, &acc)) {
+      ThrowOutOfRange();
+    }
+  } else if constexpr (Agg == AggregationType::MinAggregate) {
+    if (state->count_ == 0 || value < acc) {
+      acc = value;
+    }
+  } else {
+    static_assert(Agg == AggregationType::MaxAggregate, "Only SUM, MIN, MAX and AVG accumulate numbers.");
+    if (state->count_ == 0 || value > acc) {
+      acc = value;
+    }
+  }
+  state->count_ += count;
+}
+
+template <AggregationType Agg, typename T>
+void UpdateNumber(AggregateState *state, AggregateStorage * /*storage*/, const Value &input) {
+  if (input.IsNull()) {
+    return;
+  }
+  BUSTUB_ASSERT(input.GetTypeId() == TypeIdOf<T>(), "The input has the type that the kernel was made for.");
+  Accumulate<Agg, Accumulator<T>>(state, static_cast<Accumulator<T>>(input.GetAs<T>()), 1);
+}
+
+template <AggregationType Agg, typename T>
+void MergeNumber(AggregateState *state, AggregateStorage * /*storage*/, const AggregateState &partial,
+                 const AggregateStorage & /*partial_storage*/) {
+  if (partial.count_ > 0) {
+    Accumulate<Agg, Accumulator<T>>(state, AccumulatorOf<Accumulator<T>>(partial), partial.count_);
+  }
+}
+
+template <AggregationType Agg, typename T>
+Value FinalizeNumber(const AggregateState &state, const AggregateStorage & /*storage*/) {
+  using A = Accumulator<T>;
+  if constexpr (Agg == AggregationType::AvgAggregate) {
+    if (state.count_ == 0) {
+      return ValueFactory::GetNullValueByType(TypeId::DECIMAL);
+    }
+    return ValueFactory::GetDecimalValue(static_cast<double>(AccumulatorOf<A>(state)) / state.count_);
+  } else {
+    if (state.count_ == 0) {
+      return ValueFactory::GetNullValueByType(TypeIdOf<T>());
+    }
+    A acc = AccumulatorOf<A>(state);
+    if constexpr (std::is_integral_v<T>) {
+      // the smallest value of T stands for NULL
+      if (acc <= std::numeric_limits<T>::min() || acc > std::numeric_limits<T>::max()) {
+        ThrowOutOfRange();
+      }
+    }
+    return Value(TypeIdOf<T>(), static_cast<T>(acc));
+  }
+}
+
+template <AggregationType Agg, typename T>
+AggregateKernel NumberKernel() {
+  return {Init, UpdateNumber<Agg, T>, UpdateBatch<UpdateNumber<Agg, T>>, MergeNumber<Agg, T>, FinalizeNumber<Agg, T>};
+}
+
+/*
+ * MIN and MAX over other types
+ */
+
+template <AggregationType Agg>
+void AccumulateValue(AggregateState *state, AggregateStorage *storage, const Value &value, int64_t count) {
+  if (state->count_ == 0) {
+    state->slot_ = static_cast<uint32_t>(storage->values_.size());
+    storage->values_.push_back(value);
+  } else {
+    Value &acc = storage->values_[state->slot_];
+    CmpBool better = Agg == AggregationType::MinAggregate ? value.CompareLessThan(acc) : value.CompareGreaterThan(acc);
+    if (better == CmpBool::CmpTrue) {
+      acc = value;
+    }
+  }
+  state->count_ += count;
+}
+
+template <AggregationType Agg>
+void UpdateValue(AggregateState *state, AggregateStorage *storage, const Value &input) {
+  if (!input.IsNull()) {
+    AccumulateValue<Agg>(state, storage, input, 1);
+  }
+}
+
+template <AggregationType Agg>
+void MergeValue(AggregateState *state, AggregateStorage *storage, const AggregateState &partial,
+                const AggregateStorage &partial_storage) {
+  if (partial.count_ > 0) {
+    AccumulateValue<Agg>(state, storage, partial_storage.values_[partial.slot_], partial.count_);
+  }
+}
+
+template <TypeId Type>
+Value FinalizeValue(const AggregateState &state, const AggregateStorage &storage) {
+  if (state.count_ == 0) {
+    return ValueFactory::GetNullValueByType(Type);
+  }
+  return storage.values_[state.slot_];
+}
+
+template <AggregationType Agg, TypeId Type>
+AggregateKernel ValueKernel() {
+  return {Init, UpdateValue<Agg>, UpdateBatch<UpdateValue<Agg>>, MergeValue<Agg>, FinalizeValue<Type>};
+}
+
+/** @return the kernel of SUM, MIN, MAX or AVG over the input type */
+template <AggregationType Agg>
+AggregateKernel MakeNumberKernel(TypeId input_type) {
+  switch (input_type) {
+    case TypeId::TINYINT:
+      return NumberKernel<Agg, int8_t>();
+    case TypeId::SMALLINT:
+      return NumberKernel<Agg, int16_t>();
+    case TypeId::INTEGER:
+      return NumberKernel<Agg, int32_t>();
+    case TypeId::BIGINT:
+      return NumberKernel<Agg, int64_t>();
+    case TypeId::DECIMAL:
+      return NumberKernel<Agg, double>();
+    default:
+      break;
+  }
+  if constexpr (Agg == AggregationType::MinAggregate || Agg == AggregationType::MaxAggregate) {
+    switch (input_type) {
+      case TypeId::BOOLEAN:
+        return ValueKernel<Agg, TypeId::BOOLEAN>();
+      case TypeId::TIMESTAMP:
+        return ValueKernel<Agg, TypeId::TIMESTAMP>();
+      case TypeId::VARCHAR:
+        return ValueKernel<Agg, TypeId::VARCHAR>();
+      default:
+        break;
+    }
+  }
+  throw Exception(ExceptionType::MISMATCH_TYPE, "The aggregate is not defined on the type of its input.");
+}
+
+/*
+ * APPROX_COUNT_DISTINCT
+ */
+
+void InitSketch(AggregateState *state, AggregateStorage *storage) {
+  *state = AggregateState();
+  state->slot_ = static_cast<uint32_t>(storage->sketches_.size());
+  storage->sketches_.emplace_back();
+}
+
+void UpdateSketch(AggregateState *state, AggregateStorage *storage, const Value &input) {
+  if (!input.IsNull()) {
+    storage->sketches_[state->slot_].Add(HashUtil::HashValue(&input));
+    state->count_++;
+  }
+}
+
+void MergeSketch(AggregateState *state, AggregateStorage *storage, const AggregateState &partial,
+                 const AggregateStorage &partial_storage) {
+  storage->sketches_[state->slot_].Merge(partial_storage.sketches_[partial.slot_]);
+  state->count_ += partial.count_;
+}
+
+Value FinalizeSketch(const AggregateState &state, const AggregateStorage &storage) {
+  uint64_t estimate = storage.sketches_[state.slot_].Estimate();
+  if (estimate > BUSTUB_INT32_MAX) {
+    ThrowOutOfRange();
+  }
+  return ValueFactory::GetIntegerValue(static_cast<int32_t>(estimate));
+}
+
+}  // namespace
+
+AggregateKernel AggregateKernel::Make(AggregationType agg_type, TypeId input_type) {
+  switch (agg_type) {
+    case AggregationType::CountAggregate:
+      return {Init, UpdateCount, UpdateBatch<UpdateCount>, MergeCount, FinalizeCount};
+    case AggregationType::SumAggregate:
+      return MakeNumberKernel<AggregationType::SumAggregate>(input_type);
+    case AggregationType::MinAggregate:
+      return MakeNumberKernel<AggregationType::MinAggregate>(input_type);
+    case AggregationType::MaxAggregate:
+      return MakeNumberKernel<AggregationType::MaxAggregate>(input_type);
+    case AggregationType::AvgAggregate:
+      return MakeNumberKernel<AggregationType::AvgAggregate>(input_type);
+    case AggregationType::ApproxCountDistinctAggregate:
+      return {InitSketch, UpdateSketch, UpdateBatch<UpdateSketch>, MergeSketch, FinalizeSketch};
+  }
+  UNREACHABLE("Unknown aggregation type.");
+}
+
+}  // namespace bustub
@@ -1,29 +1,488 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-19, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
-
-void AggregationExecutor::Init() {}
-
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <atomic>
+#include <future>  // NOLINT
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+namespace {
+
+/** Runs task(0) to task(num_threads - 1) on threads of their own, and rethrows the first exception of one of them. */
+template <typename Task>
+void RunInParallel(size_t num_threads, const Task &task) {
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    futures.push_back(std::async(std::launch::async, task, i));
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+}
+
+/** Reads an integer value, @return false if the value is not an integer */
+bool AsInteger(const Value &value, int64_t *integer) {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      *integer = value.GetAs<int8_t>();
+      return true;
+    case TypeId::SMALLINT:
+      *integer = value.GetAs<int16_t>();
+      return true;
+    case TypeId::INTEGER:
+      *integer = value.GetAs<int32_t>();
+      return true;
+    case TypeId::BIGINT:
+      *integer = value.GetAs<int64_t>();
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** @return an integer as a value of an integer type that it fits in */
+Value IntegerValue(TypeId type, int64_t integer) {
+  switch (type) {
+    case TypeId::TINYINT:
+      return Value(type, static_cast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return Value(type, static_cast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return Value(type, static_cast<int32_t>(integer));
+    default:
+      return Value(type, integer);
+  }
+}
+
+}  // namespace
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
+      aht_iterator_(aht_.Begin()) {}
+
+const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
+
+void AggregationExecutor::Init() {
+  child_->Init();
+  aht_.Clear();
+  aggregated_ = false;
+  partitions_.clear();
+  partition_idx_ = 0;
+  skipped_pre_aggregation_ = false;
+
+  std::vector<Column> spill_columns;
+  auto add_spill_column = [&](const AbstractExpression *expr) {
+    std::string name = "spill_" + std::to_string(spill_columns.size());
+    if (expr->GetReturnType() == TypeId::VARCHAR) {
+      // a spilled row has to fit in a page
+      spill_columns.emplace_back(name, TypeId::VARCHAR, static_cast<uint32_t>(PAGE_SIZE));
+    } else {
+      spill_columns.emplace_back(name, expr->GetReturnType());
+    }
+  };
+  for (const auto *expr : plan_->GetGroupBys()) {
+    add_spill_column(expr);
+  }
+  for (const auto *expr : plan_->GetAggregates()) {
+    add_spill_column(expr);
+  }
+  spill_schema_ = std::make_unique<Schema>(spill_columns);
+  num_bytes_ = 0;
+  level_ = 0;
+  spill_runs_.clear();
+  spilled_partitions_.clear();
+  spill_stats_ = SpillStats{};
+  InitDense();
+}
+
+void AggregationExecutor::InitDense() {
+  dense_states_.clear();
+  dense_storage_.Clear();
+  dense_seen_.clear();
+  dense_pos_ = 0;
+  if (plan_->GetGroupBys().size() != 1 || IsParallel()) {
+    return;
+  }
+  auto *group_by = dynamic_cast<const ColumnValueExpression *>(plan_->GetGroupByAt(0));
+  auto *scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan_->GetChildPlan());
+  if (group_by == nullptr || scan_plan == nullptr) {
+    return;
+  }
+  // the group by reads an output column of the scan, which has to read a column of the table as it is
+  auto *column = dynamic_cast<const ColumnValueExpression *>(
+      scan_plan->OutputSchema()->GetColumn(group_by->GetColIdx()).GetExpr());
+  if (column == nullptr) {
+    return;
+  }
+  const TableStats *stats = GetExecutorContext()->GetCatalog()->GetTable(scan_plan->GetTableOid())->stats_.get();
+  if (stats == nullptr || !stats->columns_[column->GetColIdx()].has_range_) {
+    return;
+  }
+  const ColumnStats &column_stats = stats->columns_[column->GetColIdx()];
+  uint64_t range = static_cast<uint64_t>(column_stats.max_) - static_cast<uint64_t>(column_stats.min_);
+  if (range >= MAX_DENSE_GROUPS) {
+    return;
+  }
+
+  dense_type_ = group_by->GetReturnType();
+  dense_min_ = column_stats.min_;
+  const auto &kernels = aht_.GetKernels();
+  for (const auto &kernel : kernels) {
+    dense_states_.emplace_back(range + 1);
+    for (auto &state : dense_states_.back()) {
+      kernel.init_(&state, &dense_storage_);
+    }
+  }
+  dense_seen_.assign(range + 1, 0);
+  dense_key_ = AggregateKey{std::vector<Value>(1)};
+}
+
+bool AggregationExecutor::DenseSlot(const Value &key, uint32_t *slot) const {
+  int64_t integer;
+  if (dense_seen_.empty() || key.IsNull() || !AsInteger(key, &integer) || integer < dense_min_) {
+    return false;
+  }
+  uint64_t offset = static_cast<uint64_t>(integer) - static_cast<uint64_t>(dense_min_);
+  if (offset >= dense_seen_.size()) {
+    return false;
+  }
+  *slot = static_cast<uint32_t>(offset);
+  return true;
+}
+
+bool AggregationExecutor::IsParallel() const {
+  auto *scan = dynamic_cast<const SeqScanExecutor *>(child_.get());
+  return scan != nullptr && scan->IsParallel();
+}
+
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!aggregated_) {
+    Tuple child_tuple;
+    RID child_rid;
+    if (IsParallel()) {
+      AggregateParallel();
+    } else {
+      const auto &kernels = aht_.GetKernels();
+      while (child_->Next(&child_tuple, &child_rid)) {
+        AggregateKey key = MakeKey(&child_tuple);
+        AggregateValue val = MakeVal(&child_tuple);
+        uint32_t slot;
+        if (!IsDense() || !DenseSlot(key.group_bys_[0], &slot)) {
+          AddRow(key, val);
+          continue;
+        }
+        dense_seen_[slot] = 1;
+        for (size_t i = 0; i < kernels.size(); i++) {
+          kernels[i].update_(&dense_states_[i][slot], &dense_storage_, val.aggregates_[i]);
+        }
+      }
+      FinishSpilling();
+    }
+    aht_iterator_ = aht_.Begin();
+    aggregated_ = true;
+  }
+
+  const AggregateKey *key;
+  const AggregateValue *val;
+  if (!NextGroup(&key, &val)) {
+    return false;
+  }
+  const Schema *output_schema = GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(output_schema->GetColumnCount());
+  for (const auto &column : output_schema->GetColumns()) {
+    values.push_back(column.GetExpr()->EvaluateAggregate(key->group_bys_, val->aggregates_));
+  }
+  *tuple = Tuple(values, output_schema);
+  *rid = RID();
+  return true;
+}
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  if (!aggregated_) {
+    if (IsParallel()) {
+      AggregateParallel();
+    } else {
+      const auto &group_bys = plan_->GetGroupBys();
+      const auto &aggregates = plan_->GetAggregates();
+      std::vector<std::vector<Value>> group_by_columns(group_bys.size());
+      std::vector<std::vector<Value>> aggregate_columns(aggregates.size());
+      TupleBatch child_batch;
+      AggregateKey key{std::vector<Value>(group_bys.size())};
+      AggregateValue val{std::vector<Value>(aggregates.size())};
+      const auto &kernels = aht_.GetKernels();
+      std::vector<uint32_t> dense_rows;
+      std::vector<uint32_t> dense_slots;
+      while (child_->NextBatch(&child_batch)) {
+        for (size_t i = 0; i < group_bys.size(); i++) {
+          group_bys[i]->EvaluateBatch(child_batch, &group_by_columns[i]);
+        }
+        for (size_t i = 0; i < aggregates.size(); i++) {
+          aggregates[i]->EvaluateBatch(child_batch, &aggregate_columns[i]);
+        }
+        dense_rows.clear();
+        dense_slots.clear();
+        for (uint32_t row : child_batch.GetSelection()) {
+          uint32_t slot;
+          if (IsDense() && DenseSlot(group_by_columns[0][row], &slot)) {
+            dense_rows.push_back(row);
+            dense_slots.push_back(slot);
+            dense_seen_[slot] = 1;
+            continue;
+          }
+          for (size_t i = 0; i < group_bys.size(); i++) {
+            key.group_bys_[i] = group_by_columns[i][row];
+          }
+          for (size_t i = 0; i < aggregates.size(); i++) {
+            val.aggregates_[i] = aggregate_columns[i][row];
+          }
+          AddRow(key, val);
+        }
+        // one aggregate at a time over the rows of the dense groups
+        for (size_t i = 0; i < kernels.size() && !dense_rows.empty(); i++) {
+          kernels[i].update_batch_(dense_states_[i].data(), dense_slots.data(), aggregate_columns[i], dense_rows,
+                                   &dense_storage_);
+        }
+      }
+      FinishSpilling();
+    }
+    aht_iterator_ = aht_.Begin();
+    aggregated_ = true;
+  }
+
+  const Schema *output_schema = GetOutputSchema();
+  batch->Reset(output_schema->GetColumnCount());
+  const AggregateKey *key;
+  const AggregateValue *val;
+  while (!batch->IsFull() && NextGroup(&key, &val)) {
+    uint32_t row = batch->AppendRow();
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      const AbstractExpression *expr = output_schema->GetColumn(i).GetExpr();
+      batch->SetValue(row, i, expr->EvaluateAggregate(key->group_bys_, val->aggregates_));
+    }
+  }
+  return batch->GetNumSelected() > 0;
+}
+
+void AggregationExecutor::AggregateParallel() {
+  auto *scan = dynamic_cast<SeqScanExecutor *>(child_.get());
+  size_t num_threads = GetExecutorContext()->GetNumThreads();
+  std::vector<LocalAggregation> locals(num_threads);
+  RunInParallel(num_threads, [&](size_t i) { PreAggregate(scan, &locals[i]); });
+
+  for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+    partitions_.emplace_back(plan_->GetAggregates(), plan_->GetAggregateTypes());
+  }
+  std::atomic<size_t> next_partition{0};
+  RunInParallel(std::min(num_threads, NUM_PARTITIONS), [&](size_t) {
+    for (size_t partition = next_partition++; partition < NUM_PARTITIONS; partition = next_partition++) {
+      MergePartition(partition, &locals);
+    }
+  });
+  for (const auto &local : locals) {
+    skipped_pre_aggregation_ = skipped_pre_aggregation_ || !local.pre_aggregate_;
+  }
+}
+
+void AggregationExecutor::PreAggregate(SeqScanExecutor *scan, LocalAggregation *local) {
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+    local->tables_.emplace_back(aggregates, plan_->GetAggregateTypes());
+  }
+  local->rows_.resize(NUM_PARTITIONS);
+
+  std::vector<std::vector<Value>> group_by_columns(group_bys.size());
+  std::vector<std::vector<Value>> aggregate_columns(aggregates.size());
+  SeqScanExecutor::ScanWorker worker;
+  TupleBatch batch;
+  AggregateKey key{std::vector<Value>(group_bys.size())};
+  AggregateValue val{std::vector<Value>(aggregates.size())};
+  size_t num_rows = 0;
+  bool sampled = false;
+  while (scan->NextParallelBatch(&worker, &batch)) {
+    for (size_t i = 0; i < group_bys.size(); i++) {
+      group_bys[i]->EvaluateBatch(batch, &group_by_columns[i]);
+    }
+    for (size_t i = 0; i < aggregates.size(); i++) {
+      aggregates[i]->EvaluateBatch(batch, &aggregate_columns[i]);
+    }
+    for (uint32_t row : batch.GetSelection()) {
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        key.group_bys_[i] = group_by_columns[i][row];
+      }
+      for (size_t i = 0; i < aggregates.size(); i++) {
+        val.aggregates_[i] = aggregate_columns[i][row];
+      }
+      size_t partition = std::hash<AggregateKey>()(key) % NUM_PARTITIONS;
+      if (local->pre_aggregate_) {
+        local->tables_[partition].InsertCombine(key, val);
+      } else {
+        local->rows_[partition].emplace_back(key, val);
+      }
+    }
+
+    num_rows += batch.GetNumSelected();
+    if (!sampled && num_rows >= PREAGGREGATION_SAMPLE_ROWS) {
+      sampled = true;
+      size_t num_groups = 0;
+      for (const auto &table : local->tables_) {
+        num_groups += table.Size();
+      }
+      // unless the rows at least halve, the merge would insert them all over again
+      local->pre_aggregate_ = 2 * num_groups <= num_rows;
+    }
+  }
+}
+
+void AggregationExecutor::MergePartition(size_t partition, std::vector<LocalAggregation> *locals) {
+  SimpleAggregationHashTable &table = partitions_[partition];
+  for (auto &local : *locals) {
+    SimpleAggregationHashTable &partial = local.tables_[partition];
+    // the aggregates merge in any order, so the smaller table is merged into the larger one
+    if (table.Size() < partial.Size()) {
+      table.Swap(&partial);
+    }
+    table.Merge(&partial);
+    for (const auto &[key, val] : local.rows_[partition]) {
+      table.InsertCombine(key, val);
+    }
+    local.rows_[partition].clear();
+  }
+}
+
+void AggregationExecutor::AddRow(const AggregateKey &key, const AggregateValue &val) {
+  if (!spill_runs_.empty()) {
+    // the groups in memory keep aggregating their rows, and only the rows of new groups are spilled
+    if (aht_.Combine(key, val)) {
+      return;
+    }
+    std::vector<Value> values(key.group_bys_);
+    values.insert(values.end(), val.aggregates_.begin(), val.aggregates_.end());
+    // mixing in the level makes each level split the rows of a partition independently of the levels above it
+    hash_t hash = HashUtil::CombineHashes(std::hash<AggregateKey>()(key), level_ + 1);
+    spill_runs_[hash % NUM_SPILL_PARTITIONS]->Append(Tuple(values, spill_schema_.get()));
+    return;
+  }
+
+  size_t num_groups = aht_.Size();
+  aht_.InsertCombine(key, val);
+  if (aht_.Size() == num_groups) {
+    return;
+  }
+  num_bytes_ += aht_.GroupBytes(key);
+  if (num_bytes_ > GetExecutorContext()->GetMemoryBudget()) {
+    BufferPoolManager *bpm = GetExecutorContext()->GetBufferPoolManager();
+    for (size_t i = 0; i < NUM_SPILL_PARTITIONS; i++) {
+      spill_runs_.push_back(std::make_unique<TmpTupleRun>(bpm));
+    }
+    if (level_ > 0) {
+      spill_stats_.num_repartitions_++;
+    }
+  }
+}
+
+void AggregationExecutor::FinishSpilling() {
+  for (auto &run : spill_runs_) {
+    run->Finish();
+    spill_stats_.num_runs_++;
+    spill_stats_.num_tuples_ += run->GetNumTuples();
+    spill_stats_.num_pages_ += run->GetNumPages();
+    spill_stats_.max_level_ = std::max(spill_stats_.max_level_, level_ + 1);
+    if (run->GetNumTuples() > 0) {
+      spilled_partitions_.push_back(SpilledPartition{std::move(run), level_ + 1});
+    }
+  }
+  spill_runs_.clear();
+}
+
+bool AggregationExecutor::NextSpilledPartition() {
+  if (spilled_partitions_.empty()) {
+    return false;
+  }
+  SpilledPartition partition = std::move(spilled_partitions_.back());
+  spilled_partitions_.pop_back();
+  aht_.Clear();
+  num_bytes_ = 0;
+  level_ = partition.level_;
+
+  size_t num_group_bys = plan_->GetGroupBys().size();
+  AggregateKey key{std::vector<Value>(num_group_bys)};
+  AggregateValue val{std::vector<Value>(plan_->GetAggregates().size())};
+  TmpTupleRun::Reader reader(partition.run_.get());
+  Tuple tuple;
+  while (reader.Next(&tuple)) {
+    for (size_t i = 0; i < key.group_bys_.size(); i++) {
+      key.group_bys_[i] = tuple.GetValue(spill_schema_.get(), i);
+    }
+    for (size_t i = 0; i < val.aggregates_.size(); i++) {
+      val.aggregates_[i] = tuple.GetValue(spill_schema_.get(), num_group_bys + i);
+    }
+    AddRow(key, val);
+  }
+  FinishSpilling();
+  aht_iterator_ = aht_.Begin();
+  return true;
+}
+
+bool AggregationExecutor::NextGroup(const AggregateKey **key, const AggregateValue **val) {
+  const AbstractExpression *having = plan_->GetHaving();
+  while (dense_pos_ < dense_seen_.size()) {
+    size_t slot = dense_pos_++;
+    if (dense_seen_[slot] == 0) {
+      continue;
+    }
+    dense_key_.group_bys_[0] = IntegerValue(dense_type_, dense_min_ + static_cast<int64_t>(slot));
+    group_val_.aggregates_.clear();
+    for (size_t i = 0; i < dense_states_.size(); i++) {
+      group_val_.aggregates_.push_back(aht_.GetKernels()[i].finalize_(dense_states_[i][slot], dense_storage_));
+    }
+    *key = &dense_key_;
+    *val = &group_val_;
+    if (having == nullptr || having->EvaluateAggregate((*key)->group_bys_, (*val)->aggregates_).GetAs<bool>()) {
+      return true;
+    }
+  }
+  while (true) {
+    while (aht_iterator_ != aht_.End()) {
+      *key = &aht_iterator_.Key();
+      group_val_ = aht_iterator_.Val();
+      *val = &group_val_;
+      ++aht_iterator_;
+      if (having == nullptr || having->EvaluateAggregate((*key)->group_bys_, (*val)->aggregates_).GetAs<bool>()) {
+        return true;
+      }
+    }
+    if (partition_idx_ < partitions_.size()) {
+      aht_.Clear();
+      aht_.Swap(&partitions_[partition_idx_++]);
+      aht_iterator_ = aht_.Begin();
+    } else if (!NextSpilledPartition()) {
+      return false;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_exchange.cpp
+//
+// Identification: src/execution/batch_exchange.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/batch_exchange.h"
+
+#include <utility>
+
+namespace bustub {
+
+bool BatchExchange::Push(TupleBatch &&batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  not_full_.wait(lock, [&] { return closed_ || batches_.size() < capacity_; });
+  if (closed_) {
+    return false;
+  }
+  batches_.push_back(std::move(batch));
+  not_empty_.notify_one();
+  return true;
+}
+
+void BatchExchange::ProducerDone(std::exception_ptr error) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (error != nullptr && error_ == nullptr) {
+    error_ = error;
+  }
+  num_producers_--;
+  not_empty_.notify_all();
+}
+
+bool BatchExchange::Pop(TupleBatch *batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  not_empty_.wait(lock, [&] { return error_ != nullptr || !batches_.empty() || num_producers_ == 0; });
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  if (batches_.empty()) {
+    return false;
+  }
+  *batch = std::move(batches_.front());
+  batches_.pop_front();
+  not_full_.notify_one();
+  return true;
+}
+
+void BatchExchange::Close() {
+  std::lock_guard<std::mutex> lock(latch_);
+  closed_ = true;
+  batches_.clear();
+  not_full_.notify_all();
+}
+
+}  // namespace bustub
@@ -0,0 +1,312 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/hash_join_executor.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+void HashJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  built_ = false;
+  build_tuples_.clear();
+  build_keys_.clear();
+  buffered_probe_tuples_.clear();
+  buffered_probe_pos_ = 0;
+  matches_.clear();
+  match_pos_ = 0;
+  spilled_ = false;
+  build_reader_.reset();
+  probe_reader_.reset();
+  partitions_.clear();
+  partition_ = Partition{};
+  spill_stats_ = SpillStats{};
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!built_) {
+    Build();
+    built_ = true;
+  }
+
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  const Schema *output_schema = GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  while (true) {
+    while (match_pos_ < matches_.size()) {
+      const Tuple &build_tuple = build_tuples_[matches_[match_pos_++]];
+      const Tuple &left_tuple = build_left_ ? build_tuple : probe_tuple_;
+      const Tuple &right_tuple = build_left_ ? probe_tuple_ : build_tuple;
+      if (predicate != nullptr &&
+          !predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+        continue;
+      }
+      std::vector<Value> values;
+      values.reserve(output_schema->GetColumnCount());
+      for (const auto &column : output_schema->GetColumns()) {
+        values.push_back(column.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema));
+      }
+      *tuple = Tuple(values, output_schema);
+      *rid = RID();
+      return true;
+    }
+    if (!NextProbeTuple() && !(spilled_ && NextChunk())) {
+      return false;
+    }
+  }
+}
+
+void HashJoinExecutor::Build() {
+  std::vector<Tuple> left_tuples;
+  std::vector<Tuple> right_tuples;
+  size_t memory_budget = GetExecutorContext()->GetMemoryBudget();
+  size_t num_bytes = 0;
+  Tuple tuple;
+  RID rid;
+  while (true) {
+    if (!left_executor_->Next(&tuple, &rid)) {
+      build_left_ = true;
+      break;
+    }
+    num_bytes += sizeof(Tuple) + tuple.GetLength();
+    left_tuples.push_back(tuple);
+    if (!right_executor_->Next(&tuple, &rid)) {
+      build_left_ = false;
+      break;
+    }
+    num_bytes += sizeof(Tuple) + tuple.GetLength();
+    right_tuples.push_back(tuple);
+    if (num_bytes > memory_budget) {
+      Spill(&left_tuples, &right_tuples);
+      return;
+    }
+  }
+  buffered_probe_tuples_ = std::move(build_left_ ? right_tuples : left_tuples);
+  BuildTable(build_left_ ? &left_tuples : &right_tuples);
+}
+
+void HashJoinExecutor::BuildTable(std::vector<Tuple> *tuples) {
+  build_tuples_.clear();
+  build_keys_.clear();
+  // tuples with a NULL key can never match, so they are not kept
+  size_t num_keys = plan_->GetLeftKeys().size();
+  std::vector<hash_t> hashes;
+  std::vector<Value> key;
+  for (auto &build_tuple : *tuples) {
+    hash_t hash;
+    if (MakeKey(build_tuple, build_left_, &key, &hash)) {
+      build_keys_.insert(build_keys_.end(), key.begin(), key.end());
+      build_tuples_.push_back(std::move(build_tuple));
+      hashes.push_back(hash);
+    }
+  }
+  table_.Reset(build_tuples_.size());
+  for (uint32_t row = 0; row < build_tuples_.size(); row++) {
+    table_.Insert(hashes[row], row);
+  }
+  BUSTUB_ASSERT(build_keys_.size() == num_keys * build_tuples_.size(), "Every build tuple has all of its keys.");
+}
+
+bool HashJoinExecutor::MakeKey(const Tuple &tuple, bool left, std::vector<Value> *key, hash_t *hash) {
+  const auto &key_exprs = left ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  const Schema *schema = left ? left_executor_->GetOutputSchema() : right_executor_->GetOutputSchema();
+  key->clear();
+  *hash = 0;
+  for (const auto *expr : key_exprs) {
+    key->push_back(expr->Evaluate(&tuple, schema));
+    if (key->back().IsNull()) {
+      return false;
+    }
+    *hash = HashUtil::CombineHashes(*hash, HashUtil::HashValue(&key->back()));
+  }
+  return true;
+}
+
+bool HashJoinExecutor::NextProbeTuple() {
+  matches_.clear();
+  match_pos_ = 0;
+  if (spilled_) {
+    if (probe_reader_ == nullptr || !probe_reader_->Next(&probe_tuple_)) {
+      return false;
+    }
+  } else if (buffered_probe_pos_ < buffered_probe_tuples_.size()) {
+    probe_tuple_ = buffered_probe_tuples_[buffered_probe_pos_++];
+  } else {
+    RID rid;
+    AbstractExecutor *probe_executor = build_left_ ? right_executor_.get() : left_executor_.get();
+    if (!probe_executor->Next(&probe_tuple_, &rid)) {
+      return false;
+    }
+  }
+
+  hash_t hash;
+  if (!MakeKey(probe_tuple_, !build_left_, &probe_key_, &hash)) {
+    return true;
+  }
+  table_.Find(hash, &matches_);
+  // drop the rows whose keys only share a tag with the probe key
+  size_t num_keys = probe_key_.size();
+  size_t num_matches = 0;
+  for (uint32_t row : matches_) {
+    bool equal = true;
+    for (size_t i = 0; i < num_keys && equal; i++) {
+      equal = build_keys_[row * num_keys + i].CompareEquals(probe_key_[i]) == CmpBool::CmpTrue;
+    }
+    if (equal) {
+      matches_[num_matches++] = row;
+    }
+  }
+  matches_.resize(num_matches);
+  return true;
+}
+
+std::vector<HashJoinExecutor::Partition> HashJoinExecutor::MakePartitions(size_t level) {
+  BufferPoolManager *bpm = GetExecutorContext()->GetBufferPoolManager();
+  std::vector<Partition> partitions(NUM_PARTITIONS);
+  for (auto &partition : partitions) {
+    partition.left_ = std::make_unique<TmpTupleRun>(bpm);
+    partition.right_ = std::make_unique<TmpTupleRun>(bpm);
+    partition.level_ = level;
+  }
+  return partitions;
+}
+
+void HashJoinExecutor::AddToPartition(const Tuple &tuple, bool left, std::vector<Partition> *partitions) {
+  std::vector<Value> key;
+  hash_t hash;
+  if (!MakeKey(tuple, left, &key, &hash)) {
+    return;
+  }
+  // mixing in the level makes each level split the tuples of a partition independently of the levels above it
+  Partition &partition = (*partitions)[HashUtil::CombineHashes(hash, partitions->front().level_) % NUM_PARTITIONS];
+  (left ? partition.left_ : partition.right_)->Append(tuple);
+}
+
+void HashJoinExecutor::QueuePartitions(std::vector<Partition> *partitions) {
+  for (auto &partition : *partitions) {
+    partition.left_->Finish();
+    partition.right_->Finish();
+    spill_stats_.num_runs_ += 2;
+    spill_stats_.num_tuples_ += partition.left_->GetNumTuples() + partition.right_->GetNumTuples();
+    spill_stats_.num_pages_ += partition.left_->GetNumPages() + partition.right_->GetNumPages();
+    spill_stats_.max_level_ = std::max(spill_stats_.max_level_, partition.level_);
+    // an inner join of an empty partition has no output
+    if (partition.left_->GetNumTuples() > 0 && partition.right_->GetNumTuples() > 0) {
+      partitions_.push_back(std::move(partition));
+    }
+  }
+}
+
+void HashJoinExecutor::Spill(std::vector<Tuple> *left_tuples, std::vector<Tuple> *right_tuples) {
+  std::vector<Partition> partitions = MakePartitions(1);
+  Tuple tuple;
+  RID rid;
+  for (const auto &left_tuple : *left_tuples) {
+    AddToPartition(left_tuple, true, &partitions);
+  }
+  left_tuples->clear();
+  while (left_executor_->Next(&tuple, &rid)) {
+    AddToPartition(tuple, true, &partitions);
+  }
+  // only one side at a time keeps a page of each partition pinned
+  for (auto &partition : partitions) {
+    partition.left_->Finish();
+  }
+  for (const auto &right_tuple : *right_tuples) {
+    AddToPartition(right_tuple, false, &partitions);
+  }
+  right_tuples->clear();
+  while (right_executor_->Next(&tuple, &rid)) {
+    AddToPartition(tuple, false, &partitions);
+  }
+  QueuePartitions(&partitions);
+  spilled_ = true;
+}
+
+void HashJoinExecutor::Repartition() {
+  std::vector<Partition> partitions = MakePartitions(partition_.level_ + 1);
+  Tuple tuple;
+  for (bool left : {true, false}) {
+    TmpTupleRun::Reader reader(left ? partition_.left_.get() : partition_.right_.get());
+    while (reader.Next(&tuple)) {
+      AddToPartition(tuple, left, &partitions);
+    }
+    for (auto &partition : partitions) {
+      (left ? partition.left_ : partition.right_)->Finish();
+    }
+  }
+  for (auto &partition : partitions) {
+    // all the tuples share one hash, so partitioning them again is of no use
+    if (partition.left_->GetNumTuples() == partition_.left_->GetNumTuples() &&
+        partition.right_->GetNumTuples() == partition_.right_->GetNumTuples()) {
+      partition.level_ = MAX_PARTITION_LEVEL;
+    }
+  }
+  spill_stats_.num_repartitions_++;
+  partition_ = Partition{};
+  QueuePartitions(&partitions);
+}
+
+bool HashJoinExecutor::NextChunk() {
+  size_t memory_budget = GetExecutorContext()->GetMemoryBudget();
+  while (true) {
+    if (build_reader_ != nullptr) {
+      std::vector<Tuple> tuples;
+      size_t num_bytes = 0;
+      Tuple tuple;
+      while (num_bytes <= memory_budget && build_reader_->Next(&tuple)) {
+        num_bytes += sizeof(Tuple) + tuple.GetLength();
+        tuples.push_back(tuple);
+      }
+      if (!tuples.empty()) {
+        BuildTable(&tuples);
+        probe_reader_ = std::make_unique<TmpTupleRun::Reader>(build_left_ ? partition_.right_.get()
+                                                                          : partition_.left_.get());
+        return true;
+      }
+    }
+
+    // the current partition is done
+    probe_reader_.reset();
+    build_reader_.reset();
+    if (partitions_.empty()) {
+      partition_ = Partition{};
+      return false;
+    }
+    partition_ = std::move(partitions_.back());
+    partitions_.pop_back();
+    build_left_ = partition_.left_->GetNumBytes() <= partition_.right_->GetNumBytes();
+    const TmpTupleRun *build_run = build_left_ ? partition_.left_.get() : partition_.right_.get();
+    // a spilled tuple takes its size prefix on disk, and a Tuple object in memory
+    size_t build_bytes = build_run->GetNumBytes() + build_run->GetNumTuples() * (sizeof(Tuple) - sizeof(uint32_t));
+    if (build_bytes > memory_budget && partition_.level_ < MAX_PARTITION_LEVEL) {
+      Repartition();
+      continue;
+    }
+    build_reader_ = std::make_unique<TmpTupleRun::Reader>(build_run);
+  }
+}
+
+}  // namespace bustub
@@ -11,12 +11,284 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/type.h"
+
 namespace bustub {
+
+namespace {
+
+/**
+ * Cursor over the entries of a B+ tree index with GenericKey<KeySize> keys that are in a KeyRange. Entries are copied
+ * out a leaf at a time with IndexIterator::NextBatch, which also stops the scan at the upper bound.
+ */
+template <size_t KeySize>
+class BPlusTreeIndexCursor : public IndexScanExecutor::IndexCursor {
+  using TreeIndex = BPlusTreeIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+
+ public:
+  BPlusTreeIndexCursor(TreeIndex *index, IndexScanExecutor::KeyRange range)
+      : iterator_(range.lower_.has_value() ? index->GetBeginIterator(BoundKey(index, *range.lower_, false))
+                                           : index->GetBeginIterator()),
+        comparator_(index->GetKeySchema()),
+        index_tuple_schema_(index->GetIndexTupleSchema()),
+        range_(std::move(range)) {
+    if (range_.upper_.has_value()) {
+      // NextBatch stops after the last key equal to the bound, so an exclusive bound ends just before the upper value
+      upper_key_ = BoundKey(index, *range_.upper_, range_.upper_inclusive_);
+    }
+  }
+
+  bool Next(RID *rid, Tuple *index_tuple) override {
+    while (pos_ == batch_.size()) {
+      // NextBatch empties the batch at the end, so calls after the end keep returning false
+      pos_ = 0;
+      if (iterator_.NextBatch(&batch_, comparator_, range_.upper_.has_value() ? &upper_key_ : nullptr, true) == 0) {
+        return false;
+      }
+      if (range_.upper_.has_value() && !range_.upper_inclusive_) {
+        // only the entries at the end of the last batch can have the excluded upper value
+        while (!batch_.empty() &&
+               batch_.back().first.ToValue(index_tuple_schema_, 0).CompareEquals(*range_.upper_) == CmpBool::CmpTrue) {
+          batch_.pop_back();
+        }
+      }
+    }
+    const auto &entry = batch_[pos_++];
+    *rid = entry.second;
+    if (index_tuple != nullptr) {
+      // the key holds the serialized index tuple, key columns first and included columns after them
+      std::vector<Value> values;
+      values.reserve(index_tuple_schema_->GetColumnCount());
+      for (uint32_t i = 0; i < index_tuple_schema_->GetColumnCount(); i++) {
+        values.push_back(entry.first.ToValue(index_tuple_schema_, i));
+      }
+      *index_tuple = Tuple(values, index_tuple_schema_);
+    }
+    return true;
+  }
+
+ private:
+  /**
+   * @return the smallest (or with largest set, the largest) key whose first column is first, i.e. with the smallest
+   * (largest) values in the other key columns
+   */
+  static GenericKey<KeySize> BoundKey(TreeIndex *index, const Value &first, bool largest) {
+    Schema *key_schema = index->GetKeySchema();
+    std::vector<Value> values{first};
+    for (uint32_t i = 1; i < key_schema->GetColumnCount(); i++) {
+      TypeId type = key_schema->GetColumn(i).GetType();
+      values.push_back(largest ? Type::GetMaxValue(type) : Type::GetMinValue(type));
+    }
+    GenericKey<KeySize> key;
+    key.SetFromKey(Tuple(values, key_schema));
+    return key;
+  }
+
+  IndexIterator<GenericKey<KeySize>, RID, GenericComparator<KeySize>> iterator_;
+  GenericComparator<KeySize> comparator_;
+  Schema *index_tuple_schema_;
+  IndexScanExecutor::KeyRange range_;
+  GenericKey<KeySize> upper_key_;
+  /** Entries of the current leaf, reused across leaves, and the next one to return. */
+  std::vector<std::pair<GenericKey<KeySize>, RID>> batch_;
+  size_t pos_{0};
+};
+
+template <size_t KeySize>
+std::unique_ptr<IndexScanExecutor::IndexCursor> MakeCursor(Index *index, IndexScanExecutor::KeyRange range) {
+  auto *tree_index = dynamic_cast<BPlusTreeIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>> *>(index);
+  if (tree_index == nullptr) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "Index scans are only supported on B+ tree indexes");
+  }
+  return std::make_unique<BPlusTreeIndexCursor<KeySize>>(tree_index, std::move(range));
+}
+
+/** @return the comparison with its operands swapped, e.g. LessThan for GreaterThan */
+ComparisonType Mirror(ComparisonType type) {
+  switch (type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return type;
+  }
+}
+
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  Catalog *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  Index *index = index_info_->index_.get();
+  KeyRange range = RangeOfPredicate();
+  switch (index_info_->key_size_) {
+    case 4:
+      cursor_ = MakeCursor<4>(index, std::move(range));
+      break;
+    case 8:
+      cursor_ = MakeCursor<8>(index, std::move(range));
+      break;
+    case 16:
+      cursor_ = MakeCursor<16>(index, std::move(range));
+      break;
+    case 32:
+      cursor_ = MakeCursor<32>(index, std::move(range));
+      break;
+    case 64:
+      cursor_ = MakeCursor<64>(index, std::move(range));
+      break;
+    default:
+      throw Exception(ExceptionType::NOT_IMPLEMENTED, "Unsupported index key size");
+  }
+  num_entries_read_ = 0;
+
+  // the scan can skip the table heap if everything it evaluates is stored in the index
+  remapped_exprs_.clear();
+  index_output_exprs_.clear();
+  index_predicate_ = nullptr;
+  index_only_ = true;
+  if (plan_->GetPredicate() != nullptr) {
+    index_predicate_ = RemapToIndexTuple(plan_->GetPredicate());
+    index_only_ = index_predicate_ != nullptr;
+  }
+  for (const auto &column : GetOutputSchema()->GetColumns()) {
+    if (!index_only_) {
+      break;
+    }
+    const AbstractExpression *expr = RemapToIndexTuple(column.GetExpr());
+    index_only_ = expr != nullptr;
+    index_output_exprs_.push_back(expr);
+  }
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *output_schema = GetOutputSchema();
+  Tuple source;
+  RID entry_rid;
+  while (cursor_->Next(&entry_rid, index_only_ ? &source : nullptr)) {
+    num_entries_read_++;
+    const Schema *source_schema = index_info_->index_->GetIndexTupleSchema();
+    const AbstractExpression *predicate = index_predicate_;
+    if (!index_only_) {
+      if (!table_info_->table_->GetTuple(entry_rid, &source, exec_ctx_->GetTransaction())) {
+        continue;
+      }
+      source_schema = &table_info_->schema_;
+      predicate = plan_->GetPredicate();
+    }
+    if (predicate != nullptr && !predicate->Evaluate(&source, source_schema).GetAs<bool>()) {
+      continue;
+    }
+
+    std::vector<Value> values;
+    values.reserve(output_schema->GetColumnCount());
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      const AbstractExpression *expr = index_only_ ? index_output_exprs_[i] : output_schema->GetColumn(i).GetExpr();
+      values.push_back(expr->Evaluate(&source, source_schema));
+    }
+    *tuple = Tuple(values, output_schema);
+    *rid = entry_rid;
+    return true;
+  }
+  return false;
+}
 
-void IndexScanExecutor::Init() {}
+IndexScanExecutor::KeyRange IndexScanExecutor::RangeOfPredicate() const {
+  KeyRange range;
+  auto *comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+  const Index *index = index_info_->index_.get();
+  if (comparison == nullptr) {
+    return range;
+  }
+  // the seek key fills the other key columns with their smallest values, which variable length columns do not have
+  for (const auto &column : index->GetKeySchema()->GetColumns()) {
+    if (!column.IsInlined()) {
+      return range;
+    }
+  }
+  ComparisonType type = comparison->GetComparisonType();
+  auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    type = Mirror(type);
+  }
+  if (column == nullptr || constant == nullptr || column->GetColIdx() != index->GetKeyAttrs()[0]) {
+    return range;
+  }
+  // a bound of another type would have to be cast, which may not be exact, so the scan reads the whole index
+  Value bound = constant->Evaluate(nullptr, nullptr);
+  if (bound.IsNull() || bound.GetTypeId() != index->GetKeySchema()->GetColumn(0).GetType()) {
+    return range;
+  }
+  switch (type) {
+    case ComparisonType::Equal:
+      range.lower_ = bound;
+      range.upper_ = bound;
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      range.lower_ = bound;
+      break;
+    case ComparisonType::LessThan:
+      range.upper_ = bound;
+      range.upper_inclusive_ = false;
+      break;
+    case ComparisonType::LessThanOrEqual:
+      range.upper_ = bound;
+      break;
+    case ComparisonType::NotEqual:
+      break;
+  }
+  return range;
+}
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+const AbstractExpression *IndexScanExecutor::RemapToIndexTuple(const AbstractExpression *expr) {
+  if (expr == nullptr) {
+    return nullptr;
+  }
+  if (auto *column = dynamic_cast<const ColumnValueExpression *>(expr)) {
+    const auto &attrs = index_info_->index_->GetIndexTupleAttrs();
+    auto position = std::find(attrs.begin(), attrs.end(), column->GetColIdx());
+    if (position == attrs.end()) {
+      return nullptr;
+    }
+    remapped_exprs_.emplace_back(std::make_unique<ColumnValueExpression>(
+        0, static_cast<uint32_t>(position - attrs.begin()), column->GetReturnType()));
+    return remapped_exprs_.back().get();
+  }
+  if (dynamic_cast<const ConstantValueExpression *>(expr) != nullptr) {
+    return expr;
+  }
+  if (auto *comparison = dynamic_cast<const ComparisonExpression *>(expr)) {
+    const AbstractExpression *left = RemapToIndexTuple(comparison->GetChildAt(0));
+    const AbstractExpression *right = RemapToIndexTuple(comparison->GetChildAt(1));
+    if (left == nullptr || right == nullptr) {
+      return nullptr;
+    }
+    remapped_exprs_.emplace_back(std::make_unique<ComparisonExpression>(left, right, comparison->GetComparisonType()));
+    return remapped_exprs_.back().get();
+  }
+  // other expressions are not rewritten, which keeps the scan on the table heap
+  return nullptr;
+}
 
 }  // namespace bustub
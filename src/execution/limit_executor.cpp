@@ -12,14 +12,38 @@
 
 #include "execution/executors/limit_executor.h"
 
+#include <utility>
+
 namespace bustub {
 
 LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void LimitExecutor::Init() {}
+void LimitExecutor::Init() {
+  child_executor_->Init();
+  num_returned_ = 0;
+  offset_skipped_ = false;
+}
 
-bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
+  // the child is not asked for more tuples than the limit needs
+  if (num_returned_ == plan_->GetLimit()) {
+    return false;
+  }
+  if (!offset_skipped_) {
+    for (size_t i = 0; i < plan_->GetOffset(); i++) {
+      if (!child_executor_->Next(tuple, rid)) {
+        return false;
+      }
+    }
+    offset_skipped_ = true;
+  }
+  if (!child_executor_->Next(tuple, rid)) {
+    return false;
+  }
+  num_returned_++;
+  return true;
+}
 
 }  // namespace bustub
@@ -12,15 +12,150 @@
 
 #include "execution/executors/nested_loop_join_executor.h"
 
+#include <utility>
+#include <vector>
+
 namespace bustub {
 
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+void NestedLoopJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  right_loaded_ = false;
+  right_tuples_.clear();
+  has_left_tuple_ = false;
+  right_batches_.clear();
+  right_rows_.clear();
+  has_left_batch_ = false;
+}
+
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!right_loaded_) {
+    Tuple right_tuple;
+    RID right_rid;
+    while (right_executor_->Next(&right_tuple, &right_rid)) {
+      right_tuples_.push_back(right_tuple);
+    }
+    right_loaded_ = true;
+  }
+
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  const Schema *output_schema = GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  while (true) {
+    if (!has_left_tuple_) {
+      RID left_rid;
+      if (!left_executor_->Next(&left_tuple_, &left_rid)) {
+        return false;
+      }
+      has_left_tuple_ = true;
+      right_pos_ = 0;
+    }
+    while (right_pos_ < right_tuples_.size()) {
+      const Tuple &right_tuple = right_tuples_[right_pos_++];
+      if (predicate != nullptr &&
+          !predicate->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+        continue;
+      }
+      std::vector<Value> values;
+      values.reserve(output_schema->GetColumnCount());
+      for (const auto &column : output_schema->GetColumns()) {
+        values.push_back(column.GetExpr()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema));
+      }
+      *tuple = Tuple(values, output_schema);
+      *rid = RID();
+      return true;
+    }
+    has_left_tuple_ = false;
+  }
+}
+
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  if (!right_loaded_) {
+    right_batches_.emplace_back();
+    while (right_executor_->NextBatch(&right_batches_.back())) {
+      auto batch_idx = static_cast<uint32_t>(right_batches_.size() - 1);
+      for (uint32_t row : right_batches_.back().GetSelection()) {
+        right_rows_.emplace_back(batch_idx, row);
+      }
+      right_batches_.emplace_back();
+    }
+    right_batches_.pop_back();
+    right_loaded_ = true;
+  }
+
+  const Schema *output_schema = GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  while (true) {
+    if (!has_left_batch_) {
+      if (!left_executor_->NextBatch(&left_batch_)) {
+        return false;
+      }
+      has_left_batch_ = true;
+      left_pos_ = 0;
+      right_pos_ = 0;
+    }
+    GatherPairs();
+    if (pair_left_.GetNumSelected() == 0) {
+      continue;
+    }
+    if (predicate != nullptr) {
+      predicate->EvaluateJoinBatch(pair_left_, pair_right_, &predicate_values_);
+      pair_left_.Filter(predicate_values_);
+      if (pair_left_.GetNumSelected() == 0) {
+        continue;
+      }
+    }
 
-void NestedLoopJoinExecutor::Init() {}
+    batch->Reset(output_schema->GetColumnCount());
+    for (uint32_t i = 0; i < pair_left_.GetNumSelected(); i++) {
+      batch->AppendRow();
+    }
+    for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+      output_schema->GetColumn(i).GetExpr()->EvaluateJoinBatch(pair_left_, pair_right_, &output_values_);
+      uint32_t out_row = 0;
+      for (uint32_t row : pair_left_.GetSelection()) {
+        batch->SetValue(out_row++, i, output_values_[row]);
+      }
+    }
+    return true;
+  }
+}
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+void NestedLoopJoinExecutor::GatherPairs() {
+  pair_left_.Reset(left_batch_.GetColumnCount());
+  pair_right_.Reset(right_executor_->GetOutputSchema()->GetColumnCount());
+  const std::vector<uint32_t> &left_selection = left_batch_.GetSelection();
+  while (!pair_left_.IsFull() && left_pos_ < left_selection.size()) {
+    uint32_t left_row = left_selection[left_pos_];
+    for (; right_pos_ < right_rows_.size() && !pair_left_.IsFull(); right_pos_++) {
+      const auto &[batch_idx, right_row] = right_rows_[right_pos_];
+      const TupleBatch &right_batch = right_batches_[batch_idx];
+      uint32_t row = pair_left_.AppendRow();
+      pair_right_.AppendRow();
+      for (uint32_t i = 0; i < pair_left_.GetColumnCount(); i++) {
+        pair_left_.SetValue(row, i, left_batch_.GetValue(left_row, i));
+      }
+      for (uint32_t i = 0; i < pair_right_.GetColumnCount(); i++) {
+        pair_right_.SetValue(row, i, right_batch.GetValue(right_row, i));
+      }
+    }
+    if (right_pos_ == right_rows_.size()) {
+      left_pos_++;
+      right_pos_ = 0;
+    }
+  }
+  if (left_pos_ == left_selection.size()) {
+    has_left_batch_ = false;
+  }
+}
 
 }  // namespace bustub
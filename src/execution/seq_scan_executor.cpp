@@ -1,22 +1,251 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-19, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() {}
-
-bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "execution/executors/seq_scan_executor.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+namespace {
+
+/** Adds the columns that an expression reads to col_idxs. */
+void CollectColumns(const AbstractExpression *expr, std::vector<uint32_t> *col_idxs) {
+  if (auto *column = dynamic_cast<const ColumnValueExpression *>(expr)) {
+    if (std::find(col_idxs->begin(), col_idxs->end(), column->GetColIdx()) == col_idxs->end()) {
+      col_idxs->push_back(column->GetColIdx());
+    }
+  }
+  for (const AbstractExpression *child : expr->GetChildren()) {
+    CollectColumns(child, col_idxs);
+  }
+}
+
+}  // namespace
+
+bool MorselDispenser::Next(std::vector<page_id_t> *morsel) {
+  std::lock_guard<std::mutex> lock(latch_);
+  morsel->clear();
+  while (morsel->size() < MORSEL_PAGES && next_page_id_ != INVALID_PAGE_ID) {
+    morsel->push_back(next_page_id_);
+    auto *page = reinterpret_cast<TablePage *>(bpm_->FetchPage(next_page_id_));
+    page->RLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    bpm_->UnpinPage(next_page_id_, false);
+    next_page_id_ = next_page_id;
+  }
+  return !morsel->empty();
+}
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+SeqScanExecutor::~SeqScanExecutor() { StopWorkers(); }
+
+void SeqScanExecutor::Init() {
+  StopWorkers();
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  iterator_ = std::make_unique<TableIterator>(table_info_->table_->Begin(exec_ctx_->GetTransaction()));
+
+  next_rid_ = RID(table_info_->table_->GetFirstPageId(), 0);
+  scanned_columns_.clear();
+  if (plan_->GetPredicate() != nullptr) {
+    CollectColumns(plan_->GetPredicate(), &scanned_columns_);
+  }
+  for (const auto &column : GetOutputSchema()->GetColumns()) {
+    CollectColumns(column.GetExpr(), &scanned_columns_);
+  }
+  std::sort(scanned_columns_.begin(), scanned_columns_.end());
+
+  dispenser_ = std::make_unique<MorselDispenser>(exec_ctx_->GetBufferPoolManager(),
+                                                 table_info_->table_->GetFirstPageId());
+  parallel_ = exec_ctx_->GetNumThreads() > 1 && !enable_logging;
+  gathered_batch_.Reset(0);
+  gathered_pos_ = 0;
+}
+
+bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
+  if (parallel_) {
+    if (exchange_ == nullptr) {
+      StartWorkers();
+    }
+    while (gathered_pos_ == gathered_batch_.GetNumSelected()) {
+      if (!exchange_->Pop(&gathered_batch_)) {
+        return false;
+      }
+      gathered_pos_ = 0;
+    }
+    uint32_t row = gathered_batch_.GetSelection()[gathered_pos_++];
+    *tuple = gathered_batch_.GetTuple(row, GetOutputSchema());
+    *rid = gathered_batch_.GetRid(row);
+    return true;
+  }
+
+  const Schema *schema = &table_info_->schema_;
+  const Schema *output_schema = GetOutputSchema();
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  for (; *iterator_ != table_info_->table_->End(); ++*iterator_) {
+    const Tuple &source = **iterator_;
+    if (predicate != nullptr && !predicate->Evaluate(&source, schema).GetAs<bool>()) {
+      continue;
+    }
+    std::vector<Value> values;
+    values.reserve(output_schema->GetColumnCount());
+    for (const auto &column : output_schema->GetColumns()) {
+      values.push_back(column.GetExpr()->Evaluate(&source, schema));
+    }
+    *tuple = Tuple(values, output_schema);
+    *rid = source.GetRid();
+    ++*iterator_;
+    return true;
+  }
+  return false;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  if (parallel_) {
+    if (exchange_ == nullptr) {
+      StartWorkers();
+    }
+    return exchange_->Pop(batch);
+  }
+
+  while (next_rid_.GetPageId() != INVALID_PAGE_ID) {
+    ScanPages();
+    if (FilterAndProject(&scan_batch_, &predicate_values_, &output_values_, batch)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SeqScanExecutor::NextParallelBatch(ScanWorker *worker, TupleBatch *batch) {
+  const Schema *schema = &table_info_->schema_;
+  TupleBatch *scan_batch = &worker->scan_batch_;
+  while (true) {
+    scan_batch->Reset(schema->GetColumnCount());
+    while (!scan_batch->IsFull()) {
+      if (worker->page_idx_ == worker->morsel_.size()) {
+        worker->page_idx_ = 0;
+        if (!dispenser_->Next(&worker->morsel_)) {
+          break;
+        }
+        worker->next_rid_ = RID(worker->morsel_[0], 0);
+      }
+      page_id_t next_page_id;
+      if (ScanPage(&worker->next_rid_, scan_batch, &next_page_id) &&
+          ++worker->page_idx_ < worker->morsel_.size()) {
+        worker->next_rid_ = RID(worker->morsel_[worker->page_idx_], 0);
+      }
+    }
+    if (scan_batch->GetNumRows() == 0) {
+      return false;
+    }
+    if (FilterAndProject(scan_batch, &worker->predicate_values_, &worker->output_values_, batch)) {
+      return true;
+    }
+  }
+}
+
+void SeqScanExecutor::ScanPages() {
+  scan_batch_.Reset(table_info_->schema_.GetColumnCount());
+  while (!scan_batch_.IsFull() && next_rid_.GetPageId() != INVALID_PAGE_ID) {
+    page_id_t next_page_id;
+    if (ScanPage(&next_rid_, &scan_batch_, &next_page_id)) {
+      next_rid_ = RID(next_page_id, 0);
+    }
+  }
+}
+
+bool SeqScanExecutor::ScanPage(RID *rid, TupleBatch *scan_batch, page_id_t *next_page_id) {
+  const Schema *schema = &table_info_->schema_;
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  // one pin and one latch per page rather than per tuple
+  auto *page = reinterpret_cast<TablePage *>(bpm->FetchPage(rid->GetPageId()));
+  page->RLatch();
+  Tuple tuple;
+  bool has_tuple = rid->GetSlotNum() != 0 || page->GetFirstTupleRid(rid);
+  while (has_tuple && !scan_batch->IsFull()) {
+    if (page->GetTuple(*rid, &tuple, exec_ctx_->GetTransaction(), exec_ctx_->GetLockManager())) {
+      scan_batch->AppendTuple(tuple, schema, scanned_columns_);
+    }
+    has_tuple = page->GetNextTupleRid(*rid, rid);
+  }
+  *next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  bpm->UnpinPage(page->GetTablePageId(), false);
+  return !has_tuple;
+}
+
+bool SeqScanExecutor::FilterAndProject(TupleBatch *scan_batch, std::vector<Value> *predicate_values,
+                                       std::vector<Value> *output_values, TupleBatch *batch) {
+  const Schema *output_schema = GetOutputSchema();
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  if (predicate != nullptr) {
+    predicate->EvaluateBatch(*scan_batch, predicate_values);
+    scan_batch->Filter(*predicate_values);
+  }
+  if (scan_batch->GetNumSelected() == 0) {
+    return false;
+  }
+
+  batch->Reset(output_schema->GetColumnCount());
+  for (uint32_t row : scan_batch->GetSelection()) {
+    batch->AppendRow(scan_batch->GetRid(row));
+  }
+  for (uint32_t i = 0; i < output_schema->GetColumnCount(); i++) {
+    output_schema->GetColumn(i).GetExpr()->EvaluateBatch(*scan_batch, output_values);
+    uint32_t out_row = 0;
+    for (uint32_t row : scan_batch->GetSelection()) {
+      batch->SetValue(out_row++, i, (*output_values)[row]);
+    }
+  }
+  return true;
+}
+
+void SeqScanExecutor::StartWorkers() {
+  size_t num_threads = exec_ctx_->GetNumThreads();
+  // two batches per thread let the threads run ahead of the consumer without buffering the table
+  exchange_ = std::make_unique<BatchExchange>(2 * num_threads, num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    workers_.emplace_back([this] {
+      try {
+        ScanWorker worker;
+        TupleBatch batch;
+        while (NextParallelBatch(&worker, &batch) && exchange_->Push(std::move(batch))) {
+        }
+        exchange_->ProducerDone();
+      } catch (...) {
+        exchange_->ProducerDone(std::current_exception());
+      }
+    });
+  }
+}
+
+void SeqScanExecutor::StopWorkers() {
+  if (exchange_ != nullptr) {
+    exchange_->Close();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  exchange_.reset();
+}
+
+}  // namespace bustub
@@ -0,0 +1,309 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <future>  // NOLINT
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+uint64_t SortExecutor::NormalizedPrefix(const Value &value, OrderByType order_by_type) {
+  if (order_by_type == OrderByType::DESC) {
+    return ~NormalizedPrefix(value, OrderByType::ASC);
+  }
+  static constexpr uint64_t sign_bit = 1ULL << 63;
+  // NULL is the lowest value
+  if (value.IsNull()) {
+    return 0;
+  }
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+      return 1 + static_cast<uint64_t>(value.GetAs<bool>());
+    case TypeId::TINYINT:
+      return static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<int8_t>())) ^ sign_bit;
+    case TypeId::SMALLINT:
+      return static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<int16_t>())) ^ sign_bit;
+    case TypeId::INTEGER:
+      return static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<int32_t>())) ^ sign_bit;
+    case TypeId::BIGINT:
+      return static_cast<uint64_t>(value.GetAs<int64_t>()) ^ sign_bit;
+    case TypeId::TIMESTAMP:
+      return value.GetAs<uint64_t>();
+    case TypeId::DECIMAL: {
+      double raw = value.GetAs<double>();
+      // -0.0 is equal to 0.0
+      if (raw == 0) {
+        raw = 0;
+      }
+      uint64_t bits;
+      memcpy(&bits, &raw, sizeof(bits));
+      return (bits & sign_bit) != 0 ? ~bits : bits | sign_bit;
+    }
+    case TypeId::VARCHAR: {
+      // the first 8 bytes, big endian: VARCHARs compare as memcmp, and then on their lengths
+      uint64_t prefix = 0;
+      const auto *data = reinterpret_cast<const uint8_t *>(value.GetData());
+      uint32_t length = std::min<uint32_t>(value.GetLength() - 1, sizeof(prefix));
+      for (uint32_t i = 0; i < length; i++) {
+        prefix |= static_cast<uint64_t>(data[i]) << (56 - 8 * i);
+      }
+      return prefix;
+    }
+    default:
+      return 0;
+  }
+}
+
+bool SortExecutor::IsPrefixExact(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys) {
+  if (order_bys.size() != 1) {
+    return false;
+  }
+  // NULL is the lowest value of its type, and no other value of these types has a prefix of 0
+  TypeId type = order_bys[0].second->GetReturnType();
+  return type == TypeId::BOOLEAN || type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER ||
+         type == TypeId::BIGINT;
+}
+
+int SortExecutor::CompareKeys(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys,
+                              const Value *a, const Value *b) {
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    int cmp;
+    if (a[i].IsNull() || b[i].IsNull()) {
+      cmp = static_cast<int>(b[i].IsNull()) - static_cast<int>(a[i].IsNull());
+    } else if (a[i].CompareLessThan(b[i]) == CmpBool::CmpTrue) {
+      cmp = -1;
+    } else {
+      cmp = a[i].CompareGreaterThan(b[i]) == CmpBool::CmpTrue ? 1 : 0;
+    }
+    if (cmp != 0) {
+      return order_bys[i].first == OrderByType::DESC ? -cmp : cmp;
+    }
+  }
+  return 0;
+}
+
+bool SortExecutor::HeadLess::operator()(size_t a, size_t b) const {
+  const MergeSource &source_a = executor_->sources_[a];
+  const MergeSource &source_b = executor_->sources_[b];
+  if (source_a.prefix_ != source_b.prefix_) {
+    return source_a.prefix_ < source_b.prefix_;
+  }
+  return !executor_->prefix_exact_ && executor_->CompareKeys(source_a.keys_.data(), source_b.keys_.data()) < 0;
+}
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      prefix_exact_(IsPrefixExact(plan->GetOrderBys())) {}
+
+void SortExecutor::Init() {
+  child_->Init();
+  sorted_ = false;
+  buffer_ = SortBuffer{};
+  buffer_pos_ = 0;
+  tree_.reset();
+  sources_.clear();
+  runs_.clear();
+  spill_stats_ = SpillStats{};
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!sorted_) {
+    Sort();
+    sorted_ = true;
+  }
+  if (tree_ != nullptr) {
+    if (!NextMerged(tuple)) {
+      return false;
+    }
+  } else {
+    if (buffer_pos_ == buffer_.entries_.size()) {
+      return false;
+    }
+    *tuple = buffer_.tuples_[buffer_.entries_[buffer_pos_++].row_];
+  }
+  *rid = RID();
+  return true;
+}
+
+void SortExecutor::Sort() {
+  size_t num_threads = std::max<size_t>(1, GetExecutorContext()->GetNumThreads());
+  // the buffers being sorted by the workers and the one being filled share the memory budget
+  size_t buffer_budget = GetExecutorContext()->GetMemoryBudget() / num_threads;
+  std::vector<std::unique_ptr<TmpTupleRun>> runs;
+  std::deque<std::future<std::unique_ptr<TmpTupleRun>>> pending_runs;
+  auto add_run = [&](std::unique_ptr<TmpTupleRun> &&run) {
+    spill_stats_.num_runs_++;
+    spill_stats_.num_tuples_ += run->GetNumTuples();
+    spill_stats_.num_pages_ += run->GetNumPages();
+    runs.push_back(std::move(run));
+  };
+  auto spill = [&](SortBuffer &&buffer) {
+    if (num_threads == 1) {
+      add_run(SpillRun(&buffer));
+      return;
+    }
+    if (pending_runs.size() == num_threads - 1) {
+      add_run(pending_runs.front().get());
+      pending_runs.pop_front();
+    }
+    pending_runs.push_back(std::async(std::launch::async, [this, buffer = std::move(buffer)]() mutable {
+      return SpillRun(&buffer);
+    }));
+  };
+
+  SortBuffer buffer;
+  size_t num_bytes = 0;
+  Tuple tuple;
+  RID rid;
+  while (child_->Next(&tuple, &rid)) {
+    num_bytes += sizeof(Tuple) + tuple.GetLength();
+    buffer.tuples_.push_back(tuple);
+    if (num_bytes > buffer_budget) {
+      spill(std::move(buffer));
+      buffer = SortBuffer{};
+      num_bytes = 0;
+    }
+  }
+  if (runs.empty() && pending_runs.empty()) {
+    SortInMemory(&buffer);
+    buffer_ = std::move(buffer);
+    return;
+  }
+  if (!buffer.tuples_.empty()) {
+    spill(std::move(buffer));
+  }
+  for (auto &pending_run : pending_runs) {
+    add_run(pending_run.get());
+  }
+
+  // every run being merged keeps a page pinned, and so does the run being written
+  BufferPoolManager *bpm = GetExecutorContext()->GetBufferPoolManager();
+  size_t fan_in = std::max<size_t>(2, std::min(MAX_MERGE_FAN_IN, bpm->GetPoolSize() / 2));
+  while (runs.size() > fan_in) {
+    std::vector<std::unique_ptr<TmpTupleRun>> merged_runs;
+    for (size_t begin = 0; begin < runs.size(); begin += fan_in) {
+      size_t end = std::min(begin + fan_in, runs.size());
+      if (end - begin == 1) {
+        merged_runs.push_back(std::move(runs[begin]));
+        continue;
+      }
+      StartMerge(std::vector<std::unique_ptr<TmpTupleRun>>(std::make_move_iterator(runs.begin() + begin),
+                                                           std::make_move_iterator(runs.begin() + end)));
+      auto merged_run = std::make_unique<TmpTupleRun>(bpm);
+      while (NextMerged(&tuple)) {
+        merged_run->Append(tuple);
+      }
+      merged_run->Finish();
+      spill_stats_.num_runs_++;
+      spill_stats_.num_tuples_ += merged_run->GetNumTuples();
+      spill_stats_.num_pages_ += merged_run->GetNumPages();
+      merged_runs.push_back(std::move(merged_run));
+    }
+    runs = std::move(merged_runs);
+    spill_stats_.num_merge_passes_++;
+  }
+  StartMerge(std::move(runs));
+}
+
+void SortExecutor::SortInMemory(SortBuffer *buffer) const {
+  size_t num_keys = plan_->GetOrderBys().size();
+  buffer->keys_.clear();
+  buffer->keys_.reserve(buffer->tuples_.size() * num_keys);
+  buffer->entries_.clear();
+  buffer->entries_.reserve(buffer->tuples_.size());
+  for (uint32_t row = 0; row < buffer->tuples_.size(); row++) {
+    MakeKeys(buffer->tuples_[row], &buffer->keys_);
+    buffer->entries_.push_back(SortEntry{MakePrefix(&buffer->keys_[row * num_keys]), row});
+  }
+  const Value *keys = buffer->keys_.data();
+  std::sort(buffer->entries_.begin(), buffer->entries_.end(), [&](const SortEntry &a, const SortEntry &b) {
+    if (a.prefix_ != b.prefix_) {
+      return a.prefix_ < b.prefix_;
+    }
+    if (!prefix_exact_) {
+      int cmp = CompareKeys(keys + a.row_ * num_keys, keys + b.row_ * num_keys);
+      if (cmp != 0) {
+        return cmp < 0;
+      }
+    }
+    // equal keys keep the order of the child
+    return a.row_ < b.row_;
+  });
+}
+
+std::unique_ptr<TmpTupleRun> SortExecutor::SpillRun(SortBuffer *buffer) const {
+  SortInMemory(buffer);
+  auto run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+  for (const auto &entry : buffer->entries_) {
+    run->Append(buffer->tuples_[entry.row_]);
+  }
+  run->Finish();
+  return run;
+}
+
+void SortExecutor::MakeKeys(const Tuple &tuple, std::vector<Value> *keys) const {
+  const Schema *schema = child_->GetOutputSchema();
+  for (const auto &order_by : plan_->GetOrderBys()) {
+    keys->push_back(order_by.second->Evaluate(&tuple, schema));
+  }
+}
+
+uint64_t SortExecutor::MakePrefix(const Value *keys) const {
+  const auto &order_bys = plan_->GetOrderBys();
+  return order_bys.empty() ? 0 : NormalizedPrefix(keys[0], order_bys[0].first);
+}
+
+void SortExecutor::StartMerge(std::vector<std::unique_ptr<TmpTupleRun>> &&runs) {
+  // the sources read the runs, so they go first
+  tree_.reset();
+  sources_.clear();
+  runs_ = std::move(runs);
+  sources_.resize(runs_.size());
+  std::vector<bool> exhausted(runs_.size());
+  for (size_t i = 0; i < runs_.size(); i++) {
+    sources_[i].reader_ = std::make_unique<TmpTupleRun::Reader>(runs_[i].get());
+    exhausted[i] = !Advance(&sources_[i]);
+  }
+  tree_ = std::make_unique<LoserTree<HeadLess>>(runs_.size(), HeadLess{this});
+  tree_->Build(std::move(exhausted));
+}
+
+bool SortExecutor::Advance(MergeSource *source) {
+  if (!source->reader_->Next(&source->head_)) {
+    return false;
+  }
+  source->keys_.clear();
+  MakeKeys(source->head_, &source->keys_);
+  source->prefix_ = MakePrefix(source->keys_.data());
+  return true;
+}
+
+bool SortExecutor::NextMerged(Tuple *tuple) {
+  size_t top = tree_->Top();
+  if (top == sources_.size()) {
+    return false;
+  }
+  *tuple = sources_[top].head_;
+  tree_->Pop(!Advance(&sources_[top]));
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.cpp
+//
+// Identification: src/execution/top_n_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/top_n_executor.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/sort_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/index_scan_plan.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return true if the child of plan is an index scan whose index key starts with the ORDER BY keys, all ascending */
+bool IsOrderedByIndex(const TopNPlanNode *plan, Catalog *catalog) {
+  auto *index_scan = dynamic_cast<const IndexScanPlanNode *>(plan->GetChildPlan());
+  if (index_scan == nullptr) {
+    return false;
+  }
+  const auto &key_attrs = catalog->GetIndex(index_scan->GetIndexOid())->index_->GetKeyAttrs();
+  const auto &order_bys = plan->GetOrderBys();
+  if (order_bys.size() > key_attrs.size()) {
+    return false;
+  }
+  const Schema *scan_schema = index_scan->OutputSchema();
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    auto *column = dynamic_cast<const ColumnValueExpression *>(order_bys[i].second);
+    if (order_bys[i].first != OrderByType::ASC || column == nullptr) {
+      return false;
+    }
+    // the scan's output columns are evaluated on the table's tuples
+    auto *table_column =
+        dynamic_cast<const ColumnValueExpression *>(scan_schema->GetColumn(column->GetColIdx()).GetExpr());
+    if (table_column == nullptr || table_column->GetColIdx() != key_attrs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      prefix_exact_(SortExecutor::IsPrefixExact(plan->GetOrderBys())) {}
+
+void TopNExecutor::Init() {
+  child_->Init();
+  input_ordered_ = IsOrderedByIndex(plan_, exec_ctx_->GetCatalog());
+  collected_ = false;
+  heap_.clear();
+  heap_pos_ = 0;
+  num_returned_ = 0;
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (input_ordered_) {
+    if (num_returned_ == plan_->GetN() || !child_->Next(tuple, rid)) {
+      return false;
+    }
+    num_returned_++;
+    return true;
+  }
+
+  if (!collected_) {
+    Collect();
+    collected_ = true;
+  }
+  if (heap_pos_ == heap_.size()) {
+    return false;
+  }
+  *tuple = heap_[heap_pos_++].tuple_;
+  *rid = RID();
+  return true;
+}
+
+bool TopNExecutor::Less(const TopNEntry &a, const TopNEntry &b) const {
+  if (a.prefix_ != b.prefix_) {
+    return a.prefix_ < b.prefix_;
+  }
+  if (!prefix_exact_) {
+    int cmp = SortExecutor::CompareKeys(plan_->GetOrderBys(), a.keys_.data(), b.keys_.data());
+    if (cmp != 0) {
+      return cmp < 0;
+    }
+  }
+  // equal keys keep the order of the child
+  return a.seq_ < b.seq_;
+}
+
+void TopNExecutor::Collect() {
+  size_t n = plan_->GetN();
+  if (n == 0) {
+    return;
+  }
+  heap_.reserve(n);
+  auto less = [this](const TopNEntry &a, const TopNEntry &b) { return Less(a, b); };
+  const Schema *schema = child_->GetOutputSchema();
+  const auto &order_bys = plan_->GetOrderBys();
+  TopNEntry entry;
+  Tuple tuple;
+  RID rid;
+  for (size_t seq = 0; child_->Next(&tuple, &rid); seq++) {
+    Value first_key = order_bys[0].second->Evaluate(&tuple, schema);
+    entry.prefix_ = SortExecutor::NormalizedPrefix(first_key, order_bys[0].first);
+    if (heap_.size() == n && entry.prefix_ > heap_.front().prefix_) {
+      continue;
+    }
+    entry.seq_ = seq;
+    entry.keys_.clear();
+    entry.keys_.push_back(first_key);
+    for (size_t i = 1; i < order_bys.size(); i++) {
+      entry.keys_.push_back(order_bys[i].second->Evaluate(&tuple, schema));
+    }
+    if (heap_.size() == n) {
+      if (!Less(entry, heap_.front())) {
+        continue;
+      }
+      std::pop_heap(heap_.begin(), heap_.end(), less);
+      heap_.pop_back();
+    }
+    entry.tuple_ = tuple;
+    heap_.push_back(std::move(entry));
+    std::push_heap(heap_.begin(), heap_.end(), less);
+    entry = TopNEntry{};
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), less);
+}
+
+}  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(uint32_t column_count) {
+  // the columns keep their storage, so a batch that is reused allocates nothing after the first time
+  columns_.resize(column_count);
+  for (auto &column : columns_) {
+    column.resize(capacity_);
+  }
+  rids_.resize(capacity_);
+  selection_.clear();
+  num_rows_ = 0;
+}
+
+uint32_t TupleBatch::AppendRow(const RID &rid) {
+  BUSTUB_ASSERT(!IsFull(), "Cannot append to a full batch.");
+  rids_[num_rows_] = rid;
+  selection_.push_back(num_rows_);
+  return num_rows_++;
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema *schema, const std::vector<uint32_t> &col_idxs) {
+  uint32_t row = AppendRow(tuple.GetRid());
+  for (uint32_t col_idx : col_idxs) {
+    columns_[col_idx][row] = tuple.GetValue(schema, col_idx);
+  }
+}
+
+void TupleBatch::Filter(const std::vector<Value> &predicate) {
+  uint32_t num_selected = 0;
+  for (uint32_t row : selection_) {
+    if (predicate[row].GetAs<bool>()) {
+      selection_[num_selected++] = row;
+    }
+  }
+  selection_.resize(num_selected);
+}
+
+Tuple TupleBatch::GetTuple(uint32_t row, const Schema *schema) const {
+  std::vector<Value> values;
+  values.reserve(GetColumnCount());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  Tuple tuple(values, schema);
+  return tuple;
+}
+
+}  // namespace bustub
@@ -94,6 +94,9 @@ class BufferPoolManager {
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
+  /** @return the disk manager backing this pool, for callers that write pages around the pool */
+  DiskManager *GetDiskManager() { return disk_manager_; }
+
   /** @return size of the buffer pool */
   size_t GetPoolSize() { return pool_size_; }
 
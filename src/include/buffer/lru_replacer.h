@@ -14,6 +14,7 @@
 
 #include <list>
 #include <mutex>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -46,8 +47,10 @@ class LRUReplacer : public Replacer {
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
-  std::list<frame_id_t> frames;
+  // unpinned frames, least recently unpinned first
+  std::list<frame_id_t> frames_;
+  // position of every frame in frames_, so pinning does not have to search the list
+  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> positions_;
 };
 
 }  // namespace bustub
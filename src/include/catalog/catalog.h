@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -8,8 +9,13 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/exception.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_epsilon_tree_index.h"
+#include "storage/index/b_link_tree_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/index.h"
+#include "storage/index/lsm_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -21,6 +27,30 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The data structures an index can be built on. */
+enum class IndexType { BPlusTreeIndex, BLinkTreeIndex, BEpsilonTreeIndex, ArtIndex, LSMTreeIndex };
+
+/**
+ * Statistics about a column of a table.
+ */
+struct ColumnStats {
+  /** The number of NULLs in the column. */
+  size_t num_nulls_{0};
+  /** Whether min_ and max_ hold the range of the column, which is only kept for integer columns with a value. */
+  bool has_range_{false};
+  int64_t min_{0};
+  int64_t max_{0};
+};
+
+/**
+ * Statistics about a table, as of the last time it was analyzed. They are not maintained as the table changes, so
+ * they are a hint: rows inserted since the analysis may fall outside of the ranges of their columns.
+ */
+struct TableStats {
+  size_t num_rows_{0};
+  std::vector<ColumnStats> columns_;
+};
+
 /**
  * Metadata about a table.
  */
@@ -31,6 +61,8 @@ struct TableMetadata {
   std::string name_;
   std::unique_ptr<TableHeap> table_;
   table_oid_t oid_;
+  /** The statistics of the table, nullptr until the table is analyzed. */
+  std::unique_ptr<TableStats> stats_;
 };
 
 /**
@@ -77,14 +109,64 @@ class Catalog {
    */
   TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema) {
     BUSTUB_ASSERT(names_.count(table_name) == 0, "Table names should be unique!");
-    return nullptr;
+    table_oid_t table_oid = next_table_oid_++;
+    auto table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+    tables_[table_oid] = std::make_unique<TableMetadata>(schema, table_name, std::move(table), table_oid);
+    names_[table_name] = table_oid;
+    return tables_[table_oid].get();
   }
 
   /** @return table metadata by name */
-  TableMetadata *GetTable(const std::string &table_name) { return nullptr; }
+  TableMetadata *GetTable(const std::string &table_name) { return tables_.at(names_.at(table_name)).get(); }
 
   /** @return table metadata by oid */
-  TableMetadata *GetTable(table_oid_t table_oid) { return nullptr; }
+  TableMetadata *GetTable(table_oid_t table_oid) { return tables_.at(table_oid).get(); }
+
+  /**
+   * Scans a table and replaces its statistics.
+   * @param txn the transaction in which the table is being analyzed
+   * @param table_name the name of the table
+   * @return the new statistics of the table
+   */
+  const TableStats *AnalyzeTable(Transaction *txn, const std::string &table_name) {
+    TableMetadata *table_info = GetTable(table_name);
+    const Schema &schema = table_info->schema_;
+    auto stats = std::make_unique<TableStats>();
+    stats->columns_.resize(schema.GetColumnCount());
+    for (auto iter = table_info->table_->Begin(txn); iter != table_info->table_->End(); ++iter) {
+      stats->num_rows_++;
+      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+        ColumnStats &column = stats->columns_[i];
+        Value value = iter->GetValue(&schema, i);
+        if (value.IsNull()) {
+          column.num_nulls_++;
+          continue;
+        }
+        int64_t integer;
+        switch (value.GetTypeId()) {
+          case TypeId::TINYINT:
+            integer = value.GetAs<int8_t>();
+            break;
+          case TypeId::SMALLINT:
+            integer = value.GetAs<int16_t>();
+            break;
+          case TypeId::INTEGER:
+            integer = value.GetAs<int32_t>();
+            break;
+          case TypeId::BIGINT:
+            integer = value.GetAs<int64_t>();
+            break;
+          default:
+            continue;
+        }
+        column.min_ = column.has_range_ ? std::min(column.min_, integer) : integer;
+        column.max_ = column.has_range_ ? std::max(column.max_, integer) : integer;
+        column.has_range_ = true;
+      }
+    }
+    table_info->stats_ = std::move(stats);
+    return table_info->stats_.get();
+  }
 
   /**
    * Create a new index, populate existing data of the table and return its metadata.
@@ -95,25 +177,84 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param include_attrs non-key attributes stored in the index, which makes it a covering index; covering indexes
+   * must be unique
+   * @param is_unique whether a key maps to at most one tuple
+   * @param index_type the data structure backing the index; only B+ tree indexes support duplicates and included
+   * columns
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
-    return nullptr;
+                         size_t keysize, const std::vector<uint32_t> &include_attrs = {}, bool is_unique = true,
+                         IndexType index_type = IndexType::BPlusTreeIndex) {
+    if (index_type != IndexType::BPlusTreeIndex && (!is_unique || !include_attrs.empty())) {
+      throw Exception(ExceptionType::NOT_IMPLEMENTED, "Only B+ tree indexes support duplicates and included columns");
+    }
+    if (!is_unique && !include_attrs.empty()) {
+      // the tuples with the same key share one entry, which can only hold the included columns of one of them
+      throw Exception(ExceptionType::NOT_IMPLEMENTED, "Indexes with included columns must be unique");
+    }
+    auto *metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs, is_unique, include_attrs);
+    if (metadata->GetIndexTupleSchema()->GetLength() > keysize) {
+      delete metadata;
+      throw Exception(ExceptionType::OUT_OF_RANGE, "Index key and included columns do not fit into the key size");
+    }
+    std::unique_ptr<Index> index;
+    switch (index_type) {
+      case IndexType::BPlusTreeIndex:
+        index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+        break;
+      case IndexType::BLinkTreeIndex:
+        index = std::make_unique<BLinkTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+        break;
+      case IndexType::BEpsilonTreeIndex:
+        index = std::make_unique<BEpsilonTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+        break;
+      case IndexType::ArtIndex:
+        index = std::make_unique<ArtIndex>(metadata);
+        break;
+      case IndexType::LSMTreeIndex:
+        index = std::make_unique<LSMTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+        break;
+    }
+
+    // populate the index with the tuples already in the table
+    TableHeap *table = GetTable(table_name)->table_.get();
+    for (auto it = table->Begin(txn); it != table->End(); ++it) {
+      index->InsertEntry(it->KeyFromTuple(schema, *metadata->GetIndexTupleSchema(), metadata->GetIndexTupleAttrs()),
+                         it->GetRid(), txn);
+    }
+
+    index_oid_t index_oid = next_index_oid_++;
+    indexes_[index_oid] =
+        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    index_names_[table_name][index_name] = index_oid;
+    return indexes_[index_oid].get();
   }
 
-  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) { return nullptr; }
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    return indexes_.at(index_names_.at(table_name).at(index_name)).get();
+  }
 
-  IndexInfo *GetIndex(index_oid_t index_oid) { return nullptr; }
+  IndexInfo *GetIndex(index_oid_t index_oid) { return indexes_.at(index_oid).get(); }
 
-  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) { return std::vector<IndexInfo *>(); }
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    std::vector<IndexInfo *> result;
+    auto table_indexes = index_names_.find(table_name);
+    if (table_indexes != index_names_.end()) {
+      for (const auto &entry : table_indexes->second) {
+        result.push_back(indexes_.at(entry.second).get());
+      }
+    }
+    return result;
+  }
 
  private:
-  [[maybe_unused]] BufferPoolManager *bpm_;
-  [[maybe_unused]] LockManager *lock_manager_;
-  [[maybe_unused]] LogManager *log_manager_;
+  BufferPoolManager *bpm_;
+  LockManager *lock_manager_;
+  LogManager *log_manager_;
 
   /** tables_ : table identifiers -> table metadata. Note that tables_ owns all table metadata. */
   std::unordered_map<table_oid_t, std::unique_ptr<TableMetadata>> tables_;
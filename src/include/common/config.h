@@ -35,6 +35,9 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int EXECUTION_BATCH_SIZE = 1024;                             // rows per vectorized batch
+static constexpr size_t EXECUTION_MEMORY_BUDGET = 64 << 20;                   // bytes an operator may hold before spilling
+static constexpr size_t EXECUTION_NUM_THREADS = 1;                            // worker threads an operator may use
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.h
+//
+// Identification: src/include/common/thread_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <queue>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * A fixed set of worker threads running submitted tasks in FIFO order.
+ * The destructor runs the tasks still queued and joins the workers.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Creates a new thread pool.
+   * @param num_threads the number of worker threads
+   */
+  explicit ThreadPool(size_t num_threads);
+
+  ~ThreadPool();
+
+  DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  /**
+   * Queues a task.
+   * @param task the task to run on a worker
+   * @return a future that becomes ready once the task ran; it rethrows what the task threw
+   */
+  std::future<void> Submit(std::function<void()> task);
+
+  /** @return the number of worker threads */
+  size_t GetNumThreads() const { return workers_.size(); }
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::queue<std::packaged_task<void()>> tasks_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool shutdown_{false};
+};
+
+}  // namespace bustub
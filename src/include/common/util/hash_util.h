@@ -13,9 +13,17 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <type_traits>
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
 
 #include "common/macros.h"
 #include "type/value.h"
@@ -24,37 +32,167 @@ namespace bustub {
 
 using hash_t = std::size_t;
 
+/** Strings longer than this many bytes are hashed in 64-byte stripes. */
+#define HASH_UTIL_LONG_THRESHOLD 256
+
+/**
+ * Hash functions for keys and values.
+ *
+ * Integers go through HashInt, two CRC32C steps (one per 32-bit half) followed by a multiply-xorshift
+ * finalizer. The function is a bijection on 64-bit integers, so distinct integers never collide, and
+ * the finalizer spreads every input bit over both the low bits (used by modulo bucketing) and the high
+ * bits (used by fingerprints). CRC32C uses the SSE 4.2 instruction when it is available and a table
+ * otherwise, with the same results, so hashes do not depend on the target.
+ *
+ * Byte strings go through HashBytes. Strings of up to HASH_UTIL_LONG_THRESHOLD bytes use a
+ * wyhash-style loop of 64x64->128 bit multiplications; longer strings use an xxHash3-style loop
+ * that accumulates 64-byte stripes into eight 64-bit lanes, with AVX2 when it is available.
+ */
 class HashUtil {
  private:
   static const hash_t prime_factor = 10000019;
 
+  static constexpr uint64_t kSecret0 = 0xa0761d6478bd642fULL;
+  static constexpr uint64_t kSecret1 = 0xe7037ed1a0b428dbULL;
+  static constexpr uint64_t kSecret2 = 0x8ebc6af09c88c6e3ULL;
+  static constexpr uint64_t kSecret3 = 0x589965cc75374cc3ULL;
+
+  static inline uint64_t Read8(const char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static inline uint64_t Read4(const char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  /** @return 1 to 3 bytes packed so that every byte influences the result */
+  static inline uint64_t Read3(const char *p, size_t length) {
+    auto byte = [&](size_t i) { return static_cast<uint64_t>(static_cast<uint8_t>(p[i])); };
+    return (byte(0) << 16) | (byte(length >> 1) << 8) | byte(length - 1);
+  }
+
+  /** @return the xor of the low and high halves of the 128-bit product a * b */
+  static inline uint64_t Mix(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  /** Hashes strings longer than HASH_UTIL_LONG_THRESHOLD bytes. */
+  static hash_t HashLong(const char *bytes, size_t length);
+
+  /** @return the CRC32C of every byte value, with the reflected Castagnoli polynomial */
+  static constexpr std::array<uint32_t, 256> MakeCrc32Table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t byte = 0; byte < 256; byte++) {
+      uint32_t crc = byte;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0x82f63b78U & (0U - (crc & 1U)));
+      }
+      table[byte] = crc;
+    }
+    return table;
+  }
+
  public:
-  static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  /** @return crc updated with the four bytes of value, least significant first, like _mm_crc32_u32 */
+  static inline uint32_t Crc32Portable(uint32_t crc, uint32_t value) {
+    static constexpr std::array<uint32_t, 256> table = MakeCrc32Table();
+    crc ^= value;
+    for (int i = 0; i < 4; i++) {
+      crc = (crc >> 8) ^ table[crc & 0xff];
     }
+    return crc;
+  }
+
+  /** @return crc updated with the four bytes of value, least significant first */
+  static inline uint32_t Crc32(uint32_t crc, uint32_t value) {
+#ifdef __SSE4_2__
+    return _mm_crc32_u32(crc, value);
+#else
+    return Crc32Portable(crc, value);
+#endif
+  }
+
+  /** @return the hash of a 64-bit integer */
+  static inline hash_t HashInt(uint64_t key) {
+    uint64_t low = Crc32(0x243f6a88, static_cast<uint32_t>(key));
+    uint64_t high = Crc32(0x85a308d3, static_cast<uint32_t>(key >> 32));
+    uint64_t hash = (high << 32) | low;
+    // murmur3 finalizer, also a bijection
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
     return hash;
   }
 
-  static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+  static inline hash_t HashBytes(const char *bytes, size_t length) {
+    if (length > HASH_UTIL_LONG_THRESHOLD) {
+      return HashLong(bytes, length);
+    }
+    uint64_t seed = kSecret0 ^ Mix(kSecret0, kSecret1);
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+      if (length >= 4) {
+        size_t quarter = (length >> 3) << 2;
+        a = (Read4(bytes) << 32) | Read4(bytes + quarter);
+        b = (Read4(bytes + length - 4) << 32) | Read4(bytes + length - 4 - quarter);
+      } else if (length > 0) {
+        a = Read3(bytes, length);
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      const char *p = bytes;
+      size_t remaining = length;
+      if (remaining > 48) {
+        uint64_t see1 = seed;
+        uint64_t see2 = seed;
+        do {
+          seed = Mix(Read8(p) ^ kSecret1, Read8(p + 8) ^ seed);
+          see1 = Mix(Read8(p + 16) ^ kSecret2, Read8(p + 24) ^ see1);
+          see2 = Mix(Read8(p + 32) ^ kSecret3, Read8(p + 40) ^ see2);
+          p += 48;
+          remaining -= 48;
+        } while (remaining > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (remaining > 16) {
+        seed = Mix(Read8(p) ^ kSecret1, Read8(p + 8) ^ seed);
+        p += 16;
+        remaining -= 16;
+      }
+      // the last 16 bytes, which may overlap bytes hashed above
+      a = Read8(p + remaining - 16);
+      b = Read8(p + remaining - 8);
+    }
+    __uint128_t product = static_cast<__uint128_t>(a ^ kSecret1) * (b ^ seed);
+    return Mix(static_cast<uint64_t>(product) ^ kSecret0 ^ length, static_cast<uint64_t>(product >> 64) ^ kSecret1);
   }
 
+  static inline hash_t CombineHashes(hash_t l, hash_t r) { return Mix(l ^ kSecret0, r ^ kSecret1); }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
   template <typename T>
   static inline hash_t Hash(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    if constexpr (std::is_integral<T>::value) {
+      return HashInt(static_cast<uint64_t>(*ptr));
+    } else {
+      return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    }
   }
 
   template <typename T>
   static inline hash_t HashPtr(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashInt(reinterpret_cast<uintptr_t>(ptr));
   }
 
   /** @return the hash of the value */
@@ -82,7 +220,13 @@ class HashUtil {
       }
       case TypeId::DECIMAL: {
         auto raw = val->GetAs<double>();
-        return Hash<double>(&raw);
+        // -0.0 compares equal to 0.0
+        if (raw == 0) {
+          raw = 0;
+        }
+        uint64_t bits;
+        memcpy(&bits, &raw, sizeof(bits));
+        return HashInt(bits);
       }
       case TypeId::VARCHAR: {
         auto raw = val->GetData();
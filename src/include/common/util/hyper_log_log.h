@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hyper_log_log.h
+//
+// Identification: src/include/common/util/hyper_log_log.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * HyperLogLog estimates the number of distinct hashes added to it in a fixed 2^PRECISION bytes.
+ *
+ * The high PRECISION bits of a hash pick a register, which keeps the longest run of leading zeros (plus one) seen in
+ * the remaining bits. The harmonic mean of the registers gives the estimate, with a standard error of about
+ * 1.04 / sqrt(2^PRECISION); small cardinalities, which leave registers empty, are counted from the empty registers
+ * instead. Two sketches merge into the sketch of the union of their hashes.
+ */
+class HyperLogLog {
+ public:
+  /** The number of hash bits that pick a register. */
+  static constexpr uint32_t PRECISION = 10;
+  /** The number of registers, which is also the size of the sketch in bytes. */
+  static constexpr uint32_t NUM_REGISTERS = 1U << PRECISION;
+
+  /** Adds a hash to the sketch. The hash must mix all the bits of the hashed value into its high bits. */
+  void Add(hash_t hash) {
+    auto idx = static_cast<uint32_t>(hash >> (64 - PRECISION));
+    uint64_t rest = static_cast<uint64_t>(hash) << PRECISION;
+    auto rank = static_cast<uint8_t>(rest == 0 ? 64 - PRECISION + 1 : __builtin_clzll(rest) + 1);
+    registers_[idx] = std::max(registers_[idx], rank);
+  }
+
+  /** Adds the hashes of another sketch to this one. */
+  void Merge(const HyperLogLog &other) {
+    for (uint32_t i = 0; i < NUM_REGISTERS; i++) {
+      registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+  }
+
+  /** @return the estimated number of distinct hashes added to the sketch */
+  uint64_t Estimate() const {
+    double sum = 0;
+    uint32_t num_zeros = 0;
+    for (uint8_t rank : registers_) {
+      sum += std::ldexp(1.0, -rank);
+      num_zeros += rank == 0 ? 1 : 0;
+    }
+    constexpr double m = NUM_REGISTERS;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && num_zeros > 0) {
+      // linear counting, which is more accurate while many registers are empty
+      estimate = m * std::log(m / num_zeros);
+    }
+    return static_cast<uint64_t>(std::llround(estimate));
+  }
+
+ private:
+  std::array<uint8_t, NUM_REGISTERS> registers_{};
+};
+
+}  // namespace bustub
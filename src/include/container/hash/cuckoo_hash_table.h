@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table.h
+//
+// Identification: src/include/container/hash/cuckoo_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/cuckoo_hash_table_block_page.h"
+#include "storage/page/hash_table_header_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define CUCKOO_HASH_TABLE_TYPE CuckooHashTable<KeyType, ValueType, KeyComparator>
+
+/** The longest chain of displacements an insert tries before the table grows. */
+#define CUCKOO_MAX_DISPLACEMENTS 500
+
+/**
+ * Implementation of bucketized cuckoo hashing that is backed by a buffer
+ * pool manager. Non-unique keys are supported, up to 2 * CUCKOO_BUCKET_SLOTS
+ * values per key. Supports insert and delete.
+ *
+ * Every key has two candidate buckets, picked by the low and the high half of
+ * its hash, and is stored in one of them. A lookup therefore reads exactly two
+ * buckets, at most two pages, no matter how full the table is, and the table
+ * reaches load factors above 90% before it grows. An insert into two full
+ * buckets moves a random pair of one of them to that pair's other bucket, and
+ * so on, for at most CUCKOO_MAX_DISPLACEMENTS steps. If that fails, the table
+ * doubles its number of buckets.
+ *
+ * The header page lists the block pages, which hold CUCKOO_BLOCK_BUCKETS
+ * buckets each. Concurrency:
+ * (1) lookups hold the table latch for reading and latch the pages of their
+ * two buckets for reading
+ * (2) inserts and removes hold the table latch for reading and latch the pages
+ * of their two buckets for writing
+ * (3) inserts that must displace pairs, and the growth of the table, start
+ * over with the table latch held for writing
+ * Pages are latched in page id order.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class CuckooHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+  using BlockPage = CuckooHashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * Creates a new CuckooHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param num_buckets initial number of buckets, each of CUCKOO_BUCKET_SLOTS slots
+   * @param hash_fn the hash function
+   */
+  explicit CuckooHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                           const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or the key already has 2 * CUCKOO_BUCKET_SLOTS values
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the number of pairs in the hash table
+   */
+  size_t GetSize();
+
+  /**
+   * @return the number of buckets in the hash table
+   */
+  size_t GetNumBuckets();
+
+ private:
+  Page *FetchPage(page_id_t page_id);
+
+  // allocates a header and empty blocks for num_buckets buckets, returned pinned
+  HashTableHeaderPage *NewHeaderPage(size_t num_buckets);
+
+  // deletes the header and the blocks of a table
+  void DeleteTable(page_id_t header_page_id);
+
+  // the two candidate buckets of a hash, which always differ
+  void Buckets(uint64_t hash, size_t num_buckets, size_t buckets[2]) const;
+
+  /**
+   * Calls visit(blocks, offsets) with the blocks holding the two buckets of the hash latched, and offsets the indexes
+   * of the buckets within their blocks.
+   */
+  template <typename Visitor>
+  void LatchBuckets(HashTableHeaderPage *header, uint64_t hash, bool exclusive, Visitor &&visit);
+
+  /**
+   * With the table latch held for writing, stores a pair that is not in the table yet, displacing others if needed.
+   * @return false if the displacements ran out; they are then undone, leaving the table and *pair as they were
+   */
+  bool Place(HashTableHeaderPage *header, MappingType *pair);
+
+  // table latch held for writing
+  bool InsertExclusive(const KeyType &key, const ValueType &value, uint64_t hash);
+
+  // table latch held for writing: rebuilds the table with more buckets, adding the pair that did not fit
+  void Grow(const MappingType &orphan);
+
+  // member variable
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers are lookups, inserts and removes, writers are displacing inserts and growth
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+
+  std::atomic<size_t> num_pairs_{0};
+  // picks the pairs to displace, table latch held for writing
+  std::mt19937 generator_;
+};
+
+}  // namespace bustub
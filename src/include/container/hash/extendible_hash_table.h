@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/extendible_hash_table_bucket_page.h"
+#include "storage/page/extendible_hash_table_directory_page.h"
+#include "storage/page/extendible_hash_table_header_page.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hashing that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete.
+ *
+ * A header page picks a directory page by the top bits of the hash, the
+ * directory picks a bucket page by the low bits. A full bucket is split in
+ * two, doubling its directory if needed; an empty bucket is merged with its
+ * split image. Growth therefore costs one split at a time, and it only
+ * blocks the operations on the directory being changed:
+ * (1) lookups latch header, directory and bucket for reading, releasing each
+ * latch once the next one is held
+ * (2) inserts and removes latch the directory for reading and only the bucket
+ * for writing
+ * (3) splits and merges start over with the directory latched for writing
+ *
+ * With the default depths a table holds 2^18 buckets.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+  using HeaderPage = ExtendibleHashTableHeaderPage;
+  using DirectoryPage = ExtendibleHashTableDirectoryPage;
+  using BucketPage = ExtendibleHashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * Creates a new ExtendibleHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   * @param header_max_depth the number of hash bits that pick a directory
+   * @param directory_max_depth the largest global depth of a directory
+   * @param bucket_max_size the number of pairs per bucket
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                               uint32_t header_max_depth = HEADER_MAX_DEPTH,
+                               uint32_t directory_max_depth = DIRECTORY_MAX_DEPTH,
+                               uint32_t bucket_max_size = BUCKET_ARRAY_SIZE);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or its bucket cannot be split any further
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * Checks the invariants of every directory; must not run concurrently with other operations.
+   */
+  void VerifyIntegrity();
+
+  /**
+   * @return the largest global depth of any directory
+   */
+  uint32_t GetGlobalDepth();
+
+ private:
+  uint32_t Hash(const KeyType &key) { return static_cast<uint32_t>(hash_fn_.GetHash(key)); }
+
+  Page *FetchPage(page_id_t page_id);
+
+  // returns the directory responsible for the hash, creating it if needed
+  page_id_t GetOrCreateDirectory(uint32_t hash);
+
+  // creates a bucket page, returned latched for writing and pinned
+  Page *NewBucketPage(page_id_t *page_id);
+
+  /**
+   * Splits the bucket of the hash if it is still full.
+   * @return false if the bucket is at the maximal depth of its directory
+   */
+  bool SplitBucket(page_id_t directory_page_id, uint32_t hash);
+
+  // merges the bucket of the hash with its split image while either is empty, then shrinks the directory
+  void MergeBucket(page_id_t directory_page_id, uint32_t hash);
+
+  // member variable
+  std::string index_name_;
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  uint32_t directory_max_depth_;
+  uint32_t bucket_max_size_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -13,8 +13,9 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hash_util.h"
 
 namespace bustub {
 
@@ -26,10 +27,11 @@ class HashFunction {
    * @return the hashed value
    */
   virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
+    if constexpr (std::is_integral<KeyType>::value) {
+      return HashUtil::HashInt(static_cast<uint64_t>(key));
+    } else {
+      return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+    }
   }
 };
 
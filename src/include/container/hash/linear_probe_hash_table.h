@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
 #include <vector>
@@ -27,14 +29,59 @@
 namespace bustub {
 
 #define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_KEY_LATCHES 64
+#define HASH_TABLE_PREFETCH_GROUP 16
+
+/** How a LinearProbeHashTable grows. */
+enum class HashTableGrowth {
+  // rebuild the whole table at twice the size once it is full
+  Resize,
+  // split one bucket at a time, see below
+  LinearHashing
+};
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Probing walks a group of slots at a time: the one byte fingerprints of the
+ * whole group are compared at once (see HashTableBlockPage::MatchGroup), and
+ * only the keys of matching slots are read. A probe ends at the first slot
+ * that was never occupied.
+ *
+ * Only resizes take the table latch exclusively, all other operations share
+ * it and then:
+ * (1) lookups take no further latches; they read blocks through
+ * HashTableBlockPage::ReadGroup, which retries while a block is written
+ * (2) inserts and removes lock one of HASH_TABLE_KEY_LATCHES key latches,
+ * picked by the hash, so that operations on the same key are serialized. They
+ * probe like lookups and only take the write latch of the one block they
+ * change. An insert that lost its free slot to another insert probes again
+ * (3) slots that were once occupied never become empty again before the next
+ * resize, so a probe that ends at an empty slot never misses a pair
+ * Latches are always taken in the order table latch, key latch, block latch.
+ *
+ * With HashTableGrowth::LinearHashing the table instead grows like Litwin's
+ * linear hashing, without ever pausing:
+ * (1) every block is a bucket; a key probes the block of its bucket starting
+ * at a slot picked by its hash, then the bucket's chain of overflow blocks
+ * (2) once the table is fuller than the maximal load factor, an insert splits
+ * the next bucket in round-robin order, moving about half of its pairs to a
+ * new bucket at the end of the table. A round doubles the number of buckets,
+ * and a key is in bucket hash mod buckets_in_round or, if that bucket was
+ * already split in the current round, hash mod (2 * buckets_in_round)
+ * (3) operations latch the primary block of their bucket only, which covers
+ * its overflow chain; lookups latch it for reading. A split holds the latch of
+ * the bucket being split while it publishes the new number of buckets, and
+ * operations check that their bucket is still the right one once they hold
+ * its latch
+ * The table stops splitting when the header page has no room for more blocks.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+  using BlockPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
  public:
   /**
    * Creates a new LinearProbeHashTable
@@ -43,9 +90,12 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    * @param comparator comparator for keys
    * @param num_buckets initial number of buckets contained by this hash table
    * @param hash_fn the hash function
+   * @param growth how the table grows
+   * @param max_load_factor with linear hashing, the ratio of pairs to slots in primary blocks above which buckets split
    */
   explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn,
+                                HashTableGrowth growth = HashTableGrowth::Resize, double max_load_factor = 0.75);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -75,7 +125,18 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Performs a point query for every key of a batch. Keys are looked up HASH_TABLE_PREFETCH_GROUP at a time: the
+   * first blocks of all their probes are fetched and their slots prefetched before any of them is probed, so that
+   * the cache misses of a group overlap.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results (*results)[i] receives the values associated with keys[i]
+   */
+  void GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                 std::vector<std::vector<ValueType>> *results);
+
+  /**
+   * Resizes the table to at least twice the initial size provided. Does nothing with linear hashing.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -87,16 +148,74 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   size_t GetSize();
 
  private:
+  Page *FetchPage(page_id_t page_id);
+
+  // creates a header page and blocks for num_buckets slots, returned pinned
+  HashTableHeaderPage *NewHeaderPage(size_t num_buckets);
+
+  /**
+   * Visits the groups of slots on the probe sequence of a hash, pinning their block meanwhile.
+   * visit(block, page_id, offset, n) reads slots offset to offset + n - 1 of the block and returns true to
+   * end the probe, at the latest after a group with a never occupied slot. Otherwise the probe ends once it wrapped
+   * around. If first_page is given, it is the block of the first slot, pinned by the caller.
+   */
+  template <typename Visitor>
+  void Probe(HashTableHeaderPage *header, uint64_t hash, Visitor &&visit, Page *first_page = nullptr);
+
+  /**
+   * Linear hashing: like Probe, but for the bucket whose primary block is given, which the caller holds latched.
+   * @return the page id of the last block of the bucket if the probe went past it, INVALID_PAGE_ID otherwise
+   */
+  template <typename Visitor>
+  page_id_t ProbeBucket(Page *bucket_page, uint64_t hash, Visitor &&visit);
+
+  // appends the values of the key in a group to result, see Probe; pairs is scratch space for ReadGroup
+  bool ReadMatches(BlockPage *block, slot_offset_t offset, size_t n, const KeyType &key, uint8_t fingerprint,
+                   MappingType *pairs, std::vector<ValueType> *result);
+
+  // finds a pair on the probe sequence of its hash, see Probe
+  bool FindPair(HashTableHeaderPage *header, Page *bucket_page, uint64_t hash, const KeyType &key,
+                const ValueType &value, page_id_t *page_id, slot_offset_t *bucket_ind);
+
+  /**
+   * Inserts into the table of the header, with the key latch held, or with linear hashing into the bucket whose
+   * primary block is given, which the caller holds latched for writing.
+   * Sets *full if the table has no free slot.
+   */
+  bool InsertLocked(HashTableHeaderPage *header, Page *bucket_page, const KeyType &key, const ValueType &value,
+                    bool *full);
+
+  void ResizeLocked(size_t initial_size);
+
+  // linear hashing: the bucket of a hash while the table has num_blocks buckets
+  size_t BucketIndex(uint64_t hash, size_t num_blocks) const;
+
+  // linear hashing: returns the primary block of the bucket of the hash, pinned and latched
+  Page *LatchBucket(HashTableHeaderPage *header, uint64_t hash, bool exclusive);
+
+  // linear hashing: splits the next bucket if the table is too full and no other split is running
+  void SplitBucket();
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers are lookups, inserts and removes, writer is only resize
   ReaderWriterLatch table_latch_;
+  std::mutex key_latches_[HASH_TABLE_KEY_LATCHES];
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
+
+  HashTableGrowth growth_;
+  // linear hashing state, see above
+  double max_load_factor_;
+  size_t initial_blocks_;
+  std::atomic<size_t> num_blocks_;
+  std::atomic<size_t> num_pairs_{0};
+  // held while splitting
+  std::mutex split_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_kernel.h
+//
+// Identification: src/include/execution/aggregate_kernel.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hyper_log_log.h"
+#include "execution/plans/aggregation_plan.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * The running state of one aggregate of a group. Its fields are read according to the aggregate and the type of its
+ * input, so the state of every aggregate fits in the same fixed-size struct.
+ */
+struct AggregateState {
+  /** The number of rows for COUNT, and the number of non-NULL inputs for the other aggregates. */
+  int64_t count_{0};
+  /** The sum, minimum or maximum of the non-NULL numeric inputs so far. */
+  union {
+    int64_t int_;
+    double real_;
+  };
+  /** The index of the state kept in an AggregateStorage, for the aggregates whose state does not fit here. */
+  uint32_t slot_{0};
+
+  AggregateState() : int_(0) {}
+};
+
+/** The states of the aggregates of a hash table that do not fit in an AggregateState. */
+struct AggregateStorage {
+  /** The sketches of APPROX_COUNT_DISTINCT. */
+  std::vector<HyperLogLog> sketches_;
+  /** The minimums and maximums of inputs that are not numbers. */
+  std::vector<Value> values_;
+
+  void Clear() {
+    sketches_.clear();
+    values_.clear();
+  }
+};
+
+/**
+ * AggregateKernel is the set of functions that compute one aggregate over inputs of one type.
+ *
+ * The kernels of SUM, MIN, MAX and AVG over numbers are compiled for each input type, so that they read the raw input
+ * and accumulate it in an int64_t or a double, with no Type dispatch or Value arithmetic per row. MIN and MAX over
+ * other types compare Values. Integer sums that overflow throw an OUT_OF_RANGE exception, when the row is added or
+ * when the result does not fit in the input type.
+ *
+ * update_batch_ adds a batch of rows to the states of many groups in one call. It instantiates the loop for each
+ * kernel, so that the update of a row is inlined rather than called through a pointer.
+ */
+struct AggregateKernel {
+  /** Resets a state for a new group. */
+  void (*init_)(AggregateState *state, AggregateStorage *storage);
+  /** Adds an input row to a state. */
+  void (*update_)(AggregateState *state, AggregateStorage *storage, const Value &input);
+  /** Adds inputs[rows[i]] to states[groups[i]], for every i < rows.size(). */
+  void (*update_batch_)(AggregateState *states, const uint32_t *groups, const std::vector<Value> &inputs,
+                        const std::vector<uint32_t> &rows, AggregateStorage *storage);
+  /** Adds the rows of another state of the same aggregate to a state. */
+  void (*merge_)(AggregateState *state, AggregateStorage *storage, const AggregateState &partial,
+                 const AggregateStorage &partial_storage);
+  /** @return the value of the aggregate */
+  Value (*finalize_)(const AggregateState &state, const AggregateStorage &storage);
+
+  /**
+   * Picks the kernel of an aggregate, throws a MISMATCH_TYPE exception if the aggregate is not defined on the input.
+   * @param agg_type the aggregate
+   * @param input_type the type of the input of the aggregate
+   */
+  static AggregateKernel Make(AggregationType agg_type, TypeId input_type);
+};
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_exchange.h
+//
+// Identification: src/include/execution/batch_exchange.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <mutex>  // NOLINT
+
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * BatchExchange passes batches from the worker threads of a parallel operator to the thread consuming it. The queue is
+ * bounded, so that workers running ahead of the consumer block instead of buffering their whole output.
+ */
+class BatchExchange {
+ public:
+  /**
+   * Creates an exchange.
+   * @param capacity the number of batches the queue holds before producers block
+   * @param num_producers the number of producers, each of which must call ProducerDone() when it is done
+   */
+  BatchExchange(size_t capacity, size_t num_producers) : capacity_(capacity), num_producers_(num_producers) {}
+
+  /**
+   * Adds a batch, blocking while the queue is full.
+   * @return false if the exchange was closed, in which case the producer should stop
+   */
+  bool Push(TupleBatch &&batch);
+
+  /** Records that a producer is done, with the exception that stopped it if any. */
+  void ProducerDone(std::exception_ptr error = nullptr);
+
+  /**
+   * Takes the next batch, blocking while the queue is empty. Rethrows the exception of a failed producer.
+   * @return false once all the producers are done and the queue is empty
+   */
+  bool Pop(TupleBatch *batch);
+
+  /** Drops the queued batches and makes the producers stop. */
+  void Close();
+
+ private:
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<TupleBatch> batches_;
+  size_t capacity_;
+  size_t num_producers_;
+  bool closed_{false};
+  std::exception_ptr error_;
+};
+
+}  // namespace bustub
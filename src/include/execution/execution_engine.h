@@ -20,6 +20,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 class ExecutionEngine {
@@ -53,6 +54,31 @@ class ExecutionEngine {
     return true;
   }
 
+  /**
+   * Executes a plan with the vectorized model, pulling batches of tuples from the root executor instead of tuples.
+   * The arguments are the same as for Execute().
+   * @return false if an executor threw, in which case result_set holds only the tuples produced before the failure
+   */
+  bool ExecuteVectorized(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
+                         ExecutorContext *exec_ctx) {
+    auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+    executor->Init();
+    try {
+      const Schema *schema = executor->GetOutputSchema();
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        if (result_set != nullptr) {
+          for (uint32_t row : batch.GetSelection()) {
+            result_set->push_back(batch.GetTuple(row, schema));
+          }
+        }
+      }
+    } catch (const Exception &) {
+      return false;
+    }
+    return true;
+  }
+
  private:
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] TransactionManager *txn_mgr_;
@@ -60,12 +60,26 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** @return the number of bytes of intermediate results an executor may hold before it spills them to disk */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  /** Sets the number of bytes of intermediate results an executor may hold before it spills them to disk. */
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /** @return the number of worker threads an executor may use */
+  size_t GetNumThreads() const { return num_threads_; }
+
+  /** Sets the number of worker threads an executor may use. */
+  void SetNumThreads(size_t num_threads) { num_threads_ = num_threads; }
+
  private:
   Transaction *transaction_;
   Catalog *catalog_;
   BufferPoolManager *bpm_;
   TransactionManager *txn_mgr_;
   LockManager *lock_mgr_;
+  size_t memory_budget_{EXECUTION_MEMORY_BUDGET};
+  size_t num_threads_{EXECUTION_NUM_THREADS};
 };
 
 }  // namespace bustub
@@ -13,11 +13,14 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano tuple-at-a-time iterator model, and the vectorized model on top of it, in
+ * which each call produces a batch of up to EXECUTION_BATCH_SIZE tuples. A query is executed in one of the two models:
+ * once Init() is called, tuples are pulled either through Next() or through NextBatch(), never both.
  */
 class AbstractExecutor {
  public:
@@ -44,6 +47,26 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor. The default implementation fills the batch through Next(),
+   * executors override it to process whole batches at a time.
+   * @param[out] batch receives the tuples, with one column per column of the output schema
+   * @return true if at least one row of the batch is selected, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    const Schema *schema = GetOutputSchema();
+    batch->Reset(schema->GetColumnCount());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      uint32_t row = batch->AppendRow(rid);
+      for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+        batch->SetValue(row, i, tuple.GetValue(schema, i));
+      }
+    }
+    return batch->GetNumSelected() > 0;
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -19,16 +19,23 @@
 
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
+#include "execution/aggregate_kernel.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/executors/seq_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 /**
  * A simplified hash table that has all the necessary functionality for aggregations.
+ *
+ * Each group maps to a run of AggregateStates, one per aggregate, in a flat array. The states are updated by the
+ * AggregateKernels picked for the types of the aggregate expressions when the table is created, and the aggregates
+ * are only turned into Values when the groups are read.
  */
 class SimpleAggregationHashTable {
  public:
@@ -38,56 +45,20 @@ class SimpleAggregationHashTable {
    * @param agg_types the types of aggregations
    */
   SimpleAggregationHashTable(const std::vector<const AbstractExpression *> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-  /** @return the initial aggregrate value for this aggregation executor */
-  AggregateValue GenerateInitialAggregateValue() {
-    std::vector<Value> values;
-    for (const auto &agg_type : agg_types_) {
-      switch (agg_type) {
-        case AggregationType::CountAggregate:
-          // Count starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::MinAggregate:
-          // Min starts at INT_MAX.
-          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
-          break;
-        case AggregationType::MaxAggregate:
-          // Max starts at INT_MIN.
-          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MIN));
-          break;
+                             const std::vector<AggregationType> &agg_types) {
+    for (uint32_t i = 0; i < agg_exprs.size(); i++) {
+      kernels_.push_back(AggregateKernel::Make(agg_types[i], agg_exprs[i]->GetReturnType()));
+      if (agg_types[i] == AggregationType::ApproxCountDistinctAggregate) {
+        num_sketches_++;
       }
     }
-    return {values};
   }
 
-  /** Combines the input into the aggregation result. */
-  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountAggregate:
-          // Count increases by one.
-          result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum increases by addition.
-          result->aggregates_[i] = result->aggregates_[i].Add(input.aggregates_[i]);
-          break;
-        case AggregationType::MinAggregate:
-          // Min is just the min.
-          result->aggregates_[i] = result->aggregates_[i].Min(input.aggregates_[i]);
-          break;
-        case AggregationType::MaxAggregate:
-          // Max is just the max.
-          result->aggregates_[i] = result->aggregates_[i].Max(input.aggregates_[i]);
-          break;
-      }
+  /** Combines the input into the aggregation result of a group. */
+  void CombineAggregateValues(uint32_t group, const AggregateValue &input) {
+    AggregateState *states = &states_[group * kernels_.size()];
+    for (uint32_t i = 0; i < kernels_.size(); i++) {
+      kernels_[i].update_(&states[i], &storage_, input.aggregates_[i]);
     }
   }
 
@@ -97,10 +68,58 @@ class SimpleAggregationHashTable {
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht.count(agg_key) == 0) {
-      ht.insert({agg_key, GenerateInitialAggregateValue()});
+    CombineAggregateValues(FindOrInsert(agg_key), agg_val);
+  }
+
+  /**
+   * Combines a value into the aggregation of its group, if the group is in the hash table.
+   * @param agg_key the key of the group
+   * @param agg_val the value to be combined
+   * @return false if the group is not in the hash table
+   */
+  bool Combine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      return false;
     }
-    CombineAggregateValues(&ht[agg_key], agg_val);
+    CombineAggregateValues(iter->second, agg_val);
+    return true;
+  }
+
+  /** Merges the groups of another table of the same aggregations into this one, and clears the other table. */
+  void Merge(SimpleAggregationHashTable *other) {
+    size_t num_aggs = kernels_.size();
+    for (const auto &[key, other_group] : other->ht) {
+      uint32_t group = FindOrInsert(key);
+      for (uint32_t i = 0; i < num_aggs; i++) {
+        kernels_[i].merge_(&states_[group * num_aggs + i], &storage_, other->states_[other_group * num_aggs + i],
+                           other->storage_);
+      }
+    }
+    other->Clear();
+  }
+
+  /** @return the aggregates of a group */
+  AggregateValue GetAggregateValue(uint32_t group) const {
+    std::vector<Value> values;
+    values.reserve(kernels_.size());
+    for (uint32_t i = 0; i < kernels_.size(); i++) {
+      values.push_back(kernels_[i].finalize_(states_[group * kernels_.size() + i], storage_));
+    }
+    return {values};
+  }
+
+  /** @return an estimate of the bytes that a new group with the given key takes */
+  size_t GroupBytes(const AggregateKey &agg_key) const {
+    // the node of the map holds the key, the group, the hash and a link, and the bucket array a pointer per group
+    size_t num_bytes = sizeof(AggregateKey) + 4 * sizeof(void *) + agg_key.group_bys_.size() * sizeof(Value) +
+                       kernels_.size() * sizeof(AggregateState);
+    for (const auto &value : agg_key.group_bys_) {
+      if (value.GetTypeId() == TypeId::VARCHAR && !value.IsNull()) {
+        num_bytes += value.GetLength();
+      }
+    }
+    return num_bytes + num_sketches_ * sizeof(HyperLogLog);
   }
 
   /**
@@ -109,13 +128,14 @@ class SimpleAggregationHashTable {
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_(iter) {}
+    Iterator(const SimpleAggregationHashTable *table, std::unordered_map<AggregateKey, uint32_t>::const_iterator iter)
+        : table_(table), iter_(iter) {}
 
     /** @return the key of the iterator */
     const AggregateKey &Key() { return iter_->first; }
 
     /** @return the value of the iterator */
-    const AggregateValue &Val() { return iter_->second; }
+    AggregateValue Val() { return table_->GetAggregateValue(iter_->second); }
 
     /** @return the iterator before it is incremented */
     Iterator &operator++() {
@@ -130,30 +150,86 @@ class SimpleAggregationHashTable {
     bool operator!=(const Iterator &other) { return this->iter_ != other.iter_; }
 
    private:
+    const SimpleAggregationHashTable *table_;
     /** Aggregates map. */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    std::unordered_map<AggregateKey, uint32_t>::const_iterator iter_;
   };
 
+  /** Removes all the groups. */
+  void Clear() {
+    ht.clear();
+    states_.clear();
+    storage_.Clear();
+  }
+
+  /** @return the number of groups */
+  size_t Size() const { return ht.size(); }
+
+  /** @return the kernels of the aggregates */
+  const std::vector<AggregateKernel> &GetKernels() const { return kernels_; }
+
+  /** Exchanges the groups of two tables of the same aggregations. */
+  void Swap(SimpleAggregationHashTable *other) {
+    ht.swap(other->ht);
+    states_.swap(other->states_);
+    std::swap(storage_, other->storage_);
+  }
+
   /** @return iterator to the start of the hash table */
-  Iterator Begin() { return Iterator{ht.cbegin()}; }
+  Iterator Begin() { return Iterator{this, ht.cbegin()}; }
 
   /** @return iterator to the end of the hash table */
-  Iterator End() { return Iterator{ht.cend()}; }
+  Iterator End() { return Iterator{this, ht.cend()}; }
 
  private:
-  /** The hash table is just a map from aggregate keys to aggregate values. */
-  std::unordered_map<AggregateKey, AggregateValue> ht{};
-  /** The aggregate expressions that we have. */
-  const std::vector<const AbstractExpression *> &agg_exprs_;
-  /** The types of aggregations that we have. */
-  const std::vector<AggregationType> &agg_types_;
+  /** @return the group of a key, which is added with initial aggregates if it is new */
+  uint32_t FindOrInsert(const AggregateKey &agg_key) {
+    auto [iter, inserted] = ht.try_emplace(agg_key, static_cast<uint32_t>(ht.size()));
+    if (inserted) {
+      states_.resize(states_.size() + kernels_.size());
+      AggregateState *states = &states_[iter->second * kernels_.size()];
+      for (uint32_t i = 0; i < kernels_.size(); i++) {
+        kernels_[i].init_(&states[i], &storage_);
+      }
+    }
+    return iter->second;
+  }
+
+  /** The hash table maps aggregate keys to the numbers of their groups. */
+  std::unordered_map<AggregateKey, uint32_t> ht{};
+  /** The kernels of the aggregates that we have. */
+  std::vector<AggregateKernel> kernels_;
+  /** The states of the aggregates of group i, at i * kernels_.size(). */
+  std::vector<AggregateState> states_;
+  /** The states that do not fit in an AggregateState. */
+  AggregateStorage storage_;
+  /** The number of APPROX_COUNT_DISTINCT aggregates, which keep a sketch per group. */
+  size_t num_sketches_{0};
 };
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX) on the tuples of a child executor.
+ *
+ * The child is consumed on the first call to Next() or NextBatch(), through the same interface. NextBatch() evaluates
+ * the group by and aggregate expressions a batch at a time before combining the rows into the hash table.
+ *
+ * When the only group by is a column of the scanned table whose statistics give a range of at most MAX_DENSE_GROUPS
+ * integers, a serial aggregation keeps the groups in that range in arrays indexed by the value minus the minimum of
+ * the range, one array of states per aggregate, instead of hashing the key of every row. NextBatch() updates each
+ * array for the whole batch at once. The statistics may be stale, so the rows whose key is NULL or out of the range
+ * still go to the hash table, and their groups are produced after the dense ones.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
+  /** The number of partitions of the groups of a parallel aggregation. */
+  static constexpr size_t NUM_PARTITIONS = 16;
+  /** The number of rows after which a thread checks whether pre-aggregation pays off. */
+  static constexpr size_t PREAGGREGATION_SAMPLE_ROWS = 2 * EXECUTION_BATCH_SIZE;
+  /** The number of partitions that the rows of new groups are spilled to. */
+  static constexpr size_t NUM_SPILL_PARTITIONS = 8;
+  /** The largest range of group by values that is aggregated in arrays. */
+  static constexpr size_t MAX_DENSE_GROUPS = 1024;
+
   /**
    * Creates a new aggregation executor.
    * @param exec_ctx the context that the aggregation should be performed in
@@ -172,6 +248,8 @@ class AggregationExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -190,14 +268,109 @@ class AggregationExecutor : public AbstractExecutor {
     return {vals};
   }
 
+  /** @return true if the aggregation runs on the threads of a parallel scan, valid after Init() */
+  bool IsParallel() const;
+
+  /** @return true if a thread of a parallel aggregation stopped pre-aggregating, valid after Next() */
+  bool SkippedPreAggregation() const { return skipped_pre_aggregation_; }
+
+  /** @return what the aggregation spilled to disk since Init() */
+  const SpillStats &GetSpillStats() const { return spill_stats_; }
+
+  /** @return true if the groups in the range of the statistics are aggregated in arrays, valid after Init() */
+  bool IsDense() const { return !dense_seen_.empty(); }
+
  private:
+  /** The spilled rows of some groups, yet to be aggregated. */
+  struct SpilledPartition {
+    std::unique_ptr<TmpTupleRun> run_;
+    /** The number of times the rows were partitioned. */
+    size_t level_{0};
+  };
+  /** What a thread of a parallel aggregation hands over to the merge. */
+  struct LocalAggregation {
+    /** The groups that the thread pre-aggregated, in a table per partition. */
+    std::vector<SimpleAggregationHashTable> tables_;
+    /** The rows that the thread passed on as they are, per partition. */
+    std::vector<std::vector<std::pair<AggregateKey, AggregateValue>>> rows_;
+    bool pre_aggregate_{true};
+  };
+
+  /** Sets up the arrays of a dense aggregation, if the plan and the statistics of the scanned table allow it. */
+  void InitDense();
+
+  /**
+   * Finds the slot of a group by value in the arrays of a dense aggregation.
+   * @return false if the aggregation is not dense, or the value is NULL or out of the range of the arrays
+   */
+  bool DenseSlot(const Value &key, uint32_t *slot) const;
+
+  /** Aggregates the child on the threads of its scan into partitions_. */
+  void AggregateParallel();
+
+  /** Pre-aggregates the morsels that one thread claims from the scan. */
+  void PreAggregate(SeqScanExecutor *scan, LocalAggregation *local);
+
+  /** Merges what the threads handed over for one partition into partitions_. */
+  void MergePartition(size_t partition, std::vector<LocalAggregation> *locals);
+
+  /** Aggregates a row into aht_, or spills it if its group is new and aht_ is full. */
+  void AddRow(const AggregateKey &key, const AggregateValue &val);
+
+  /** Finishes writing the spilled rows of the current pass and queues the non-empty partitions. */
+  void FinishSpilling();
+
+  /**
+   * Aggregates the next spilled partition into aht_, spilling the rows of the groups that do not fit again.
+   * @return false once all the partitions were aggregated
+   */
+  bool NextSpilledPartition();
+
+  /**
+   * Advances to the next group that satisfies the having clause.
+   * @param[out] key the group by values of the group
+   * @param[out] val the aggregates of the group
+   * @return false once all the groups are produced
+   */
+  bool NextGroup(const AggregateKey **key, const AggregateValue **val);
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
   std::unique_ptr<AbstractExecutor> child_;
   /** Simple aggregation hash table. */
-  // Uncomment me! SimpleAggregationHashTable aht_;
+  SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator. */
-  // Uncomment me! SimpleAggregationHashTable::Iterator aht_iterator_;
+  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The aggregates of the group produced last. */
+  AggregateValue group_val_;
+  /** Whether the child has been consumed into the hash table. */
+  bool aggregated_{false};
+  /** The merged partitions of a parallel aggregation, moved to aht_ one at a time, and the next one to move. */
+  std::vector<SimpleAggregationHashTable> partitions_;
+  size_t partition_idx_{0};
+  bool skipped_pre_aggregation_{false};
+
+  /** The type and the smallest value of the group by of a dense aggregation. */
+  TypeId dense_type_{TypeId::INVALID};
+  int64_t dense_min_{0};
+  /** The states of aggregate i of the group in slot j, at dense_states_[i][j]. */
+  std::vector<std::vector<AggregateState>> dense_states_;
+  AggregateStorage dense_storage_;
+  /** Whether the group in each slot has a row, empty unless the aggregation is dense. */
+  std::vector<uint8_t> dense_seen_;
+  /** The next slot to produce, and the key of the dense group produced last. */
+  size_t dense_pos_{0};
+  AggregateKey dense_key_;
+
+  /** The layout of a spilled row: its group by values followed by its aggregate values. */
+  std::unique_ptr<Schema> spill_schema_;
+  /** The estimated size of the groups in aht_, and the level of the rows being aggregated. */
+  size_t num_bytes_{0};
+  size_t level_{0};
+  /** The partitions that the rows of new groups are spilled to, once aht_ is full. */
+  std::vector<std::unique_ptr<TmpTupleRun>> spill_runs_;
+  std::vector<SpilledPartition> spilled_partitions_;
+  SpillStats spill_stats_;
 };
 }  // namespace bustub
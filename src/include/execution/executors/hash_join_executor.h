@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * An open addressing hash table from hashes of join keys to the rows of the build side of a hash join.
+ *
+ * Each slot packs the high half of a hash with a row number into 8 bytes, so that a probe reads consecutive slots of a
+ * flat array. Rows with the same key take one slot each, and the table never holds the keys themselves: a lookup
+ * returns every row whose tag matches, and the caller compares the keys.
+ */
+class JoinHashTable {
+ public:
+  /** Removes all the rows and sizes the table for num_rows rows at a load factor of at most 1/2. */
+  void Reset(size_t num_rows) {
+    size_t capacity = 16;
+    while (capacity < 2 * num_rows) {
+      capacity *= 2;
+    }
+    slots_.assign(capacity, Slot{0, 0});
+    mask_ = capacity - 1;
+  }
+
+  /** Adds a row with the given key hash. At most as many rows as given to Reset() may be inserted. */
+  void Insert(hash_t hash, uint32_t row) {
+    size_t idx = hash & mask_;
+    while (slots_[idx].row_ != 0) {
+      idx = (idx + 1) & mask_;
+    }
+    slots_[idx] = Slot{Tag(hash), row + 1};
+  }
+
+  /** Appends the rows whose key hash may be equal to hash. */
+  void Find(hash_t hash, std::vector<uint32_t> *rows) const {
+    uint32_t tag = Tag(hash);
+    for (size_t idx = hash & mask_; slots_[idx].row_ != 0; idx = (idx + 1) & mask_) {
+      if (slots_[idx].tag_ == tag) {
+        rows->push_back(slots_[idx].row_ - 1);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    uint32_t tag_;
+    /** The row number plus one, zero for an empty slot. */
+    uint32_t row_;
+  };
+
+  static uint32_t Tag(hash_t hash) { return static_cast<uint32_t>(hash >> 32); }
+
+  std::vector<Slot> slots_;
+  size_t mask_{0};
+};
+
+/**
+ * HashJoinExecutor joins two children by building a JoinHashTable on the join keys of one of them and probing it with
+ * the tuples of the other.
+ *
+ * The build side is the smaller child, found by reading both children in lockstep until one of them ends. The tuples
+ * read so far from the larger child are probed first, and the rest of it is then streamed through the table. Tuples
+ * with a NULL join key never match.
+ *
+ * If the tuples read in lockstep outgrow the memory budget of the executor context, the join turns into a Grace hash
+ * join: both children are hash partitioned on their join keys into TmpTupleRuns, and the pairs of partitions are then
+ * joined one at a time, each building on its smaller side. A partition whose build side still does not fit in memory
+ * is partitioned again with a different hash, up to MAX_PARTITION_LEVEL times; past that (e.g. when one key value
+ * alone exceeds the budget), its build side is loaded in chunks that fit in memory, and its probe side is read once
+ * per chunk.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /** The number of partitions that a run is split into. */
+  static constexpr size_t NUM_PARTITIONS = 8;
+  /** The deepest level of repartitioning. */
+  static constexpr size_t MAX_PARTITION_LEVEL = 3;
+
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuples for the left side of the join
+   * @param right_executor the child executor that produces tuples for the right side of the join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return true if the hash table is built on the left child (of the current partition), valid after Next() */
+  bool IsBuildLeft() const { return build_left_; }
+
+  /** @return what the join spilled to disk since Init() */
+  const SpillStats &GetSpillStats() const { return spill_stats_; }
+
+ private:
+  /** A pair of partitions of the children, spilled to disk. */
+  struct Partition {
+    std::unique_ptr<TmpTupleRun> left_;
+    std::unique_ptr<TmpTupleRun> right_;
+    /** The number of times the tuples were partitioned. */
+    size_t level_{0};
+  };
+
+  /** Reads the children until the smaller one ends and builds the hash table on it, or spills them both. */
+  void Build();
+
+  /** Moves the tuples with non-NULL join keys to build_tuples_, and builds the hash table on them. */
+  void BuildTable(std::vector<Tuple> *tuples);
+
+  /**
+   * Evaluates the join keys of a tuple.
+   * @return false if one of the keys is NULL
+   */
+  bool MakeKey(const Tuple &tuple, bool left, std::vector<Value> *key, hash_t *hash);
+
+  /** Reads the next probe tuple and finds its matches, @return false once the probe side ends */
+  bool NextProbeTuple();
+
+  /** @return NUM_PARTITIONS empty partitions at the given level */
+  std::vector<Partition> MakePartitions(size_t level);
+
+  /** Appends a tuple of one side to the partition of its join key, unless the key is NULL. */
+  void AddToPartition(const Tuple &tuple, bool left, std::vector<Partition> *partitions);
+
+  /** Finishes writing new partitions and queues the non-empty ones to be joined. */
+  void QueuePartitions(std::vector<Partition> *partitions);
+
+  /** Partitions both children after reading left_tuples and right_tuples from them. */
+  void Spill(std::vector<Tuple> *left_tuples, std::vector<Tuple> *right_tuples);
+
+  /** Partitions the current partition again, with the hash of the next level. */
+  void Repartition();
+
+  /**
+   * Builds the hash table on the next chunk of build tuples of the current partition, moving on to the next
+   * partition when the current one is done.
+   * @return false once all the partitions were joined
+   */
+  bool NextChunk();
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  bool built_{false};
+  bool build_left_{false};
+
+  /** The build tuples, their join keys (one after the other) and the table on the keys. */
+  std::vector<Tuple> build_tuples_;
+  std::vector<Value> build_keys_;
+  JoinHashTable table_;
+
+  /** Probe tuples read while looking for the smaller child, probed before the rest of the probe child. */
+  std::vector<Tuple> buffered_probe_tuples_;
+  size_t buffered_probe_pos_{0};
+  /** The current probe tuple and the build rows that match it. */
+  Tuple probe_tuple_;
+  std::vector<uint32_t> matches_;
+  size_t match_pos_{0};
+  std::vector<Value> probe_key_;
+
+  /** True once the children were partitioned. */
+  bool spilled_{false};
+  /** The partitions yet to be joined, and the partition being joined. */
+  std::vector<Partition> partitions_;
+  Partition partition_;
+  /** Read the build and probe sides of the partition being joined; they must go before the partition. */
+  std::unique_ptr<TmpTupleRun::Reader> build_reader_;
+  std::unique_ptr<TmpTupleRun::Reader> probe_reader_;
+  SpillStats spill_stats_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include "common/rid.h"
@@ -24,8 +26,14 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * Tuples are produced in index key order. When the predicate and the output columns only refer to columns stored in
+ * the index (key columns and the included columns of a covering index), the scan is answered from the index entries
+ * alone and the table heap is never touched. Otherwise every entry costs a lookup of its RID in the table heap.
+ *
+ * When the predicate compares the first key column with a constant, the scan seeks to the first entry that can
+ * satisfy it and stops after the last one, instead of reading the whole index.
  */
-
 class IndexScanExecutor : public AbstractExecutor {
  public:
   /**
@@ -41,8 +49,55 @@ class IndexScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** @return true if the scan is answered from the index without fetching table tuples, valid after Init() */
+  bool IsIndexOnly() const { return index_only_; }
+
+  /** @return the number of index entries read since Init() */
+  size_t GetNumEntriesRead() const { return num_entries_read_; }
+
+  /** The values of the first key column that the scan is restricted to, where an unset bound is open. */
+  struct KeyRange {
+    std::optional<Value> lower_;
+    std::optional<Value> upper_;
+    /** Whether entries equal to upper_ are in the range; lower_ is always inclusive. */
+    bool upper_inclusive_{true};
+  };
+
+  /** Walks the entries of an index in key order, whatever the key size of the index is. */
+  class IndexCursor {
+   public:
+    virtual ~IndexCursor() = default;
+    /**
+     * Advances to the next entry.
+     * @param[out] rid the RID of the entry
+     * @param[out] index_tuple if not null, receives the index tuple of the entry (key and included columns)
+     * @return false once the index is exhausted
+     */
+    virtual bool Next(RID *rid, Tuple *index_tuple) = 0;
+  };
+
  private:
+  /**
+   * Rewrites an expression over the table schema into one over the index tuple schema.
+   * @return the rewritten expression, or nullptr if it refers to a column that is not stored in the index
+   */
+  const AbstractExpression *RemapToIndexTuple(const AbstractExpression *expr);
+
+  /** @return the range of the first key column outside of which no entry satisfies the predicate */
+  KeyRange RangeOfPredicate() const;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The scanned index and the table it belongs to. */
+  IndexInfo *index_info_{nullptr};
+  TableMetadata *table_info_{nullptr};
+  std::unique_ptr<IndexCursor> cursor_;
+  size_t num_entries_read_{0};
+  /** Whether the scan is served from the index alone. */
+  bool index_only_{false};
+  /** Predicate and output expressions rewritten to the index tuple schema, only set for index-only scans. */
+  const AbstractExpression *index_predicate_{nullptr};
+  std::vector<const AbstractExpression *> index_output_exprs_;
+  std::vector<std::unique_ptr<AbstractExpression>> remapped_exprs_;
 };
 }  // namespace bustub
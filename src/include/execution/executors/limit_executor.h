@@ -44,5 +44,8 @@ class LimitExecutor : public AbstractExecutor {
   const LimitPlanNode *plan_;
   /** The child executor to obtain value from. */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The number of tuples returned so far. */
+  size_t num_returned_{0};
+  bool offset_skipped_{false};
 };
 }  // namespace bustub
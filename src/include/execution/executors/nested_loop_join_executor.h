@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -24,6 +25,10 @@ namespace bustub {
 /**
  * NestedLoopJoinExecutor joins two tables using nested loop.
  * The child executor can either be a sequential scan
+ *
+ * The right side is read once, on the first call to Next() or NextBatch(), and kept in memory for every left tuple.
+ * NextBatch() pairs the rows of a left batch with the right rows a batch of pairs at a time, and evaluates the join
+ * predicate and the output columns over the pairs as a whole.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -45,8 +50,36 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
+  /** Fills pair_left_ and pair_right_ with the next pairs of left and right rows, for the left batch in left_batch_. */
+  void GatherPairs();
+
   /** The NestedLoop plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** Whether the right side has been read. */
+  bool right_loaded_{false};
+
+  /** Tuple-at-a-time state: the right tuples, the current left tuple and the next right tuple to pair it with. */
+  std::vector<Tuple> right_tuples_;
+  Tuple left_tuple_;
+  bool has_left_tuple_{false};
+  size_t right_pos_{0};
+
+  /** Vectorized state: the right batches and the position of each selected right row in them. */
+  std::vector<TupleBatch> right_batches_;
+  std::vector<std::pair<uint32_t, uint32_t>> right_rows_;
+  /** The current left batch and the next selected left row in it to pair up. */
+  TupleBatch left_batch_;
+  bool has_left_batch_{false};
+  uint32_t left_pos_{0};
+  /** The pairs being joined: row i of pair_left_ goes with row i of pair_right_. */
+  TupleBatch pair_left_;
+  TupleBatch pair_right_;
+  std::vector<Value> predicate_values_;
+  std::vector<Value> output_values_;
 };
 }  // namespace bustub
@@ -12,20 +12,68 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
+#include "execution/batch_exchange.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * SeqScanExecutor executes a sequential scan over a table.
+ * MorselDispenser hands out morsels, runs of up to MORSEL_PAGES consecutive pages of a table heap, to the threads of a
+ * parallel scan. The pages of a table heap form a linked list, so the dispenser follows it one morsel ahead of the
+ * threads, and the pages it reads are usually still in the buffer pool when a thread scans them.
+ */
+class MorselDispenser {
+ public:
+  /** The number of pages of a morsel. */
+  static constexpr size_t MORSEL_PAGES = 16;
+
+  MorselDispenser(BufferPoolManager *bpm, page_id_t first_page_id) : bpm_(bpm), next_page_id_(first_page_id) {}
+
+  /** Claims the next morsel, @return false once the table is exhausted */
+  bool Next(std::vector<page_id_t> *morsel);
+
+ private:
+  std::mutex latch_;
+  BufferPoolManager *bpm_;
+  page_id_t next_page_id_;
+};
+
+/**
+ * SeqScanExecutor executes a sequential scan over a table, filtering it by the plan's predicate and projecting it onto
+ * the output schema.
+ *
+ * NextBatch() reads the table a page at a time, and only decodes the columns that the predicate or the output schema
+ * refer to. The predicate is evaluated for the whole batch and only narrows the batch's selection, and the projection
+ * is then computed for the selected rows alone.
+ *
+ * If the executor context allows more than one thread, the scan is morsel-driven: worker threads claim morsels from a
+ * MorselDispenser, filter and project them on their own, and pass their batches to Next() and NextBatch() through a
+ * BatchExchange, so the tuples are no longer in table order. A parent that runs its own worker threads can instead
+ * have each of them call NextParallelBatch(), keeping the whole pipeline on the thread. Scans stay serial when
+ * logging is enabled, as the transaction's lock sets are not thread-safe.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
+  /** The state of a thread of a parallel scan. */
+  struct ScanWorker {
+    /** The pages of the thread's morsel, and the position of the next tuple to read in them. */
+    std::vector<page_id_t> morsel_;
+    size_t page_idx_{0};
+    RID next_rid_;
+    TupleBatch scan_batch_;
+    std::vector<Value> predicate_values_;
+    std::vector<Value> output_values_;
+  };
+
   /**
    * Creates a new sequential scan executor.
    * @param exec_ctx the executor context
@@ -33,14 +81,70 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  ~SeqScanExecutor() override;
+
   void Init() override;
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
+  /**
+   * Fills batch with the next rows of the morsels that a thread claims. Threads may call it concurrently, each with
+   * its own worker, but not along with Next() or NextBatch().
+   * @return false once the table is exhausted
+   */
+  bool NextParallelBatch(ScanWorker *worker, TupleBatch *batch);
+
+  /** @return true if Next() and NextBatch() gather the batches of worker threads, valid after Init() */
+  bool IsParallel() const { return parallel_; }
+
  private:
+  /** Reads the tuples from next_rid_ on into scan_batch_, until the batch is full or the table ends. */
+  void ScanPages();
+
+  /**
+   * Reads the tuples of a page from *rid on into scan_batch, until the batch is full or the page ends.
+   * @return true if the page ended, with the id of the next page of the table in next_page_id
+   */
+  bool ScanPage(RID *rid, TupleBatch *scan_batch, page_id_t *next_page_id);
+
+  /** Filters scan_batch and projects its selected rows into batch, @return false if no row was selected */
+  bool FilterAndProject(TupleBatch *scan_batch, std::vector<Value> *predicate_values, std::vector<Value> *output_values,
+                        TupleBatch *batch);
+
+  /** Starts the threads feeding exchange_. */
+  void StartWorkers();
+
+  /** Stops the threads feeding exchange_ and waits for them. */
+  void StopWorkers();
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
+  /** The scanned table. */
+  TableMetadata *table_info_{nullptr};
+  /** Position of the tuple-at-a-time scan. */
+  std::unique_ptr<TableIterator> iterator_;
+  /** Position of the vectorized scan: the next tuple to read, or an invalid RID at the end of the table. */
+  RID next_rid_;
+  /** The table columns that the predicate or the output schema refer to. */
+  std::vector<uint32_t> scanned_columns_;
+  /** Batch of table tuples, and the value of the predicate for each of them. */
+  TupleBatch scan_batch_;
+  std::vector<Value> predicate_values_;
+  std::vector<Value> output_values_;
+
+  /** The morsels of a parallel scan. */
+  std::unique_ptr<MorselDispenser> dispenser_;
+  bool parallel_{false};
+  /** The threads of a parallel scan, and the exchange that gathers their batches. */
+  std::unique_ptr<BatchExchange> exchange_;
+  std::vector<std::thread> workers_;
+  /** The batch gathered last, and the position of the next selected row returned by Next(). */
+  TupleBatch gathered_batch_;
+  size_t gathered_pos_{0};
 };
+
 }  // namespace bustub
@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * A loser tree (tournament tree) that merges num_sources sorted sources. Each internal node keeps the loser of the
+ * match played there, so replacing the winner replays only the matches on the path from its leaf to the root, i.e.
+ * log2(num_sources) comparisons per merged element.
+ *
+ * less(a, b) tells whether the current element of source a comes before the one of source b. Sources with equal
+ * elements are taken in the order of their numbers.
+ */
+template <typename Less>
+class LoserTree {
+ public:
+  LoserTree(size_t num_sources, Less less)
+      : less_(std::move(less)), num_sources_(num_sources), nodes_(num_sources), exhausted_(num_sources) {}
+
+  /** Plays the first tournament. exhausted[i] is true if source i is empty. */
+  void Build(std::vector<bool> exhausted) {
+    exhausted_ = std::move(exhausted);
+    // leaf i is node num_sources + i, and the children of node i are nodes 2i and 2i + 1
+    std::vector<size_t> winners(2 * num_sources_);
+    for (size_t i = 0; i < num_sources_; i++) {
+      winners[num_sources_ + i] = i;
+    }
+    for (size_t node = num_sources_ - 1; node > 0; node--) {
+      size_t left = winners[2 * node];
+      size_t right = winners[2 * node + 1];
+      bool left_wins = Beats(left, right);
+      winners[node] = left_wins ? left : right;
+      nodes_[node] = left_wins ? right : left;
+    }
+    nodes_[0] = winners[1];
+  }
+
+  /** @return the source with the first element, or num_sources once all of them are exhausted */
+  size_t Top() const { return exhausted_[nodes_[0]] ? num_sources_ : nodes_[0]; }
+
+  /** Replays the matches of the top source after it moved to its next element, or ran out of them if exhausted. */
+  void Pop(bool exhausted) {
+    size_t winner = nodes_[0];
+    exhausted_[winner] = exhausted;
+    for (size_t node = (num_sources_ + winner) / 2; node > 0; node /= 2) {
+      if (Beats(nodes_[node], winner)) {
+        std::swap(nodes_[node], winner);
+      }
+    }
+    nodes_[0] = winner;
+  }
+
+ private:
+  bool Beats(size_t a, size_t b) const {
+    if (exhausted_[a] || exhausted_[b]) {
+      return !exhausted_[a];
+    }
+    if (less_(a, b)) {
+      return true;
+    }
+    return !less_(b, a) && a < b;
+  }
+
+  Less less_;
+  size_t num_sources_;
+  /** The winner of the tournament, then the loser of the match at each internal node. */
+  std::vector<size_t> nodes_;
+  std::vector<bool> exhausted_;
+};
+
+/**
+ * SortExecutor sorts the tuples of its child with an external merge sort.
+ *
+ * The tuples are sorted in memory on a normalized key prefix: a 64-bit integer computed from the first key, whose
+ * unsigned order agrees with the order of the keys, so that most comparisons never look at the keys themselves.
+ * When the child's tuples outgrow the memory budget of the executor context, they are cut into runs that are sorted
+ * and spilled to TmpTupleRuns, on up to GetNumThreads() worker threads, and the runs are then merged with a
+ * LoserTree. If there are more runs than the buffer pool can read at once, they are first merged into longer runs.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /** The largest number of runs merged at once. */
+  static constexpr size_t MAX_MERGE_FAN_IN = 64;
+
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child the child executor to obtain tuples from
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return what the sort spilled to disk since Init() */
+  const SpillStats &GetSpillStats() const { return spill_stats_; }
+
+  /**
+   * @return a 64-bit integer whose unsigned order agrees with the order of the values in the given direction: a
+   * lower prefix means a lower value, and equal prefixes may belong to different values
+   */
+  static uint64_t NormalizedPrefix(const Value &value, OrderByType order_by_type);
+
+  /** @return true if equal normalized prefixes of the first key imply equal keys */
+  static bool IsPrefixExact(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys);
+
+  /** @return a negative number, zero or a positive number if keys a come before, with or after keys b */
+  static int CompareKeys(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys,
+                         const Value *a, const Value *b);
+
+ private:
+  /** A tuple of a SortBuffer, identified by its row, with the normalized prefix of its keys. */
+  struct SortEntry {
+    uint64_t prefix_;
+    uint32_t row_;
+  };
+
+  /** Tuples to be sorted in memory, their keys (one after the other) and their sorted entries. */
+  struct SortBuffer {
+    std::vector<Tuple> tuples_;
+    std::vector<Value> keys_;
+    std::vector<SortEntry> entries_;
+  };
+
+  /** A sorted run being merged, with the keys of its next tuple. */
+  struct MergeSource {
+    std::unique_ptr<TmpTupleRun::Reader> reader_;
+    Tuple head_;
+    std::vector<Value> keys_;
+    uint64_t prefix_{0};
+  };
+
+  /** Orders merge sources on their next tuples. */
+  struct HeadLess {
+    bool operator()(size_t a, size_t b) const;
+    const SortExecutor *executor_;
+  };
+
+  /** Reads the child, and either sorts its tuples in memory or prepares the merge of its spilled runs. */
+  void Sort();
+
+  /** Evaluates the keys of buffer's tuples and sorts its entries. Safe to call from a worker thread. */
+  void SortInMemory(SortBuffer *buffer) const;
+
+  /** Sorts buffer and writes its tuples to a new run. Safe to call from a worker thread. */
+  std::unique_ptr<TmpTupleRun> SpillRun(SortBuffer *buffer) const;
+
+  /** Evaluates the keys of a tuple and appends them to keys. */
+  void MakeKeys(const Tuple &tuple, std::vector<Value> *keys) const;
+
+  /** @return the normalized prefix of the keys */
+  uint64_t MakePrefix(const Value *keys) const;
+
+  /** @return a negative number, zero or a positive number if keys a come before, with or after keys b */
+  int CompareKeys(const Value *a, const Value *b) const { return CompareKeys(plan_->GetOrderBys(), a, b); }
+
+  /** Starts merging runs, which become runs_. */
+  void StartMerge(std::vector<std::unique_ptr<TmpTupleRun>> &&runs);
+
+  /** Reads the next tuple of a merge source, @return false once the source is exhausted */
+  bool Advance(MergeSource *source);
+
+  /** Takes the next tuple of the merge, @return false once all the runs are exhausted */
+  bool NextMerged(Tuple *tuple);
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_;
+  /** True if equal prefixes imply equal keys, so that keys are only compared when prefixes are. */
+  bool prefix_exact_;
+  bool sorted_{false};
+
+  /** The tuples, when they fit in memory, and the position of the next one in sorted order. */
+  SortBuffer buffer_;
+  size_t buffer_pos_{0};
+
+  /** The runs being merged, a source reading each of them, and the tree merging the sources. */
+  std::vector<std::unique_ptr<TmpTupleRun>> runs_;
+  std::vector<MergeSource> sources_;
+  std::unique_ptr<LoserTree<HeadLess>> tree_;
+  SpillStats spill_stats_;
+};
+
+}  // namespace bustub
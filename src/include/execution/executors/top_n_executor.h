@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.h
+//
+// Identification: src/include/execution/executors/top_n_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/top_n_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TopNExecutor returns the first N tuples of its child in the order of a list of keys, without holding more than N
+ * tuples: a heap keeps the N first tuples seen so far, with the last of them on top, and a tuple is only copied if it
+ * comes before that one. Most tuples of a long input are rejected on the normalized prefix of their first key.
+ *
+ * If the child is an index scan whose index key starts with the ORDER BY keys, all ascending, the child already
+ * produces its tuples in order, and the executor returns the first N of them without reading the rest.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new top-N executor.
+   * @param exec_ctx the executor context
+   * @param plan the top-N plan to be executed
+   * @param child the child executor to obtain tuples from
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return true if the child produces its tuples in order, so that only the first N are read, valid after Init() */
+  bool IsInputOrdered() const { return input_ordered_; }
+
+ private:
+  /** A tuple kept in the heap, with its keys and its position in the child's output. */
+  struct TopNEntry {
+    uint64_t prefix_;
+    size_t seq_;
+    std::vector<Value> keys_;
+    Tuple tuple_;
+  };
+
+  /** @return true if a comes before b */
+  bool Less(const TopNEntry &a, const TopNEntry &b) const;
+
+  /** Reads the child through the heap, and sorts the heap. */
+  void Collect();
+
+  /** The top-N plan node to be executed. */
+  const TopNPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_;
+  /** True if equal prefixes imply equal keys. */
+  bool prefix_exact_;
+  bool input_ordered_{false};
+  bool collected_{false};
+  /** The first N tuples, a heap until they are sorted, and the position of the next one. */
+  std::vector<TopNEntry> heap_;
+  size_t heap_pos_{0};
+  /** The number of tuples returned from an ordered child. */
+  size_t num_returned_{0};
+};
+
+}  // namespace bustub
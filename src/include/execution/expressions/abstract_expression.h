@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -58,6 +59,22 @@ class AbstractExpression {
    */
   virtual Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const = 0;
 
+  /**
+   * Evaluates the expression for every selected row of a batch.
+   * @param batch the batch, whose columns follow the schema that the expression refers to
+   * @param[out] result resized to the rows of the batch; receives the value of each selected row at the row's index
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const = 0;
+
+  /**
+   * Evaluates a join for every selected row of the left batch, pairing it with the row of the right batch at the
+   * same index.
+   * @param left the left rows
+   * @param right the right rows, with at least as many rows as the left batch
+   * @param[out] result resized to the rows of the left batch; receives the value of each selected pair
+   */
+  virtual void EvaluateJoinBatch(const TupleBatch &left, const TupleBatch &right, std::vector<Value> *result) const = 0;
+
   /** @return the child_idx'th child of this expression */
   const AbstractExpression *GetChildAt(uint32_t child_idx) const { return children_[child_idx]; }
 
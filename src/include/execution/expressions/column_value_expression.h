@@ -45,10 +45,27 @@ class ColumnValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    CopyColumn(batch, batch, result);
+  }
+
+  void EvaluateJoinBatch(const TupleBatch &left, const TupleBatch &right, std::vector<Value> *result) const override {
+    CopyColumn(left, tuple_idx_ == 0 ? left : right, result);
+  }
+
   uint32_t GetTupleIdx() const { return tuple_idx_; }
   uint32_t GetColIdx() const { return col_idx_; }
 
  private:
+  /** Copies the column out of source for the rows selected in batch. */
+  void CopyColumn(const TupleBatch &batch, const TupleBatch &source, std::vector<Value> *result) const {
+    const std::vector<Value> &column = source.GetColumn(col_idx_);
+    result->resize(batch.GetNumRows());
+    for (uint32_t row : batch.GetSelection()) {
+      (*result)[row] = column[row];
+    }
+  }
+
   /** Tuple index 0 = left side of join, tuple index 1 = right side of join */
   uint32_t tuple_idx_;
   /** Column index refers to the index within the schema of the tuple, e.g. schema {A,B,C} has indexes {0,1,2} */
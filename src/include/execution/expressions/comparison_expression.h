@@ -53,6 +53,25 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateBatch(batch, &lhs);
+    GetChildAt(1)->EvaluateBatch(batch, &rhs);
+    PerformBatchComparison(batch, lhs, rhs, result);
+  }
+
+  void EvaluateJoinBatch(const TupleBatch &left, const TupleBatch &right, std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateJoinBatch(left, right, &lhs);
+    GetChildAt(1)->EvaluateJoinBatch(left, right, &rhs);
+    PerformBatchComparison(left, lhs, rhs, result);
+  }
+
+  /** @return the type of comparison performed */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
@@ -73,6 +92,14 @@ class ComparisonExpression : public AbstractExpression {
     }
   }
 
+  void PerformBatchComparison(const TupleBatch &batch, const std::vector<Value> &lhs, const std::vector<Value> &rhs,
+                              std::vector<Value> *result) const {
+    result->resize(batch.GetNumRows());
+    for (uint32_t row : batch.GetSelection()) {
+      (*result)[row] = ValueFactory::GetBooleanValue(PerformComparison(lhs[row], rhs[row]));
+    }
+  }
+
   std::vector<const AbstractExpression *> children_;
   ComparisonType comp_type_;
 };
@@ -36,6 +36,17 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    result->resize(batch.GetNumRows());
+    for (uint32_t row : batch.GetSelection()) {
+      (*result)[row] = val_;
+    }
+  }
+
+  void EvaluateJoinBatch(const TupleBatch &left, const TupleBatch &right, std::vector<Value> *result) const override {
+    EvaluateBatch(left, result);
+  }
+
  private:
   Value val_;
 };
@@ -21,12 +21,25 @@
 
 namespace bustub {
 
-/** AggregationType enumerates all the possible aggregation functions in our system. */
-enum class AggregationType { CountAggregate, SumAggregate, MinAggregate, MaxAggregate };
+/**
+ * AggregationType enumerates all the possible aggregation functions in our system.
+ *
+ * COUNT counts the rows of a group, as an INTEGER. The other aggregates skip NULL inputs. SUM, MIN and MAX have the
+ * type of their input and AVG is a DECIMAL, all of them NULL if all the inputs of a group are. APPROX_COUNT_DISTINCT
+ * estimates the number of distinct inputs with a HyperLogLog sketch, as an INTEGER.
+ */
+enum class AggregationType {
+  CountAggregate,
+  SumAggregate,
+  MinAggregate,
+  MaxAggregate,
+  AvgAggregate,
+  ApproxCountDistinctAggregate
+};
 
 /**
  * AggregationPlanNode represents the various SQL aggregation functions.
- * For example, COUNT(), SUM(), MIN() and MAX().
+ * For example, COUNT(), SUM(), MIN(), MAX() and AVG().
  * To simplfiy this project, AggregationPlanNode must always have exactly one child.
  */
 class AggregationPlanNode : public AbstractPlanNode {
@@ -115,9 +128,8 @@ struct hash<bustub::AggregateKey> {
   std::size_t operator()(const bustub::AggregateKey &agg_key) const {
     size_t curr_hash = 0;
     for (const auto &key : agg_key.group_bys_) {
-      if (!key.IsNull()) {
-        curr_hash = bustub::HashUtil::CombineHashes(curr_hash, bustub::HashUtil::HashValue(&key));
-      }
+      // NULLs still advance the hash, so that (NULL, 1) and (1, NULL) land in different buckets
+      curr_hash = bustub::HashUtil::CombineHashes(curr_hash, key.IsNull() ? 0 : bustub::HashUtil::HashValue(&key));
     }
     return curr_hash;
   }
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+
+namespace bustub {
+
+/**
+ * HashJoinPlanNode joins the tuples of two children whose join keys are equal, and that satisfy an optional residual
+ * predicate.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node
+   * @param children the left and right children plans
+   * @param left_keys the join keys, evaluated on the tuples of the left child
+   * @param right_keys the join keys, evaluated on the tuples of the right child, in the same order as left_keys
+   * @param predicate the predicate that joined tuples must also satisfy, or nullptr
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   std::vector<const AbstractExpression *> &&left_keys,
+                   std::vector<const AbstractExpression *> &&right_keys, const AbstractExpression *predicate = nullptr)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        predicate_(predicate) {
+    BUSTUB_ASSERT(left_keys_.size() == right_keys_.size(), "Both sides of a hash join need the same number of keys.");
+  }
+
+  /**
+   * Plans a nested loop join as a hash join if its predicate is an equality between a column of each side.
+   * @param plan the nested loop join plan, which must outlive the returned plan
+   * @return the equivalent hash join plan, or nullptr if the nested loop join is not an equi-join
+   */
+  static std::unique_ptr<HashJoinPlanNode> FromNestedLoopJoin(const NestedLoopJoinPlanNode *plan) {
+    auto *comparison = dynamic_cast<const ComparisonExpression *>(plan->Predicate());
+    if (comparison == nullptr || comparison->GetComparisonType() != ComparisonType::Equal) {
+      return nullptr;
+    }
+    auto *lhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    auto *rhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    if (lhs == nullptr || rhs == nullptr || lhs->GetTupleIdx() == rhs->GetTupleIdx()) {
+      return nullptr;
+    }
+    if (lhs->GetTupleIdx() != 0) {
+      std::swap(lhs, rhs);
+    }
+    return std::make_unique<HashJoinPlanNode>(
+        plan->OutputSchema(), std::vector<const AbstractPlanNode *>{plan->GetLeftPlan(), plan->GetRightPlan()},
+        std::vector<const AbstractExpression *>{lhs}, std::vector<const AbstractExpression *>{rhs});
+  }
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return the left plan node of the hash join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return the join keys of the left side */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the join keys of the right side */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return the residual predicate, or nullptr */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+ private:
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  const AbstractExpression *predicate_;
+};
+
+}  // namespace bustub
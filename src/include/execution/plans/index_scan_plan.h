@@ -19,6 +19,7 @@
 namespace bustub {
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ * If the predicate and the output schema only refer to columns stored in the index, the scan never reads the table.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction of an ORDER BY key. NULL is lower than any other value. */
+enum class OrderByType { ASC, DESC };
+
+/**
+ * SortPlanNode outputs the tuples of its child ordered by a list of keys, each evaluated on the child's tuples. Tuples
+ * with equal keys keep the order in which the child produced them.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node.
+   * @param output_schema the output format of this sort node, which must be the child's
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the keys to sort on, at least one, most significant first, with their directions
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)) {
+    if (order_bys_.empty()) {
+      throw Exception("A sort needs at least one key");
+    }
+  }
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the child plan node of the sort */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the keys to sort on, most significant first, with their directions */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_plan.h
+//
+// Identification: src/include/execution/plans/top_n_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/sort_plan.h"
+
+namespace bustub {
+
+/**
+ * TopNPlanNode outputs the first N tuples of its child ordered by a list of keys, i.e. ORDER BY ... LIMIT N. It
+ * returns the same tuples as a SortPlanNode followed by a LimitPlanNode.
+ */
+class TopNPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new top-N plan node.
+   * @param output_schema the output format of this top-N node, which must be the child's
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the keys to order on, at least one, most significant first, with their directions
+   * @param n the number of tuples to output
+   */
+  TopNPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys, size_t n)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), n_(n) {
+    if (order_bys_.empty()) {
+      throw Exception("A top-N needs at least one key");
+    }
+  }
+
+  PlanType GetType() const override { return PlanType::TopN; }
+
+  /** @return the child plan node of the top-N */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Top-N should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the keys to order on, most significant first, with their directions */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  /** @return the number of tuples to output */
+  size_t GetN() const { return n_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t n_;
+};
+
+}  // namespace bustub
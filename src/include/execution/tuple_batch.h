@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to a fixed number of rows in column-major order, which is the unit of work of the vectorized
+ * executors (see AbstractExecutor::NextBatch()).
+ *
+ * Rows are never removed from a batch. Instead, the selection vector lists the indexes of the rows that are still
+ * valid, in increasing order, so that a filter only rewrites the selection and leaves the columns untouched. Every
+ * consumer of a batch must only look at the selected rows.
+ */
+class TupleBatch {
+ public:
+  /**
+   * Creates an empty batch.
+   * @param capacity the maximum number of rows of the batch
+   */
+  explicit TupleBatch(uint32_t capacity = EXECUTION_BATCH_SIZE) : capacity_(capacity) {}
+
+  /** Drops all rows and resizes the batch to the given number of columns. */
+  void Reset(uint32_t column_count);
+
+  /** @return the number of columns */
+  uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  /** @return the number of rows, selected or not */
+  uint32_t GetNumRows() const { return num_rows_; }
+
+  /** @return the maximum number of rows */
+  uint32_t GetCapacity() const { return capacity_; }
+
+  /** @return true if no more rows can be appended */
+  bool IsFull() const { return num_rows_ >= capacity_; }
+
+  /** @return the indexes of the selected rows, in increasing order */
+  const std::vector<uint32_t> &GetSelection() const { return selection_; }
+
+  /** @return the number of selected rows */
+  uint32_t GetNumSelected() const { return static_cast<uint32_t>(selection_.size()); }
+
+  /** @return the values of a column, indexed by row; only selected rows hold meaningful values */
+  const std::vector<Value> &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the value of a column in a row */
+  const Value &GetValue(uint32_t row, uint32_t col_idx) const { return columns_[col_idx][row]; }
+
+  /** Sets the value of a column in a row. */
+  void SetValue(uint32_t row, uint32_t col_idx, const Value &value) { columns_[col_idx][row] = value; }
+
+  /** @return the RID of the table tuple a row was read from, if any */
+  const RID &GetRid(uint32_t row) const { return rids_[row]; }
+
+  /**
+   * Appends a selected row whose values are all left unset, to be filled with SetValue().
+   * @param rid the RID of the table tuple the row is read from
+   * @return the index of the new row
+   */
+  uint32_t AppendRow(const RID &rid = RID());
+
+  /**
+   * Appends a selected row holding some of the values of a table tuple. The other columns of the row are left unset.
+   * @param tuple the tuple, whose RID is kept with the row
+   * @param schema the schema of the tuple, which must have as many columns as the batch
+   * @param col_idxs the columns to read from the tuple
+   */
+  void AppendTuple(const Tuple &tuple, const Schema *schema, const std::vector<uint32_t> &col_idxs);
+
+  /**
+   * Deselects the rows for which a predicate does not hold.
+   * @param predicate the value of the predicate, indexed by row, for every selected row
+   */
+  void Filter(const std::vector<Value> &predicate);
+
+  /** @return a row materialized as a tuple of the given schema */
+  Tuple GetTuple(uint32_t row, const Schema *schema) const;
+
+ private:
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  std::vector<uint32_t> selection_;
+  uint32_t num_rows_{0};
+  uint32_t capacity_;
+};
+
+}  // namespace bustub
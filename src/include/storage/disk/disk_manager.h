@@ -15,6 +15,7 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
+#include <mutex>   // NOLINT
 #include <string>
 
 #include "common/config.h"
@@ -47,6 +48,14 @@ class DiskManager {
    */
   void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write consecutive pages to the database file with a single sequential write.
+   * @param first_page_id id of the first page, see AllocatePages()
+   * @param page_data raw data of num_pages pages
+   * @param num_pages number of pages
+   */
+  void WritePages(page_id_t first_page_id, const char *page_data, size_t num_pages);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -76,6 +85,13 @@ class DiskManager {
    */
   page_id_t AllocatePage();
 
+  /**
+   * Allocate consecutive pages on disk.
+   * @param num_pages number of pages
+   * @return the id of the first allocated page
+   */
+  page_id_t AllocatePages(size_t num_pages);
+
   /**
    * Deallocate a page on disk.
    * @param page_id id of the page to deallocate
@@ -107,6 +123,8 @@ class DiskManager {
   std::string log_name_;
   // stream to write db file
   std::fstream db_io_;
+  // the stream has a single cursor, so a seek and the following read or write must not interleave
+  std::mutex db_io_latch_;
   std::string file_name_;
   std::atomic<page_id_t> next_page_id_;
   int num_flushes_;
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_hash_index.h
+//
+// Identification: src/include/storage/index/adaptive_hash_index.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define ADAPTIVE_HASH_INDEX_TYPE AdaptiveHashIndex<KeyType, ValueType, KeyComparator>
+/** Number of root-to-leaf traversals that must end in a leaf before its keys get hash entries. */
+#define ADAPTIVE_HASH_BUILD_THRESHOLD 32
+#define ADAPTIVE_HASH_DEFAULT_ENTRIES (1 << 16)
+
+/**
+ * In-memory hash index from keys to the leaf page and slot that hold them,
+ * built on top of a B+ tree for the leaves that point lookups hit most, in
+ * the style of InnoDB's adaptive hash index.
+ *
+ * (1) every lookup that traverses the tree reports the leaf it ended in;
+ * once a leaf has been reached ADAPTIVE_HASH_BUILD_THRESHOLD times, all of
+ * its keys get entries, and later traversals into it add their key
+ * (2) a lookup whose key has an entry fetches the leaf directly. The slot
+ * may be stale after inserts or removes in the leaf, but the key range of
+ * the leaf is not, so the leaf alone decides whether the key exists
+ * (3) the tree invalidates a leaf whenever its key range changes (splits and
+ * merges). Entries carry the epoch of their leaf at build time and are
+ * ignored once the leaf has moved on, so invalidation is O(1)
+ * The entries form a direct-mapped table of fixed size: an entry replaces
+ * whatever entry its key hashes to, which keeps memory bounded and lets the
+ * hottest keys win. A leaf is forgotten once it is invalidated or all of its
+ * entries have been replaced, and the traversal counts of cold leaves are
+ * dropped when there are too many of them, so the per-leaf state is bounded
+ * by the table size as well. Operations take a mutex, so concurrent lookups
+ * are safe.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class AdaptiveHashIndex {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit AdaptiveHashIndex(const KeyComparator &comparator, size_t num_entries = ADAPTIVE_HASH_DEFAULT_ENTRIES);
+
+  /**
+   * Looks up the leaf of a key.
+   * @param[out] leaf_page_id the leaf that covers the key
+   * @param[out] slot where the key was when its entry was made
+   * @return false if the key has no valid entry
+   */
+  bool Find(const KeyType &key, page_id_t *leaf_page_id, int *slot);
+
+  /**
+   * Reports a traversal that ended in the leaf, where the key is at slot, or slot is -1 if it is not there.
+   * The caller holds the leaf pinned.
+   */
+  void RecordTraversal(LeafPage *leaf_page, const KeyType &key, int slot);
+
+  /** Records the new slot of a key whose entry was stale. */
+  void UpdateSlot(const KeyType &key, page_id_t leaf_page_id, int slot);
+
+  /** Drops all entries of a leaf whose key range changed. */
+  void InvalidateLeaf(page_id_t leaf_page_id);
+
+  /** @return the number of lookups answered through an entry */
+  size_t GetNumHits() const { return num_hits_.load(); }
+
+  /** @return the number of leaves whose traversals or entries are being tracked */
+  size_t GetNumLeaves() {
+    std::lock_guard<std::mutex> guard(latch_);
+    return leaves_.size();
+  }
+
+ private:
+  struct Entry {
+    uint64_t hash_;
+    page_id_t leaf_page_id_{INVALID_PAGE_ID};
+    int slot_;
+    uint64_t epoch_;
+    KeyType key_;
+  };
+
+  struct LeafInfo {
+    uint32_t traversals_{0};
+    /** Unique across leaves and never reused, so entries of a forgotten leaf stay invalid. */
+    uint64_t epoch_;
+    bool indexed_{false};
+    /** Number of entries of this epoch that are still in the table. */
+    size_t num_entries_{0};
+  };
+
+  uint64_t Hash(const KeyType &key) const;
+
+  // latch held
+  LeafInfo &GetLeafInfo(page_id_t leaf_page_id);
+
+  // latch held
+  void Add(const KeyType &key, uint64_t hash, page_id_t leaf_page_id, LeafInfo *info, int slot);
+
+  KeyComparator comparator_;
+  std::mutex latch_;
+  std::vector<Entry> entries_;
+  size_t mask_;
+  std::unordered_map<page_id_t, LeafInfo> leaves_;
+  uint64_t next_epoch_{0};
+  std::atomic<size_t> num_hits_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/** Inner node kinds of the adaptive radix tree, named after their maximal number of children. */
+enum class ArtNodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+/**
+ * Header shared by all inner nodes.
+ *
+ * The version implements optimistic lock coupling: bit 1 is the write lock,
+ * bit 0 marks a node that was replaced and must not be used any more, the
+ * remaining bits count modifications. Readers remember the version, read
+ * without locking and restart their operation if the version changed.
+ *
+ * prefix_len_ is the length of the compressed path above the children, of
+ * which only the first ART_MAX_STORED_PREFIX bytes are kept in the node; the
+ * rest is read from any leaf below, since they all share the prefix.
+ */
+#define ART_MAX_STORED_PREFIX 8
+
+class ArtNode {
+ public:
+  ArtNode(ArtNodeType type, const uint8_t *prefix, uint32_t prefix_len) : type_(type) { SetPrefix(prefix, prefix_len); }
+
+  void SetPrefix(const uint8_t *prefix, uint32_t prefix_len);
+
+  // prepends the prefix of the given node and the key byte that led from it to this node
+  void AddPrefixBefore(const ArtNode *node, uint8_t key);
+
+  uint64_t ReadLockOrRestart(bool *restart) const;
+  void CheckOrRestart(uint64_t version, bool *restart) const { ReadUnlockOrRestart(version, restart); }
+  void ReadUnlockOrRestart(uint64_t version, bool *restart) const;
+  void UpgradeToWriteLockOrRestart(uint64_t *version, bool *restart);
+  void WriteLockOrRestart(bool *restart);
+  void WriteUnlock() { version_.fetch_add(0b10); }
+  void WriteUnlockObsolete() { version_.fetch_add(0b11); }
+
+  std::atomic<uint64_t> version_{0b100};
+  const ArtNodeType type_;
+  uint16_t count_{0};
+  uint32_t prefix_len_{0};
+  uint8_t prefix_[ART_MAX_STORED_PREFIX];
+};
+
+/** Up to 4 children, keys kept sorted. */
+class ArtNode4 : public ArtNode {
+ public:
+  ArtNode4(const uint8_t *prefix, uint32_t prefix_len) : ArtNode(ArtNodeType::NODE4, prefix, prefix_len) {}
+
+  uint8_t keys_[4];
+  std::atomic<ArtNode *> children_[4];
+};
+
+/** Up to 16 children, keys kept sorted and searched 16 at a time with SSE2. */
+class ArtNode16 : public ArtNode {
+ public:
+  ArtNode16(const uint8_t *prefix, uint32_t prefix_len) : ArtNode(ArtNodeType::NODE16, prefix, prefix_len) {}
+
+  uint8_t keys_[16];
+  std::atomic<ArtNode *> children_[16];
+};
+
+/** Up to 48 children, reached through a 256 entry index of slots. */
+class ArtNode48 : public ArtNode {
+ public:
+  static constexpr uint8_t EMPTY_MARKER = 48;
+
+  ArtNode48(const uint8_t *prefix, uint32_t prefix_len);
+
+  uint8_t child_index_[256];
+  std::atomic<ArtNode *> children_[48];
+};
+
+/** One child per key byte. */
+class ArtNode256 : public ArtNode {
+ public:
+  ArtNode256(const uint8_t *prefix, uint32_t prefix_len);
+
+  std::atomic<ArtNode *> children_[256];
+};
+
+/** A leaf holds a whole key and its value; it is never modified once it is in the tree. */
+struct ArtLeaf {
+  RID value_;
+  uint32_t key_len_;
+  uint8_t key_[0];
+};
+
+/**
+ * In-memory adaptive radix tree mapping binary-comparable keys to RIDs.
+ *
+ * Inner nodes are Node4/16/48/256 and grow into the next kind when full;
+ * paths of single-child nodes are compressed into prefixes. Concurrency
+ * follows optimistic lock coupling ("The ART of Practical Synchronization",
+ * Leis et al., DaMoN 2016): lookups take no locks at all and writers only
+ * lock the one or two nodes they modify.
+ *
+ * Nodes and leaves that were unlinked may still be read by concurrent
+ * operations, so they are freed through an epoch scheme once every operation
+ * that could have seen them is done.
+ *
+ * No key may be a prefix of another key, which holds for fixed length keys
+ * and for the encoding used by ArtIndex. Keys are unique.
+ */
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  /** @return false if the key is already present */
+  bool Insert(const std::string &key, RID value);
+
+  /** @return false if the key is not present */
+  bool Remove(const std::string &key);
+
+  /** @return true and the value of the key if it is present */
+  bool GetValue(const std::string &key, RID *value);
+
+ private:
+  /**
+   * Epoch based reclamation: an operation registers in the current epoch;
+   * garbage retired in epoch e is freed when the epoch moves to e + 2, which
+   * requires that no operation from epoch e or earlier is left.
+   */
+  class EpochGuard {
+   public:
+    explicit EpochGuard(AdaptiveRadixTree *tree);
+    ~EpochGuard();
+
+   private:
+    AdaptiveRadixTree *tree_;
+    uint64_t epoch_;
+  };
+
+  // single attempts of the operations, they set restart when they ran into a concurrent modification
+  bool LookupOrRestart(const std::string &key, RID *value, bool *restart);
+  bool InsertOrRestart(const std::string &key, ArtNode *leaf, bool *restart);
+  bool RemoveOrRestart(const std::string &key, bool *restart);
+
+  void Retire(ArtNode *node);
+  static void FreeNode(ArtNode *node);
+  static void FreeSubtree(ArtNode *node);
+
+  static bool IsLeaf(const ArtNode *node) { return (reinterpret_cast<uintptr_t>(node) & 1) == 1; }
+  static ArtLeaf *AsLeaf(const ArtNode *node) {
+    return reinterpret_cast<ArtLeaf *>(reinterpret_cast<uintptr_t>(node) & ~static_cast<uintptr_t>(1));
+  }
+  static ArtNode *MakeLeaf(const std::string &key, RID value);
+  static bool LeafMatches(const ArtNode *node, const std::string &key);
+
+  static ArtNode *GetChild(const ArtNode *node, uint8_t key);
+  static ArtNode *GetAnyChild(const ArtNode *node);
+  static ArtNode *GetSecondChild(const ArtNode *node, uint8_t key, uint8_t *second_key);
+  static bool IsFull(const ArtNode *node);
+  // all of these must be called with the node write locked
+  static void InsertChild(ArtNode *node, uint8_t key, ArtNode *child);
+  static void ChangeChild(ArtNode *node, uint8_t key, ArtNode *child);
+  static void RemoveChild(ArtNode *node, uint8_t key);
+  static ArtNode *Grow(const ArtNode *node);
+
+  // any leaf below the node, which shares the whole prefix of the node
+  static const ArtLeaf *AnyLeaf(const ArtNode *node, bool *restart);
+
+  /**
+   * Compares the stored part of the prefix only, the rest is left to the leaf check.
+   * @return false if the key does not continue below the node, advances level past the prefix otherwise
+   */
+  static bool PrefixMatches(const ArtNode *node, const std::string &key, uint32_t *level);
+
+  /**
+   * Compares the whole prefix. On a mismatch returns true with the prefix byte that differs and the prefix
+   * bytes after it; advances level to the mismatch or past the prefix.
+   */
+  static bool CheckPrefixPessimistic(const ArtNode *node, const std::string &key, uint32_t *level,
+                                     uint8_t *non_matching_key, uint8_t *non_matching_prefix, bool *restart);
+
+  void InsertAndUnlock(ArtNode *node, uint64_t version, ArtNode *parent, uint64_t parent_version, uint8_t parent_key,
+                       uint8_t key, ArtNode *child, bool *restart);
+
+  // never replaced, so every other node has a parent
+  ArtNode256 *root_;
+
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<uint64_t> active_[3];
+  std::mutex garbage_latch_;
+  std::vector<ArtNode *> garbage_[3];
+  size_t retired_since_advance_{0};
+};
+
+}  // namespace bustub
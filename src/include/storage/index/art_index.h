@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/**
+ * Unique in-memory index backed by an adaptive radix tree, for tables that
+ * fit in memory. It bypasses the buffer pool, so nothing of it is persisted:
+ * the catalog rebuilds it from the table heap when the index is created.
+ *
+ * Keys are encoded so that comparing them byte by byte gives the column
+ * order of the key schema: integers big-endian with the sign bit flipped,
+ * decimals by their IEEE bits, varchars with 0x00 escaped as 0x00 0xFF and
+ * terminated by 0x00 0x00 so that no key is a prefix of another.
+ */
+class ArtIndex : public Index {
+ public:
+  explicit ArtIndex(IndexMetadata *metadata);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ private:
+  std::string EncodeKey(const Tuple &key) const;
+
+  AdaptiveRadixTree container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/b_epsilon_tree.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "concurrency/transaction.h"
+#include "storage/page/b_epsilon_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BEPSILONTREE_TYPE BEpsilonTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Write-optimized B-epsilon tree.
+ *
+ * Leaves are ordinary B+ tree leaf pages. Internal nodes have a small fanout
+ * and spend the rest of their page on a buffer of pending messages (see
+ * storage/page/b_epsilon_tree_internal_page.h):
+ * (1) updates are messages added to the root buffer, they do not touch a leaf
+ * (2) a full buffer hands all messages of its busiest child down in one
+ * batch, so a leaf gets dirtied once per batch instead of once per update
+ * (3) point queries merge the messages found on the way down with the leaf
+ * (4) nodes split when a flush overflows them and are never merged
+ *
+ * Keys are unique. Since updates are applied lazily, Insert cannot report a
+ * duplicate key; it only takes effect if the key is absent when the message
+ * reaches the leaf. All operations are serialized by a tree latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonTree {
+  using InternalPage = BEpsilonTreeInternalPage<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using Message = BEpsilonMessage<KeyType, ValueType>;
+  using Pivot = std::pair<KeyType, page_id_t>;
+
+ public:
+  explicit BEpsilonTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                        int leaf_max_size = LEAF_PAGE_SIZE - 1, int internal_max_fanout = 16);
+
+  // Returns true if this tree has never seen an update.
+  bool IsEmpty() const;
+
+  // Insert a key-value pair unless the key exists.
+  void Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Insert a key-value pair, replacing the value of an existing key.
+  void Upsert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+ private:
+  // adds a message at the root and pushes it down as far as buffer space requires
+  void Put(const Message &message);
+
+  /**
+   * Hands a sorted batch of messages (one per key) to the subtree rooted at the given page.
+   * @param[out] splits receives (separator, page id) of every node the subtree root was split into, besides itself
+   */
+  void FlushInto(page_id_t page_id, const std::vector<Message> &messages, std::vector<Pivot> *splits);
+
+  void ApplyToLeaf(Page *page, const std::vector<Message> &messages, std::vector<Pivot> *splits);
+
+  void FlushInternal(Page *page, const std::vector<Message> &messages, std::vector<Pivot> *splits);
+
+  // writes pivots and messages back into the page and as many new right siblings as needed, unpins the page
+  void StoreInternal(Page *page, const std::vector<Pivot> &pivots, const std::vector<Message> &messages,
+                     std::vector<Pivot> *splits);
+
+  // merges a newer message for the same key into an older one
+  static void Combine(Message *older, const Message &newer);
+
+  // applies a message to the state of a key
+  static void Apply(const Message &message, bool *present, ValueType *value);
+
+  Page *NewTreePage(page_id_t *page_id);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_fanout_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/b_link_tree.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "concurrency/transaction.h"
+#include "storage/page/b_link_tree_page.h"
+
+namespace bustub {
+
+#define BLINKTREE_TYPE BLinkTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Concurrent B+ tree following Lehman and Yao's B-link tree.
+ *
+ * Every node carries a high key and a link to its right sibling (see
+ * storage/page/b_link_tree_page.h), so a search that races with a split can
+ * always recover by moving right. This removes latch coupling:
+ * (1) readers hold the shared latch of a single node at a time on their way
+ * down, plus the next node for the instant of a move right
+ * (2) writers descend the same way, exclusively latch the leaf and hold at
+ * most two latches at once: a node and its new sibling during a split, or a
+ * node and its right sibling while moving right. The separator is posted to
+ * the parent after the child latches are released.
+ * (3) only growing the root takes a tree-wide mutex
+ *
+ * Keys are unique. Nodes never merge; removal leaves underfull nodes behind.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTree {
+  using InternalPage = BLinkTreePage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BLinkTreePage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = LeafMaxSize(), int internal_max_size = InternalMaxSize());
+
+  // Returns true if this tree has no keys and values.
+  bool IsEmpty() const;
+
+  // Insert a key-value pair into this tree.
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this tree.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  // append every pair with low <= key <= high to result, in key order
+  void ScanRange(const KeyType &low, const KeyType &high, std::vector<std::pair<KeyType, ValueType>> *result,
+                 Transaction *transaction = nullptr);
+
+  static constexpr int LeafMaxSize() {
+    return (PAGE_SIZE - B_LINK_PAGE_HEADER_SIZE - sizeof(KeyType)) / sizeof(std::pair<KeyType, ValueType>);
+  }
+  static constexpr int InternalMaxSize() {
+    return (PAGE_SIZE - B_LINK_PAGE_HEADER_SIZE - sizeof(KeyType)) / sizeof(std::pair<KeyType, page_id_t>);
+  }
+
+ private:
+  /**
+   * Descends to the node on the given level whose range covers the key and returns it latched, shared or exclusive.
+   * @param path if not null, receives the page ids of the nodes passed on the levels above, root first
+   * @return the latched and pinned page, or nullptr if the tree is empty or not that tall yet
+   */
+  Page *FindNode(const KeyType &key, int level, bool exclusive, std::vector<page_id_t> *path = nullptr);
+
+  // follows right links until the latched page covers the key, the returned page is latched the same way
+  Page *MoveRight(Page *page, const KeyType &key, bool exclusive);
+
+  // posts the separator of a split on level - 1 into the given level, splitting further up as needed
+  void InsertIntoParent(page_id_t old_page_id, const KeyType &key, page_id_t new_page_id, int level,
+                        std::vector<page_id_t> *path);
+
+  // fetches and latches a page, throws if the buffer pool is out of frames
+  Page *FetchLatched(page_id_t page_id, bool exclusive);
+
+  void ReleaseLatched(Page *page, bool exclusive, bool is_dirty);
+
+  void StartNewTree(const KeyType &key, const ValueType &value);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  std::atomic<page_id_t> root_page_id_;
+  // serializes creating the first leaf and growing the tree by one level
+  std::mutex root_latch_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+};
+
+}  // namespace bustub
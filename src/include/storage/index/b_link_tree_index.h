@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/b_link_tree_index.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/index/b_link_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define BLINKTREE_INDEX_TYPE BLinkTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Unique index backed by a B-link tree, meant for indexes that see many
+ * concurrent writers.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTreeIndex : public Index {
+ public:
+  BLinkTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  BLinkTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
@@ -10,28 +10,40 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
 
 #include "concurrency/transaction.h"
+#include "storage/index/adaptive_hash_index.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+#define BPLUSTREE_PREFETCH_GROUP 16
+// most values a duplicate key keeps inline in its leaf before they move to a posting list
+#define BPLUSTREE_INLINE_POSTING_SIZE 8
 
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique unless the tree is created with allow_duplicates, in which
+ * case every key maps to a sorted list of values: a short list is stored inline
+ * as adjacent leaf entries, a longer one in posting pages (see
+ * storage/page/b_plus_tree_posting_page.h)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Point lookups can go through an optional adaptive hash index (see
+ * storage/index/adaptive_hash_index.h), which must be told about every leaf
+ * whose key range changes
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -39,8 +51,10 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  // a node briefly holds max_size + 1 entries before it splits, so the default sizes leave room for one extra entry
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE - 1, int internal_max_size = INTERNAL_PAGE_SIZE - 1,
+                     bool allow_duplicates = false);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -51,9 +65,23 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove one key-value pair; the key stays as long as it has other values.
+  bool Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // return the value(s) associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // (*results)[i] receives the value(s) associated with keys[i]; the keys descend the tree a group at a time, level
+  // by level, prefetching the nodes of the next level for the whole group
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr);
+
+  // build hash entries for the leaves that point lookups hit most, so that GetValue can skip the traversal to them
+  void EnableAdaptiveHashIndex(size_t num_entries = ADAPTIVE_HASH_DEFAULT_ENTRIES);
+
+  // lookups answered through the adaptive hash index, 0 if it is not enabled
+  size_t GetNumAdaptiveHashHits() const;
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
@@ -82,6 +110,15 @@ class BPlusTree {
  private:
   void StartNewTree(const KeyType &key, const ValueType &value);
 
+  // the slot of the key in the leaf, or -1
+  int SlotOf(LeafPage *leaf_page, const KeyType &key);
+
+  // appends the value(s) stored at a slot of the leaf
+  void GetValueFromLeaf(LeafPage *leaf_page, int slot, std::vector<ValueType> *result);
+
+  // answers a lookup from the leaf that an adaptive hash entry points to
+  bool GetValueFromHashedLeaf(page_id_t leaf_page_id, int slot, const KeyType &key, std::vector<ValueType> *result);
+
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
@@ -102,6 +139,15 @@ class BPlusTree {
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  /* Posting list routines, only used when duplicates are allowed */
+  page_id_t CreatePostingList(const std::vector<ValueType> &values);
+
+  bool InsertIntoPostingList(page_id_t head_page_id, const ValueType &value);
+
+  bool RemoveFromPostingList(page_id_t head_page_id, const ValueType &value, bool *collapsed, ValueType *remaining);
+
+  void DeletePostingList(page_id_t head_page_id);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -116,6 +162,10 @@ class BPlusTree {
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool allow_duplicates_;
+  // a leaf must keep at least two keys to split, so small leaves hold shorter inline lists
+  int inline_posting_size_;
+  std::unique_ptr<AdaptiveHashIndex<KeyType, ValueType, KeyComparator>> adaptive_hash_index_;
 };
 
 }  // namespace bustub
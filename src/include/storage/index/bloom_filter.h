@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * Bloom filter over key hashes. The probes are derived from a single hash by
+ * double hashing, so a key is hashed once no matter how many probes are made.
+ * With 10 bits per key the false positive rate is about 1%.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Creates an empty filter.
+   * @param num_keys the number of keys that will be inserted
+   * @param bits_per_key filter bits spent on every key
+   */
+  explicit BloomFilter(size_t num_keys, size_t bits_per_key = 10);
+
+  void Insert(hash_t hash);
+
+  /** @return false if no key with this hash was inserted, true if one probably was */
+  bool MayContain(hash_t hash) const;
+
+ private:
+  std::vector<uint64_t> bits_;
+  uint64_t num_bits_;
+  uint32_t num_probes_;
+};
+
+}  // namespace bustub
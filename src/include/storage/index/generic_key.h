@@ -14,6 +14,7 @@
 
 #include <cstring>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -30,6 +31,7 @@ template <size_t KeySize>
 class GenericKey {
  public:
   inline void SetFromKey(const Tuple &tuple) {
+    BUSTUB_ASSERT(tuple.GetLength() <= KeySize, "key tuple does not fit into the generic key");
     // intialize to 0
     memset(data_, 0, KeySize);
     memcpy(data_, tuple.GetData(), tuple.GetLength());
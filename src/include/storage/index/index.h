@@ -30,6 +30,12 @@ namespace bustub {
  * index, since the external callers does not know the actual structure of
  * the index key, so it is the index's responsibility to maintain such a
  * mapping relation and does the conversion between tuple key and index key
+ *
+ * A covering index additionally stores included (non-key) columns next to
+ * the key. Index entries are then built from the index tuple, which holds the
+ * key columns followed by the included columns; the key columns always come
+ * first, so the key schema describes a prefix of every index tuple and
+ * lookups by key alone keep working.
  */
 class Transaction;
 class IndexMetadata {
@@ -37,12 +43,22 @@ class IndexMetadata {
   IndexMetadata() = delete;
 
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, std::vector<uint32_t> include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(std::move(include_attrs)),
+        is_unique_(is_unique) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
+    index_tuple_attrs_ = key_attrs_;
+    index_tuple_attrs_.insert(index_tuple_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    index_tuple_schema_ = Schema::CopySchema(tuple_schema, index_tuple_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  ~IndexMetadata() {
+    delete key_schema_;
+    delete index_tuple_schema_;
+  }
 
   inline const std::string &GetName() const { return name_; }
 
@@ -60,6 +76,18 @@ class IndexMetadata {
   //  columns
   inline const std::vector<uint32_t> &GetKeyAttrs() const { return key_attrs_; }
 
+  // Returns the non-key columns stored along with the key
+  inline const std::vector<uint32_t> &GetIncludeAttrs() const { return include_attrs_; }
+
+  // Returns the base table columns of an index tuple: the key attributes followed by the included ones
+  inline const std::vector<uint32_t> &GetIndexTupleAttrs() const { return index_tuple_attrs_; }
+
+  // Returns the schema of the tuples stored in the index, see GetIndexTupleAttrs()
+  inline Schema *GetIndexTupleSchema() const { return index_tuple_schema_; }
+
+  // Whether every key maps to at most one RID; non-unique indexes keep all RIDs of a key
+  inline bool IsUnique() const { return is_unique_; }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -78,8 +106,16 @@ class IndexMetadata {
   std::string table_name_;
   // The mapping relation between key schema and tuple schema
   const std::vector<uint32_t> key_attrs_;
+  // included columns of a covering index, empty otherwise
+  const std::vector<uint32_t> include_attrs_;
+  // key_attrs_ followed by include_attrs_
+  std::vector<uint32_t> index_tuple_attrs_;
+  // whether duplicate keys are rejected
+  bool is_unique_;
   // schema of the indexed key
   Schema *key_schema_;
+  // schema of the stored index tuple, the key schema plus the included columns
+  Schema *index_tuple_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -117,6 +153,10 @@ class Index {
 
   const std::vector<uint32_t> &GetKeyAttrs() const { return metadata_->GetKeyAttrs(); }
 
+  Schema *GetIndexTupleSchema() const { return metadata_->GetIndexTupleSchema(); }
+
+  const std::vector<uint32_t> &GetIndexTupleAttrs() const { return metadata_->GetIndexTupleAttrs(); }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -129,7 +169,8 @@ class Index {
   ///////////////////////////////////////////////////////////////////
   // Point Modification
   ///////////////////////////////////////////////////////////////////
-  // designed for secondary indexes.
+  // designed for secondary indexes. The key is the index tuple, i.e. it carries the included columns of a covering
+  // index as well; built with Tuple::KeyFromTuple(schema, *GetIndexTupleSchema(), GetIndexTupleAttrs()).
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
   // delete the index entry linked to given tuple
@@ -137,6 +178,16 @@ class Index {
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  // look up a batch of keys, (*results)[i] receives the RIDs of keys[i]. Indexes that can overlap the lookups of a
+  // batch override this one key at a time version.
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
@@ -13,7 +13,10 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
@@ -35,10 +38,30 @@ class IndexIterator {
 
   bool operator!=(const IndexIterator &itr) const;
 
+  /**
+   * Copies every remaining entry of the current leaf into batch under a single read latch, unpins the leaf and moves
+   * the iterator to the first entry of the next leaf. The batch is cleared first so callers can reuse its storage.
+   * Keys with a posting list contribute one entry per value.
+   * @param[out] batch the entries copied out of the leaf, in key order
+   * @param comparator the comparator of the tree this iterator belongs to
+   * @param upper_bound if not null, the scan stops after the last key <= upper_bound and the iterator reaches end
+   * @param prefetch_next if true, the next leaf is brought into the buffer pool before returning
+   * @return the number of entries in batch; zero only once the iterator has reached end
+   */
+  size_t NextBatch(std::vector<MappingType> *batch, const KeyComparator &comparator,
+                   const KeyType *upper_bound = nullptr, bool prefetch_next = false);
+
  private:
+  // decodes the posting list of the current entry if it has one and it is not loaded yet
+  void LoadPostingList(const MappingType &item);
+
   page_id_t current_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   int index_;
+  // values of the current entry when its key has a posting list, and the position within them
+  std::vector<RID> posting_values_;
+  size_t posting_index_{0};
+  MappingType current_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/lsm_memtable.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/page/lsm_run_page.h"
+
+namespace bustub {
+
+#define LSM_MEMTABLE_TYPE LSMMemTable<KeyType, ValueType, KeyComparator>
+#define LSM_MEMTABLE_MAX_HEIGHT 12
+
+/**
+ * In-memory write buffer of an LSM tree: a skiplist that is never shrunk.
+ *
+ * Every update becomes a new node, ordered by key and then by sequence
+ * number with the newest first, so the first node of a key holds its current
+ * state. Since nodes are never unlinked, writers link a node level by level
+ * with compare-and-swap and readers need no synchronization at all.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class LSMMemTable {
+  using Record = LSMRecord<KeyType, ValueType>;
+
+ public:
+  explicit LSMMemTable(const KeyComparator &comparator);
+  ~LSMMemTable();
+
+  DISALLOW_COPY_AND_MOVE(LSMMemTable);
+
+  // sequence numbers must be unique
+  void Put(const Record &record, uint64_t sequence);
+
+  // returns the newest record of the key
+  bool Get(const KeyType &key, Record *record) const;
+
+  // number of updates, which is larger than the number of keys if keys were updated repeatedly
+  size_t GetNumRecords() const { return num_records_.load(); }
+
+  // appends the newest record of every key in key order; no Put may run concurrently
+  void Collect(std::vector<Record> *records) const;
+
+ private:
+  struct Node {
+    Record record_;
+    uint64_t sequence_;
+    int height_;
+    // height_ entries, allocated along with the node
+    std::atomic<Node *> next_[1];
+  };
+
+  static Node *NewNode(const Record &record, uint64_t sequence, int height);
+  static int RandomHeight();
+
+  // whether node a sorts before node b
+  bool Before(const Node *a, const Node *b) const;
+
+  // finds the nodes the given node goes between on a level, starting the search at start
+  void FindSplice(Node *start, int level, const Node *node, Node **prev, Node **next) const;
+
+  KeyComparator comparator_;
+  Node *head_;
+  std::atomic<size_t> num_records_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/lsm_tree.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/rwlatch.h"
+#include "common/thread_pool.h"
+#include "concurrency/transaction.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/index/lsm_memtable.h"
+#include "storage/page/lsm_run_page.h"
+
+namespace bustub {
+
+#define LSMTREE_TYPE LSMTree<KeyType, ValueType, KeyComparator>
+#define LSM_WRITE_BATCH_PAGES 32
+#define LSM_MAX_IMMUTABLE_MEMTABLES 2
+
+/**
+ * Log-structured merge tree for write-heavy tables.
+ *
+ * (1) updates go to an in-memory skiplist (see LSMMemTable), nothing is
+ * written in place
+ * (2) a full memtable becomes immutable and a background thread writes it out
+ * as a sorted run with large sequential writes, bypassing the buffer pool
+ * (3) runs are organized in levels: level 0 holds flushed memtables whose key
+ * ranges overlap, every deeper level a single run size_ratio times larger
+ * than the level above. Background compaction merges level 0 into level 1
+ * once it holds level0_max_runs runs, and a level into the next one once it
+ * outgrows its capacity; tombstones are dropped when nothing older is left
+ * below the output
+ * (4) point queries search the memtables and then the runs, newest first;
+ * every run keeps its fence keys and a bloom filter in memory, so a lookup
+ * reads at most one page of each run that may contain the key
+ *
+ * Keys are unique and Insert overwrites the value of an existing key. The
+ * memtables and runs in use are published as an immutable Version, so
+ * queries never wait for flushes or compactions. Writers only block when
+ * flushing falls behind by LSM_MAX_IMMUTABLE_MEMTABLES memtables.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class LSMTree {
+  using MemTable = LSMMemTable<KeyType, ValueType, KeyComparator>;
+  using Record = LSMRecord<KeyType, ValueType>;
+  using RunPage = LSMRunPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit LSMTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                   size_t memtable_capacity = 64 * LSM_RUN_PAGE_SIZE, size_t level0_max_runs = 4,
+                   size_t size_ratio = 10, size_t num_background_threads = 2);
+
+  // Insert a key-value pair, replacing the value of an existing key.
+  void Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  // blocks until all full memtables are written out and no compaction is due
+  void WaitForBackgroundWork();
+
+  // records in level 0 and in every level below; shadowed records and tombstones are included
+  std::vector<size_t> GetLevelSizes();
+
+ private:
+  /** An immutable sorted run. Its pages are deleted along with it. */
+  struct SortedRun {
+    SortedRun(BufferPoolManager *buffer_pool_manager, size_t expected_records)
+        : buffer_pool_manager_(buffer_pool_manager), bloom_(expected_records) {}
+    ~SortedRun();
+
+    BufferPoolManager *buffer_pool_manager_;
+    std::vector<page_id_t> page_ids_;
+    // the first key of every page
+    std::vector<KeyType> fence_keys_;
+    BloomFilter bloom_;
+    size_t num_records_{0};
+  };
+
+  /** The memtables and runs making up the tree at one point in time. */
+  struct Version {
+    std::shared_ptr<MemTable> memtable_;
+    // newest first
+    std::vector<std::shared_ptr<MemTable>> immutables_;
+    // newest first
+    std::vector<std::shared_ptr<SortedRun>> level0_;
+    // levels_[i] is level i + 1, nullptr while empty
+    std::vector<std::shared_ptr<SortedRun>> levels_;
+  };
+
+  /** Reads a run front to back, one page at a time, around the buffer pool. */
+  class RunReader {
+   public:
+    RunReader(const SortedRun *run, DiskManager *disk_manager);
+    bool IsEnd() const { return page_index_ == run_->page_ids_.size(); }
+    const Record &Get() const { return CurrentPage()->RecordAt(slot_); }
+    void Next();
+
+   private:
+    const RunPage *CurrentPage() const { return reinterpret_cast<const RunPage *>(buffer_.data()); }
+    void ReadPage();
+
+    const SortedRun *run_;
+    DiskManager *disk_manager_;
+    size_t page_index_{0};
+    int slot_{0};
+    std::vector<char> buffer_;
+  };
+
+  void Put(const Record &record);
+
+  // turns the active memtable into an immutable one if it is full
+  void RotateMemTable();
+
+  // background tasks
+  void Schedule(void (LSMTree::*task)());
+  void FlushOldestMemTable();
+  void Compact();
+
+  // writes the records produced by next (in key order, one per key) as a new run; nullptr if there are none
+  std::shared_ptr<SortedRun> WriteRun(const std::function<bool(Record *)> &next, size_t expected_records);
+
+  bool SearchRun(const SortedRun &run, const KeyType &key, hash_t hash, Record *record);
+
+  hash_t HashKey(const KeyType &key) const {
+    return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  }
+
+  size_t LevelCapacity(size_t level) const;
+
+  std::shared_ptr<const Version> GetVersion();
+
+  // member variable
+  std::string index_name_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  size_t memtable_capacity_;
+  size_t level0_max_runs_;
+  size_t size_ratio_;
+
+  // writers hold it shared while they add to memtable_, rotation holds it exclusively
+  ReaderWriterLatch memtable_latch_;
+  MemTable *memtable_;
+  std::atomic<uint64_t> next_sequence_{0};
+
+  // protects current_ and pending_tasks_
+  std::mutex version_latch_;
+  std::condition_variable background_cv_;
+  std::shared_ptr<const Version> current_;
+  size_t pending_tasks_{0};
+
+  // flushes must install their runs oldest first, and compactions must not overlap
+  std::mutex flush_latch_;
+  std::mutex compaction_latch_;
+
+  // declared last so that it is destroyed first: its destructor runs the tasks still queued
+  ThreadPool background_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/lsm_tree_index.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/index/lsm_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define LSMTREE_INDEX_TYPE LSMTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Unique index backed by an LSM tree, for tables with a high rate of inserts.
+ * Inserting an existing key replaces its RID.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class LSMTreeIndex : public Index {
+ public:
+  LSMTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  LSMTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_epsilon_tree_internal_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_EPSILON_TREE_INTERNAL_PAGE_TYPE BEpsilonTreeInternalPage<KeyType, ValueType, KeyComparator>
+#define B_EPSILON_INTERNAL_PAGE_HEADER_SIZE 32
+
+/** Kinds of pending updates buffered in a B-epsilon tree. */
+enum class BEpsilonMessageType : int32_t {
+  INSERT = 0,  // insert the value unless the key is present by the time the message is applied
+  UPSERT,      // insert the value, or overwrite the current one
+  DELETE       // remove the key if present
+};
+
+/** A buffered update of a single key. */
+template <typename KeyType, typename ValueType>
+struct BEpsilonMessage {
+  KeyType key_;
+  ValueType value_;
+  BEpsilonMessageType type_;
+};
+
+/**
+ * Internal node of a B-epsilon tree: the pivots of a B+ tree internal page
+ * (n keys and n child page ids, the first key is invalid, see
+ * BPlusTreeInternalPage) plus a buffer of pending messages for the subtree.
+ *
+ * Max size is the maximal fanout, which stays small so most of the page is
+ * left for the buffer. Messages are kept sorted by key with at most one
+ * message per key; they are handed to a child in one batch once the buffer
+ * overflows. The node is edited by loading pivots and messages into vectors
+ * and storing them back.
+ *
+ * Internal page format (size in byte, 32 bytes of header):
+ *  --------------------------------------------------------------------------------
+ * | BPlusTreePage HEADER (24) | BufferSize (4) | BufferCapacity (4) |
+ *  --------------------------------------------------------------------------------
+ * | KEY(1)+PAGE_ID(1) | ... | KEY(max_size)+PAGE_ID(max_size) | MESSAGE(1) | ... |
+ *  --------------------------------------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BEpsilonTreeInternalPage : public BPlusTreePage {
+  using Pivot = std::pair<KeyType, page_id_t>;
+  using Message = BEpsilonMessage<KeyType, ValueType>;
+
+ public:
+  // must call initialize method after "create" a new node
+  void Init(page_id_t page_id, int max_fanout);
+
+  /** @return how many messages fit next to max_fanout pivots */
+  static int BufferCapacity(int max_fanout);
+
+  int GetBufferSize() const { return buffer_size_; }
+  int GetBufferCapacity() const { return buffer_capacity_; }
+
+  /** @return the child whose subtree covers the key */
+  page_id_t LookupChild(const KeyType &key, const KeyComparator &comparator) const;
+
+  /** @return the pending message for the key, or nullptr if there is none */
+  const Message *FindMessage(const KeyType &key, const KeyComparator &comparator) const;
+
+  /**
+   * Buffers a message for a key that has none yet.
+   * @return false if the buffer is full
+   */
+  bool InsertMessage(const Message &message, const KeyComparator &comparator);
+
+  /** @return the pending message for the key, or nullptr if there is none */
+  Message *FindMessage(const KeyType &key, const KeyComparator &comparator) {
+    return const_cast<Message *>(static_cast<const BEpsilonTreeInternalPage *>(this)->FindMessage(key, comparator));
+  }
+
+  /** Copies the pivots and the buffered messages out of the node. */
+  void Load(std::vector<Pivot> *pivots, std::vector<Message> *messages) const;
+
+  /** Replaces the content of the node; both must fit, see GetMaxSize() and GetBufferCapacity(). */
+  void Store(const std::vector<Pivot> &pivots, const std::vector<Message> &messages);
+
+ private:
+  const Pivot *PivotArray() const { return reinterpret_cast<const Pivot *>(data_); }
+  const Message *MessageArray() const {
+    return reinterpret_cast<const Message *>(data_ + GetMaxSize() * sizeof(Pivot));
+  }
+
+  int buffer_size_;
+  int buffer_capacity_;
+  char data_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_link_tree_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_LINK_TREE_PAGE_TYPE BLinkTreePage<KeyType, ValueType, KeyComparator>
+#define B_LINK_PAGE_HEADER_SIZE 24
+#define B_LINK_PAGE_SIZE ((PAGE_SIZE - B_LINK_PAGE_HEADER_SIZE - sizeof(KeyType)) / sizeof(MappingType))
+
+/**
+ * Node of a Lehman-Yao B-link tree. Leaf nodes map keys to values, internal
+ * nodes map keys to child page ids; both share this layout.
+ *
+ * Every node covers the key range [low key, high key) and links to its right
+ * sibling on the same level. The rightmost node of a level has no right
+ * sibling and an unbounded high key. A split moves the upper half of a node
+ * into a new right sibling and lowers the high key of the node before the
+ * separator reaches the parent, so a search that arrives at a node whose high
+ * key is <= the search key simply follows the right link.
+ *
+ * Internal nodes store n keys and n child pointers where the first key is
+ * only kept as the low key of the node and ignored by lookups, like in
+ * BPlusTreeInternalPage. Nodes are never merged, removal just takes the entry
+ * out of its leaf.
+ *
+ * Page format (size in byte, 24 bytes of header followed by the high key):
+ *  ---------------------------------------------------------------------------------------
+ * | PageType (4) | Level (4) | CurrentSize (4) | MaxSize (4) | PageId (4) | RightPageId (4) |
+ *  ---------------------------------------------------------------------------------------
+ * | HighKey | KEY(1)+VALUE(1) | KEY(2)+VALUE(2) | ... | KEY(n)+VALUE(n) |
+ *  ---------------------------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTreePage {
+ public:
+  // must call initialize method after "create" a new node; level 0 holds the leaves
+  void Init(page_id_t page_id, int level, int max_size = B_LINK_PAGE_SIZE);
+
+  bool IsLeafPage() const { return page_type_ == IndexPageType::LEAF_PAGE; }
+  int GetLevel() const { return level_; }
+  int GetSize() const { return size_; }
+  int GetMaxSize() const { return max_size_; }
+  page_id_t GetPageId() const { return page_id_; }
+  page_id_t GetRightPageId() const { return right_page_id_; }
+
+  const KeyType &KeyAt(int index) const { return array_[index].first; }
+  const ValueType &ValueAt(int index) const { return array_[index].second; }
+  const MappingType &GetItem(int index) const { return array_[index]; }
+
+  // true if the key lies at or beyond the high key, i.e. the search has to move right
+  bool IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const;
+
+  // index of the first key that is >= the given key, or the size if there is none
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  // internal nodes only: the child whose subtree covers the key
+  ValueType LookupChild(const KeyType &key, const KeyComparator &comparator) const;
+
+  // internal nodes only: turn this node into a root with two children
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  // puts the pair at its sorted position, the node must not be full
+  void Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  void RemoveAt(int index);
+
+  /**
+   * Moves the upper half of this node into the freshly initialized recipient, links the recipient in as the right
+   * sibling and hands it the old high key.
+   * @return the separator, which is the new high key of this node and the low key of the recipient
+   */
+  KeyType MoveHalfTo(BLinkTreePage *recipient);
+
+ private:
+  IndexPageType page_type_;
+  int level_;
+  int size_;
+  int max_size_;
+  page_id_t page_id_;
+  page_id_t right_page_id_;
+  KeyType high_key_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -24,7 +24,10 @@ namespace bustub {
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys are unique within a leaf unless the tree allows duplicates: then
+ * a key with a few values has one adjacent entry per value, all on the same
+ * leaf, and a key with more values has a single entry whose value refers to a
+ * posting list.
  *
  * Leaf page format (keys are stored in order):
  *  ----------------------------------------------------------------------
@@ -51,14 +54,17 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   KeyType KeyAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
   const MappingType &GetItem(int index);
+  void SetValueAt(int index, const ValueType &value);
 
   // insert and delete methods
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
   bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+  void RemoveAt(int index);
 
   // Split and Merge utility methods
-  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  void MoveHalfTo(BPlusTreeLeafPage *recipient, const KeyComparator &comparator);
   void MoveAllTo(BPlusTreeLeafPage *recipient);
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
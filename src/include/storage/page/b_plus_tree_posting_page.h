@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 16
+
+/**
+ * Holds (part of) the posting list of a duplicate key in a non-unique B+ tree.
+ *
+ * A key with only a few RIDs keeps them inline as adjacent leaf entries (see BPLUSTREE_INLINE_POSTING_SIZE). Once one
+ * more RID shows up, those entries are replaced by a single one whose value refers to the head of a chain of posting
+ * pages, see MakeReference(). The list only moves back inline when it shrinks to one RID. The RIDs of the whole chain
+ * are kept sorted; each page covers a contiguous range and is split when it runs out of space, so a hot key simply
+ * grows its chain.
+ *
+ * RIDs are stored as LEB128 varints of the delta to the previous RID on the same page (the first RID of a page is
+ * stored relative to zero), so RIDs of rows living on the same table page take two or three bytes each.
+ *
+ * Posting page format (size in byte, 16 bytes of header):
+ *  ----------------------------------------------------------------------------------
+ * | PageId (4) | NextPageId (4) | Count (4) | DataSize (4) | DELTA(1) | DELTA(2) | ... |
+ *  ----------------------------------------------------------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  /** Slot number marking a leaf value as a reference to a posting list instead of a real RID. */
+  static constexpr uint32_t REFERENCE_SLOT_NUM = UINT32_MAX;
+
+  // After creating a new posting page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id);
+
+  page_id_t GetPageId() const { return page_id_; }
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the number of RIDs stored on this page */
+  int GetCount() const { return count_; }
+
+  /** Decodes the RIDs of this page in sorted order and appends them to result. */
+  void Decode(std::vector<RID> *result) const;
+
+  /**
+   * Replaces the content of this page with rids[begin, end), which must be sorted.
+   * @return the number of RIDs that fit on the page, starting from begin
+   */
+  size_t Encode(const std::vector<RID> &rids, size_t begin, size_t end);
+
+  /** @return the leaf value that refers to the posting list starting at head_page_id */
+  static RID MakeReference(page_id_t head_page_id) { return RID(head_page_id, REFERENCE_SLOT_NUM); }
+
+  /** @return true if the leaf value is a reference to a posting list rather than a RID */
+  static bool IsReference(const RID &value) { return value.GetSlotNum() == REFERENCE_SLOT_NUM; }
+
+  /** Appends every RID of the posting list starting at head_page_id to result, in sorted order. */
+  static void ReadAll(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id, std::vector<RID> *result);
+
+ private:
+  static constexpr size_t DATA_CAPACITY = PAGE_SIZE - POSTING_PAGE_HEADER_SIZE;
+
+  page_id_t page_id_;
+  page_id_t next_page_id_;
+  int count_;
+  int data_size_;
+  uint8_t data_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table_block_page.h
+//
+// Identification: src/include/storage/page/cuckoo_hash_table_block_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/** Fingerprint of an empty cuckoo hash table slot. */
+#define CUCKOO_FINGERPRINT_EMPTY 0x00
+
+/**
+ * Block page of a cuckoo hash table: CUCKOO_BLOCK_BUCKETS buckets of
+ * CUCKOO_BUCKET_SLOTS slots each. Every slot has a one byte fingerprint, the
+ * top 7 bits of the hash of its key with the high bit set, or
+ * CUCKOO_FINGERPRINT_EMPTY. Only the keys of slots with a matching
+ * fingerprint are compared. A freshly allocated (zeroed) page is a block of
+ * empty buckets.
+ *
+ * Block page format:
+ *  ---------------------------------------------------------------------------------------------
+ * | FINGERPRINTS OF BUCKET(1) | ... | FINGERPRINTS OF BUCKET(n) | PAIRS OF BUCKET(1) | ... | PAIRS OF BUCKET(n)
+ *  ---------------------------------------------------------------------------------------------
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class CuckooHashTableBlockPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  CuckooHashTableBlockPage() = delete;
+
+  /**
+   * @param hash the hash of a key
+   * @return the fingerprint of the key
+   */
+  static uint8_t Fingerprint(uint64_t hash) { return static_cast<uint8_t>(0x80 | (hash >> 57)); }
+
+  /**
+   * Collects the values of a key in a bucket.
+   * @return true if at least one value was found
+   */
+  bool GetValue(size_t bucket, const KeyType &key, uint8_t fingerprint, const KeyComparator &cmp,
+                std::vector<ValueType> *result) const;
+
+  /** @return true if the pair is stored in the bucket */
+  bool Contains(size_t bucket, const KeyType &key, const ValueType &value, uint8_t fingerprint,
+                const KeyComparator &cmp) const;
+
+  /**
+   * Adds a pair to a free slot of the bucket.
+   * @return false if the bucket is full
+   */
+  bool Insert(size_t bucket, const KeyType &key, const ValueType &value, uint8_t fingerprint);
+
+  /** @return false if the pair was not in the bucket */
+  bool Remove(size_t bucket, const KeyType &key, const ValueType &value, uint8_t fingerprint,
+              const KeyComparator &cmp);
+
+  /** Overwrites a slot, occupied or not. */
+  void SetAt(size_t bucket, size_t slot, const KeyType &key, const ValueType &value, uint8_t fingerprint);
+
+  KeyType KeyAt(size_t bucket, size_t slot) const { return array_[bucket][slot].first; }
+  ValueType ValueAt(size_t bucket, size_t slot) const { return array_[bucket][slot].second; }
+  bool IsOccupied(size_t bucket, size_t slot) const {
+    return fingerprints_[bucket][slot] != CUCKOO_FINGERPRINT_EMPTY;
+  }
+
+  /** @return the number of occupied slots of the bucket */
+  size_t Size(size_t bucket) const;
+
+ private:
+  uint8_t fingerprints_[CUCKOO_BLOCK_BUCKETS][CUCKOO_BUCKET_SLOTS];
+  MappingType array_[CUCKOO_BLOCK_BUCKETS][CUCKOO_BUCKET_SLOTS];
+};
+
+}  // namespace bustub
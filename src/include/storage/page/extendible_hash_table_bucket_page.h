@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/extendible_hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Bucket page of an extendible hash table. Supports non-unique keys, but
+ * every (key, value) pair is stored once. Pairs are kept unordered and
+ * densely packed: removing a pair moves the last pair into its slot.
+ *
+ * Bucket page format:
+ *  ------------------------------------------------------------------------------
+ * | Size (4) | MaxSize (4) | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ------------------------------------------------------------------------------
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHashTableBucketPage() = delete;
+
+  /**
+   * Init method after creating a new bucket page.
+   * @param max_size the number of pairs the bucket holds, at most BUCKET_ARRAY_SIZE
+   */
+  void Init(uint32_t max_size = BUCKET_ARRAY_SIZE);
+
+  /**
+   * Collects the values of a key.
+   * @return true if at least one value was found
+   */
+  bool GetValue(const KeyType &key, const KeyComparator &cmp, std::vector<ValueType> *result) const;
+
+  /** @return true if the pair is stored in this bucket */
+  bool Contains(const KeyType &key, const ValueType &value, const KeyComparator &cmp) const;
+
+  /**
+   * Adds a pair, which must not be present yet.
+   * @return false if the bucket is full
+   */
+  bool Insert(const KeyType &key, const ValueType &value);
+
+  /** @return false if the pair was not present */
+  bool Remove(const KeyType &key, const ValueType &value, const KeyComparator &cmp);
+
+  void RemoveAt(uint32_t bucket_idx);
+
+  KeyType KeyAt(uint32_t bucket_idx) const { return array_[bucket_idx].first; }
+  ValueType ValueAt(uint32_t bucket_idx) const { return array_[bucket_idx].second; }
+
+  uint32_t Size() const { return size_; }
+  bool IsFull() const { return size_ == max_size_; }
+  bool IsEmpty() const { return size_ == 0; }
+
+ private:
+  uint32_t size_;
+  uint32_t max_size_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/extendible_hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+#define DIRECTORY_MAX_DEPTH 9
+#define DIRECTORY_ARRAY_SIZE (1 << DIRECTORY_MAX_DEPTH)
+
+/**
+ * Directory page of an extendible hash table. Slot i holds the bucket of all
+ * hashes whose lowest global_depth bits are i. A bucket with local depth d
+ * is shared by the 2^(global_depth - d) slots that agree on the lowest d bits.
+ *
+ * Directory format (size in byte):
+ * ----------------------------------------------------------------------------------------
+ * | PageId (4) | MaxDepth (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048)
+ * ----------------------------------------------------------------------------------------
+ */
+class ExtendibleHashTableDirectoryPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHashTableDirectoryPage() = delete;
+
+  /**
+   * Init method after creating a new directory page, with global depth 0 and no bucket.
+   * @param page_id the page id of this page
+   * @param max_depth the largest global depth, at most DIRECTORY_MAX_DEPTH
+   */
+  void Init(page_id_t page_id, uint32_t max_depth = DIRECTORY_MAX_DEPTH);
+
+  /** @return the slot of the bucket responsible for the hash */
+  uint32_t HashToBucketIndex(uint32_t hash) const { return hash & GetGlobalDepthMask(); }
+
+  page_id_t GetBucketPageId(uint32_t bucket_index) const { return bucket_page_ids_[bucket_index]; }
+  void SetBucketPageId(uint32_t bucket_index, page_id_t bucket_page_id) { bucket_page_ids_[bucket_index] = bucket_page_id; }
+
+  uint32_t GetLocalDepth(uint32_t bucket_index) const { return local_depths_[bucket_index]; }
+  void SetLocalDepth(uint32_t bucket_index, uint8_t local_depth) { local_depths_[bucket_index] = local_depth; }
+
+  /** @return the slot that shares all but the highest of the local depth bits with the given slot */
+  uint32_t GetSplitImageIndex(uint32_t bucket_index) const;
+
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+  uint32_t GetMaxDepth() const { return max_depth_; }
+  uint32_t GetGlobalDepthMask() const { return (1U << global_depth_) - 1; }
+
+  /** @return the number of slots in use */
+  uint32_t Size() const { return 1U << global_depth_; }
+
+  /** Doubles the directory; the new upper half points to the same buckets as the lower half. */
+  void IncrGlobalDepth();
+
+  /** Halves the directory; only valid if CanShrink() */
+  void DecrGlobalDepth();
+
+  /** @return true if no bucket uses all global depth bits */
+  bool CanShrink() const;
+
+  page_id_t GetPageId() const { return page_id_; }
+
+  /** Checks that all slots of every bucket agree on its local depth and that no local depth exceeds the global one. */
+  void VerifyIntegrity() const;
+
+ private:
+  page_id_t page_id_;
+  uint32_t max_depth_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_header_page.h
+//
+// Identification: src/include/storage/page/extendible_hash_table_header_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+#define HEADER_MAX_DEPTH 9
+#define HEADER_ARRAY_SIZE (1 << HEADER_MAX_DEPTH)
+
+/**
+ * Root page of an extendible hash table. It picks the directory of a key by
+ * the top max_depth bits of its 32 bit hash. Directories are created on
+ * first use and never removed, so an entry only ever changes from
+ * INVALID_PAGE_ID to a directory page id.
+ *
+ * Header format (size in byte):
+ * ------------------------------------------------------------------------------
+ * | PageId (4) | MaxDepth (4) | DirectoryPageIds (4 * 512) | Free (2040)
+ * ------------------------------------------------------------------------------
+ */
+class ExtendibleHashTableHeaderPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHashTableHeaderPage() = delete;
+
+  /**
+   * Init method after creating a new header page.
+   * @param page_id the page id of this page
+   * @param max_depth the number of hash bits used to pick a directory, at most HEADER_MAX_DEPTH
+   */
+  void Init(page_id_t page_id, uint32_t max_depth = HEADER_MAX_DEPTH);
+
+  /** @return the index of the directory responsible for the hash */
+  uint32_t HashToDirectoryIndex(uint32_t hash) const;
+
+  /** @return the page id of a directory, INVALID_PAGE_ID if it does not exist yet */
+  page_id_t GetDirectoryPageId(uint32_t directory_index) const;
+
+  void SetDirectoryPageId(uint32_t directory_index, page_id_t directory_page_id);
+
+  /** @return the number of directories this header can point to */
+  uint32_t MaxSize() const { return 1U << max_depth_; }
+
+  page_id_t GetPageId() const { return page_id_; }
+
+ private:
+  page_id_t page_id_;
+  uint32_t max_depth_;
+  page_id_t directory_page_ids_[HEADER_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -21,14 +21,46 @@
 #include "storage/page/hash_table_page_defs.h"
 
 namespace bustub {
+
+/** Number of slots whose fingerprints are compared at once. */
+#if defined(__AVX2__)
+#define HASH_TABLE_BLOCK_GROUP_SIZE 32
+#else
+#define HASH_TABLE_BLOCK_GROUP_SIZE 16
+#endif
+static_assert(HASH_TABLE_BLOCK_GROUP_SIZE - 1 <= BLOCK_FINGERPRINT_PADDING,
+              "a group that starts at the last slot must stay within the fingerprints");
+
+/** Fingerprint of a slot that was never occupied. */
+#define HASH_TABLE_FINGERPRINT_EMPTY 0x00
+/** Fingerprint of a slot whose pair was removed. */
+#define HASH_TABLE_FINGERPRINT_TOMBSTONE 0x01
+
 /**
  * Store indexed key and and value together within block page. Supports
  * non-unique keys.
  *
+ * Every slot also has a one byte fingerprint: the top 7 bits of the hash of
+ * its key with the high bit set, or one of the values above. Probing compares
+ * the fingerprints of a whole group of slots with a single SIMD instruction
+ * and only reads the keys of the slots that match, in the style of Swiss
+ * tables (Abseil flat_hash_map).
+ *
+ * Under linear hashing a block is the primary page of a bucket, and the
+ * pairs that do not fit into it go to a chain of overflow blocks.
+ *
+ * Inserts and removes must hold the write latch of the page. Lookups may
+ * read without a latch through ReadGroup: writers make the version odd while
+ * they change the block, and readers retry whenever the version changed
+ * under them (a seqlock).
+ *
  * Block page format (keys are stored in order):
- *  ----------------------------------------------------------------
+ *  -----------------------------------------------------------------------------------------------------
+ * | NEXT_PAGE_ID | VERSION | OCCUPIED | READABLE | FINGERPRINT(1) | ... | FINGERPRINT(n) | PADDING | ...
+ *  -----------------------------------------------------------------------------------------------------
+ *  -----------------------------------------------------
  * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  -----------------------------------------------------
  *
  *  Here '+' means concatenation.
  *
@@ -39,6 +71,21 @@ class HashTableBlockPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBlockPage() = delete;
 
+  /**
+   * Empties the block and unlinks it from its overflow chain.
+   */
+  void Init();
+
+  /**
+   * @return the page id of the next overflow block of the bucket, or INVALID_PAGE_ID
+   */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  /**
+   * @param next_page_id the page id of the next overflow block of the bucket
+   */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
   /**
    * Gets the key at an index in the block.
    *
@@ -57,18 +104,19 @@ class HashTableBlockPage {
 
   /**
    * Attempts to insert a key and value into an index in the block.
-   * The insert is thread safe. It uses compare and swap to claim the index,
-   * and then writes the key and value into the index, and then marks the
+   * The insert writes the key and value into the index, and then marks the
    * index as readable.
    *
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param fingerprint fingerprint of the key, see Fingerprint(); pairs inserted without one are not found by
+   * MatchGroup
    * @return If the value is inserted successfully, it returns true. If the
-   * index is marked as occupied before the key and value can be inserted,
-   * Insert returns false.
+   * index already holds a readable pair, Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+              uint8_t fingerprint = Fingerprint(0));
 
   /**
    * Removes a key and value at index.
@@ -93,11 +141,54 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * @param hash the hash of a key
+   * @return the fingerprint of the key
+   */
+  static uint8_t Fingerprint(uint64_t hash) { return static_cast<uint8_t>(0x80 | (hash >> 57)); }
+
+  /**
+   * Compares the fingerprints of a group of slots at once.
+   *
+   * @param bucket_ind index of the first slot of the group
+   * @param n number of slots in the group, at most HASH_TABLE_BLOCK_GROUP_SIZE and not past the end of the block
+   * @param fingerprint fingerprint to look for
+   * @param[out] matches bit i is set if slot bucket_ind + i has the fingerprint
+   * @param[out] empties bit i is set if slot bucket_ind + i has never been occupied
+   */
+  void MatchGroup(slot_offset_t bucket_ind, size_t n, uint8_t fingerprint, uint32_t *matches, uint32_t *empties) const;
+
+  /**
+   * Starts loading the fingerprint and the pair of a slot into the cache.
+   *
+   * @param bucket_ind index of the slot
+   */
+  void Prefetch(slot_offset_t bucket_ind) const {
+    __builtin_prefetch(fingerprints_ + bucket_ind);
+    __builtin_prefetch(array_ + bucket_ind);
+  }
+
+  /**
+   * Like MatchGroup, but also copies the pairs of the matching slots, and is safe without a latch on the page.
+   *
+   * @param[out] pairs pairs[i] is the pair of slot bucket_ind + i if bit i of matches is set
+   */
+  void ReadGroup(slot_offset_t bucket_ind, size_t n, uint8_t fingerprint, uint32_t *matches, uint32_t *empties,
+                 MappingType *pairs) const;
+
  private:
+  // write latch held, see above
+  void BeginWrite();
+  void EndWrite();
+
+  page_id_t next_page_id_;
+  std::atomic<uint32_t> version_;
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  // the padding is always empty, and lets MatchGroup load a whole group at any slot
+  uint8_t fingerprints_[BLOCK_ARRAY_SIZE + BLOCK_FINGERPRINT_PADDING];
   MappingType array_[0];
 };
 
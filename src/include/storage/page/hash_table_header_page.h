@@ -22,6 +22,8 @@
 
 namespace bustub {
 
+#define HEADER_MAX_BLOCKS ((PAGE_SIZE - 32) / sizeof(page_id_t))
+
 /**
  *
  * Header Page for linear probing hash table.
@@ -70,7 +72,7 @@ class HashTableHeaderPage {
   void SetLSN(lsn_t lsn);
 
   /**
-   * Adds a block page_id to the end of header page
+   * Adds a block page_id to the end of header page; the page holds at most HEADER_MAX_BLOCKS of them
    *
    * @param page_id page_id to be added
    */
@@ -90,11 +92,11 @@ class HashTableHeaderPage {
   size_t NumBlocks();
 
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
-  __attribute__((unused)) page_id_t block_page_ids_[0];
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
+  page_id_t block_page_ids_[0];
 };
 
 }  // namespace bustub
@@ -14,11 +14,34 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
- * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+/** BLOCK_FINGERPRINT_PADDING is the number of bytes after the fingerprint of the last slot of a block page, so that
+ * a SIMD load of the fingerprints of up to 32 slots that starts at any slot stays within the fingerprints. */
+#define BLOCK_FINGERPRINT_PADDING 31
+
+/** BLOCK_PAGE_RESERVED_SIZE is the number of bytes of a block page that are not per slot: the next page id and the
+ * version (8), the fingerprint padding (31), rounding up the flags (2) and aligning the pairs (at most 7). */
+#define BLOCK_PAGE_RESERVED_SIZE (8 + BLOCK_FINGERPRINT_PADDING + 2 + 7)
+
+/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a block page. It is calculated from the
+ * size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value pair, we need two additional
+ * bits for occupied_ and readable_ and a one byte fingerprint. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 5) =
+ * PAGE_SIZE/(sizeof (MappingType) + 1.25) because 1.25 bytes = 10 bits is the space required to maintain the occupied
+ * and readable flags and the fingerprint of a key value pair.*/
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - BLOCK_PAGE_RESERVED_SIZE) / (4 * sizeof(MappingType) + 5))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs that fit into an extendible hash table bucket page after its
+ * 8 byte header. */
+#define BUCKET_ARRAY_SIZE ((PAGE_SIZE - 8) / sizeof(MappingType))
+
+#define HASH_TABLE_BUCKET_TYPE ExtendibleHashTableBucketPage<KeyType, ValueType, KeyComparator>
+
+/** CUCKOO_BUCKET_SLOTS is the number of (key, value) pairs in a bucket of a cuckoo hash table. */
+#define CUCKOO_BUCKET_SLOTS 4
+
+/** CUCKOO_BLOCK_BUCKETS is the number of cuckoo hash table buckets that fit into a block page, with a one byte
+ * fingerprint per slot and a few bytes left for aligning the pairs. */
+#define CUCKOO_BLOCK_BUCKETS ((PAGE_SIZE - 8) / (CUCKOO_BUCKET_SLOTS * (sizeof(MappingType) + 1)))
+
+#define CUCKOO_HASH_TABLE_BLOCK_TYPE CuckooHashTableBlockPage<KeyType, ValueType, KeyComparator>
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/lsm_run_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define LSM_RUN_PAGE_TYPE LSMRunPage<KeyType, ValueType, KeyComparator>
+#define LSM_RUN_PAGE_HEADER_SIZE 8
+#define LSM_RUN_PAGE_SIZE \
+  static_cast<int>((PAGE_SIZE - LSM_RUN_PAGE_HEADER_SIZE) / sizeof(LSMRecord<KeyType, ValueType>))
+
+/** The latest state of a key in an LSM tree: a value, or a tombstone if the key was deleted. */
+template <typename KeyType, typename ValueType>
+struct LSMRecord {
+  KeyType key_;
+  ValueType value_;
+  bool deleted_;
+};
+
+/**
+ * Data page of a sorted run of an LSM tree. A run is written once, front to
+ * back, and never modified; its pages hold records sorted by key with at most
+ * one record per key.
+ *
+ * Run page format (size in byte, 8 bytes of header):
+ *  ----------------------------------------------------
+ * | Size (4) | Unused (4) | RECORD(1) | ... | RECORD(n) |
+ *  ----------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class LSMRunPage {
+  using Record = LSMRecord<KeyType, ValueType>;
+
+ public:
+  void Init();
+
+  int GetSize() const { return size_; }
+  bool IsFull() const { return size_ == LSM_RUN_PAGE_SIZE; }
+  const Record &RecordAt(int index) const { return array_[index]; }
+
+  // records must be appended in key order
+  void Append(const Record &record);
+
+  // binary search for the record of a key
+  bool Lookup(const KeyType &key, Record *record, const KeyComparator &comparator) const;
+
+ private:
+  int32_t size_;
+  int32_t unused_;
+  Record array_[0];
+};
+
+}  // namespace bustub
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
@@ -20,14 +22,52 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /** Initializes an empty page of page_size bytes. */
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Copies a tuple to the end of the free space.
+   * @param tuple the tuple to insert
+   * @param[out] out the location of the tuple
+   * @return false if the tuple does not fit in the free space
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    if (GetFreeSpacePointer() < OFFSET_FREE_SPACE_END + size) {
+      return false;
+    }
+    uint32_t offset = GetFreeSpacePointer() - size;
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
+  }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /** Reads the tuple at offset, which must have been returned by Insert(). */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** @return the offset of the last inserted tuple, equal to the page size if the page is empty */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /** @return the offset of the tuple inserted before the one at offset, equal to the page size if there is none */
+  uint32_t GetNextOffset(size_t offset) {
+    return static_cast<uint32_t>(offset) + sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr uint32_t OFFSET_FREE_SPACE = sizeof(page_id_t) + sizeof(lsn_t);
+  static constexpr uint32_t OFFSET_FREE_SPACE_END = OFFSET_FREE_SPACE + sizeof(uint32_t);
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
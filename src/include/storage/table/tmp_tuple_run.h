@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.h
+//
+// Identification: src/include/storage/table/tmp_tuple_run.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/** SpillStats counts what an operator wrote to TmpTupleRuns. */
+struct SpillStats {
+  /** The number of runs written. */
+  size_t num_runs_{0};
+  /** The number of tuples written, counting a tuple once each time it is written. */
+  size_t num_tuples_{0};
+  /** The number of pages written. */
+  size_t num_pages_{0};
+  /** The number of times the operator partitioned a run that did not fit in memory again. */
+  size_t num_repartitions_{0};
+  /** The deepest level of repartitioning, 1 if the input was partitioned once. */
+  size_t max_level_{0};
+  /** The number of passes that merged sorted runs into longer runs before the final merge. */
+  size_t num_merge_passes_{0};
+};
+
+/**
+ * TmpTupleRun is a sequence of tuples written to TmpTuplePages, for operators that spill their intermediate results
+ * to disk. Only the page being written is pinned, so the buffer pool may write the others out; all the pages are
+ * deleted with the run.
+ */
+class TmpTupleRun {
+ public:
+  /** Creates an empty run whose pages are allocated from bpm. */
+  explicit TmpTupleRun(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleRun();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleRun);
+
+  /** Appends a tuple to the run, throws an OUT_OF_MEMORY exception if no page can be allocated for it. */
+  void Append(const Tuple &tuple);
+
+  /** Unpins the page being written. Must be called before the run is read. */
+  void Finish();
+
+  /** @return the number of tuples in the run */
+  size_t GetNumTuples() const { return num_tuples_; }
+
+  /** @return the number of bytes taken by the tuples of the run */
+  size_t GetNumBytes() const { return num_bytes_; }
+
+  /** @return the number of pages of the run */
+  size_t GetNumPages() const { return page_ids_.size(); }
+
+  /** Reader reads back the tuples of a finished run in the order of their insertion, pinning one page at a time. */
+  class Reader {
+   public:
+    explicit Reader(const TmpTupleRun *run) : run_(run) {}
+
+    ~Reader();
+
+    DISALLOW_COPY_AND_MOVE(Reader);
+
+    /** Reads the next tuple, @return false once all the tuples were read */
+    bool Next(Tuple *tuple);
+
+   private:
+    const TmpTupleRun *run_;
+    size_t page_idx_{0};
+    TmpTuplePage *page_{nullptr};
+    /** The offsets of the tuples of the page yet to be read, the next one last. */
+    std::vector<uint32_t> offsets_;
+  };
+
+ private:
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  /** The last page, pinned while the run is being written. */
+  TmpTuplePage *page_{nullptr};
+  size_t num_tuples_{0};
+  size_t num_bytes_{0};
+};
+
+}  // namespace bustub
@@ -79,12 +79,18 @@ void DiskManager::ShutDown() {
 /**
  * Write the contents of the specified page into disk file
  */
-void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+void DiskManager::WritePage(page_id_t page_id, const char *page_data) { WritePages(page_id, page_data, 1); }
+
+/**
+ * Write the contents of consecutive pages into disk file
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const char *page_data, size_t num_pages) {
+  size_t offset = static_cast<size_t>(first_page_id) * PAGE_SIZE;
+  std::lock_guard<std::mutex> guard(db_io_latch_);
   // set write cursor to offset
-  num_writes_ += 1;
+  num_writes_ += num_pages;
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(page_data, num_pages * PAGE_SIZE);
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
@@ -99,6 +105,7 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   int offset = page_id * PAGE_SIZE;
+  std::lock_guard<std::mutex> guard(db_io_latch_);
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
@@ -190,6 +197,8 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
  */
 page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
 
+page_id_t DiskManager::AllocatePages(size_t num_pages) { return next_page_id_.fetch_add(num_pages); }
+
 /**
  * Deallocate page (operations like drop index/table)
  * Need bitmap in header page for tracking pages
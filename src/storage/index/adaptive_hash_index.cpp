@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_hash_index.cpp
+//
+// Identification: src/storage/index/adaptive_hash_index.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_hash_index.h"
+
+#include "common/util/hash_util.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+ADAPTIVE_HASH_INDEX_TYPE::AdaptiveHashIndex(const KeyComparator &comparator, size_t num_entries)
+    : comparator_(comparator) {
+  // a power of two, so that the hash is masked instead of divided
+  size_t capacity = 1;
+  while (capacity < num_entries) {
+    capacity *= 2;
+  }
+  entries_.resize(capacity);
+  mask_ = capacity - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint64_t ADAPTIVE_HASH_INDEX_TYPE::Hash(const KeyType &key) const {
+  return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool ADAPTIVE_HASH_INDEX_TYPE::Find(const KeyType &key, page_id_t *leaf_page_id, int *slot) {
+  uint64_t hash = Hash(key);
+  std::lock_guard<std::mutex> guard(latch_);
+  const Entry &entry = entries_[hash & mask_];
+  if (entry.leaf_page_id_ == INVALID_PAGE_ID || entry.hash_ != hash || comparator_(entry.key_, key) != 0) {
+    return false;
+  }
+  auto it = leaves_.find(entry.leaf_page_id_);
+  if (it == leaves_.end() || it->second.epoch_ != entry.epoch_) {
+    return false;
+  }
+  *leaf_page_id = entry.leaf_page_id_;
+  *slot = entry.slot_;
+  num_hits_++;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void ADAPTIVE_HASH_INDEX_TYPE::RecordTraversal(LeafPage *leaf_page, const KeyType &key, int slot) {
+  page_id_t leaf_page_id = leaf_page->GetPageId();
+  std::lock_guard<std::mutex> guard(latch_);
+  LeafInfo &info = GetLeafInfo(leaf_page_id);
+  if (info.indexed_) {
+    if (slot >= 0) {
+      Add(key, Hash(key), leaf_page_id, &info, slot);
+    }
+    return;
+  }
+  if (++info.traversals_ < ADAPTIVE_HASH_BUILD_THRESHOLD) {
+    return;
+  }
+  // the leaf is hot: index all of its keys
+  for (int i = 0; i < leaf_page->GetSize(); i++) {
+    KeyType leaf_key = leaf_page->KeyAt(i);
+    Add(leaf_key, Hash(leaf_key), leaf_page_id, &info, i);
+  }
+  info.indexed_ = true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void ADAPTIVE_HASH_INDEX_TYPE::UpdateSlot(const KeyType &key, page_id_t leaf_page_id, int slot) {
+  uint64_t hash = Hash(key);
+  std::lock_guard<std::mutex> guard(latch_);
+  Entry &entry = entries_[hash & mask_];
+  if (entry.leaf_page_id_ == leaf_page_id && entry.hash_ == hash && comparator_(entry.key_, key) == 0) {
+    entry.slot_ = slot;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void ADAPTIVE_HASH_INDEX_TYPE::InvalidateLeaf(page_id_t leaf_page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // the leaf must become hot again before it is indexed again, and it gets a new epoch when it is seen next
+  leaves_.erase(leaf_page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename ADAPTIVE_HASH_INDEX_TYPE::LeafInfo &ADAPTIVE_HASH_INDEX_TYPE::GetLeafInfo(page_id_t leaf_page_id) {
+  auto it = leaves_.find(leaf_page_id);
+  if (it != leaves_.end()) {
+    return it->second;
+  }
+  // at most as many leaves have entries in the table as there are entries, so dropping all other leaves at twice
+  // that frees at least half of the map
+  if (leaves_.size() >= 2 * entries_.size()) {
+    for (auto cold = leaves_.begin(); cold != leaves_.end();) {
+      if (cold->second.num_entries_ > 0) {
+        ++cold;
+      } else {
+        cold = leaves_.erase(cold);
+      }
+    }
+  }
+  LeafInfo &info = leaves_[leaf_page_id];
+  info.epoch_ = next_epoch_++;
+  return info;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void ADAPTIVE_HASH_INDEX_TYPE::Add(const KeyType &key, uint64_t hash, page_id_t leaf_page_id, LeafInfo *info,
+                                   int slot) {
+  Entry &entry = entries_[hash & mask_];
+  if (entry.leaf_page_id_ != INVALID_PAGE_ID && entry.epoch_ == info->epoch_) {
+    // replacing an entry of the same leaf
+    info->num_entries_--;
+  } else if (entry.leaf_page_id_ != INVALID_PAGE_ID) {
+    auto it = leaves_.find(entry.leaf_page_id_);
+    if (it != leaves_.end() && it->second.epoch_ == entry.epoch_ && --it->second.num_entries_ == 0) {
+      // the last entry of that leaf is gone, forget the leaf until it becomes hot again
+      leaves_.erase(it);
+    }
+  }
+  entry.hash_ = hash;
+  entry.leaf_page_id_ = leaf_page_id;
+  entry.slot_ = slot;
+  entry.epoch_ = info->epoch_;
+  entry.key_ = key;
+  info->num_entries_++;
+}
+
+template class AdaptiveHashIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class AdaptiveHashIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class AdaptiveHashIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class AdaptiveHashIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class AdaptiveHashIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,855 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/storage/index/adaptive_radix_tree.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_radix_tree.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+// garbage is handed back to the allocator in batches of at least this many nodes
+static constexpr size_t ART_RETIRE_BATCH = 64;
+
+/*****************************************************************************
+ * NODES
+ *****************************************************************************/
+void ArtNode::SetPrefix(const uint8_t *prefix, uint32_t prefix_len) {
+  prefix_len_ = prefix_len;
+  if (prefix_len > 0) {
+    memcpy(prefix_, prefix, std::min<uint32_t>(prefix_len, ART_MAX_STORED_PREFIX));
+  }
+}
+
+void ArtNode::AddPrefixBefore(const ArtNode *node, uint8_t key) {
+  uint8_t prefix[ART_MAX_STORED_PREFIX];
+  uint32_t stored = std::min<uint32_t>(node->prefix_len_, ART_MAX_STORED_PREFIX);
+  memcpy(prefix, node->prefix_, stored);
+  if (stored < ART_MAX_STORED_PREFIX) {
+    prefix[stored++] = key;
+  }
+  for (uint32_t i = 0; i < prefix_len_ && stored < ART_MAX_STORED_PREFIX; i++) {
+    prefix[stored++] = prefix_[i];
+  }
+  memcpy(prefix_, prefix, stored);
+  prefix_len_ += node->prefix_len_ + 1;
+}
+
+uint64_t ArtNode::ReadLockOrRestart(bool *restart) const {
+  uint64_t version = version_.load();
+  while ((version & 0b10) == 0b10) {
+    std::this_thread::yield();
+    version = version_.load();
+  }
+  if ((version & 0b1) == 0b1) {
+    *restart = true;
+  }
+  return version;
+}
+
+void ArtNode::ReadUnlockOrRestart(uint64_t version, bool *restart) const {
+  // everything read under the optimistic lock must be read before the version is checked again
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (version != version_.load(std::memory_order_relaxed)) {
+    *restart = true;
+  }
+}
+
+void ArtNode::UpgradeToWriteLockOrRestart(uint64_t *version, bool *restart) {
+  if (version_.compare_exchange_strong(*version, *version + 0b10)) {
+    *version += 0b10;
+  } else {
+    *restart = true;
+  }
+}
+
+void ArtNode::WriteLockOrRestart(bool *restart) {
+  bool failed;
+  do {
+    uint64_t version = ReadLockOrRestart(restart);
+    if (*restart) {
+      return;
+    }
+    failed = false;
+    UpgradeToWriteLockOrRestart(&version, &failed);
+  } while (failed);
+}
+
+ArtNode48::ArtNode48(const uint8_t *prefix, uint32_t prefix_len) : ArtNode(ArtNodeType::NODE48, prefix, prefix_len) {
+  memset(child_index_, EMPTY_MARKER, sizeof(child_index_));
+  for (auto &child : children_) {
+    child.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+ArtNode256::ArtNode256(const uint8_t *prefix, uint32_t prefix_len)
+    : ArtNode(ArtNodeType::NODE256, prefix, prefix_len) {
+  for (auto &child : children_) {
+    child.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+ArtNode *AdaptiveRadixTree::MakeLeaf(const std::string &key, RID value) {
+  auto *leaf = new (::operator new(sizeof(ArtLeaf) + key.size())) ArtLeaf;
+  leaf->value_ = value;
+  leaf->key_len_ = static_cast<uint32_t>(key.size());
+  memcpy(leaf->key_, key.data(), key.size());
+  // leaves are told apart from inner nodes by the lowest pointer bit
+  return reinterpret_cast<ArtNode *>(reinterpret_cast<uintptr_t>(leaf) | 1);
+}
+
+bool AdaptiveRadixTree::LeafMatches(const ArtNode *node, const std::string &key) {
+  const ArtLeaf *leaf = AsLeaf(node);
+  return leaf->key_len_ == key.size() && memcmp(leaf->key_, key.data(), key.size()) == 0;
+}
+
+ArtNode *AdaptiveRadixTree::GetChild(const ArtNode *node, uint8_t key) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<const ArtNode4 *>(node);
+      for (uint16_t i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == key) {
+          return n->children_[i].load(std::memory_order_acquire);
+        }
+      }
+      return nullptr;
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<const ArtNode16 *>(node);
+#if defined(__SSE2__)
+      __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(key)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys_)));
+      unsigned bitfield = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1U << n->count_) - 1);
+      if (bitfield != 0) {
+        return n->children_[__builtin_ctz(bitfield)].load(std::memory_order_acquire);
+      }
+#else
+      for (uint16_t i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == key) {
+          return n->children_[i].load(std::memory_order_acquire);
+        }
+      }
+#endif
+      return nullptr;
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<const ArtNode48 *>(node);
+      uint8_t index = n->child_index_[key];
+      return index == ArtNode48::EMPTY_MARKER ? nullptr : n->children_[index].load(std::memory_order_acquire);
+    }
+    case ArtNodeType::NODE256:
+      return static_cast<const ArtNode256 *>(node)->children_[key].load(std::memory_order_acquire);
+  }
+  return nullptr;
+}
+
+ArtNode *AdaptiveRadixTree::GetAnyChild(const ArtNode *node) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<const ArtNode4 *>(node);
+      return n->count_ > 0 ? n->children_[0].load(std::memory_order_acquire) : nullptr;
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<const ArtNode16 *>(node);
+      return n->count_ > 0 ? n->children_[0].load(std::memory_order_acquire) : nullptr;
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<const ArtNode48 *>(node);
+      for (const auto &child : n->children_) {
+        ArtNode *result = child.load(std::memory_order_acquire);
+        if (result != nullptr) {
+          return result;
+        }
+      }
+      return nullptr;
+    }
+    case ArtNodeType::NODE256: {
+      auto *n = static_cast<const ArtNode256 *>(node);
+      for (const auto &child : n->children_) {
+        ArtNode *result = child.load(std::memory_order_acquire);
+        if (result != nullptr) {
+          return result;
+        }
+      }
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+ArtNode *AdaptiveRadixTree::GetSecondChild(const ArtNode *node, uint8_t key, uint8_t *second_key) {
+  for (int byte = 0; byte < 256; byte++) {
+    if (byte == key) {
+      continue;
+    }
+    ArtNode *child = GetChild(node, static_cast<uint8_t>(byte));
+    if (child != nullptr) {
+      *second_key = static_cast<uint8_t>(byte);
+      return child;
+    }
+  }
+  return nullptr;
+}
+
+bool AdaptiveRadixTree::IsFull(const ArtNode *node) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4:
+      return node->count_ == 4;
+    case ArtNodeType::NODE16:
+      return node->count_ == 16;
+    case ArtNodeType::NODE48:
+      return node->count_ == 48;
+    case ArtNodeType::NODE256:
+      return false;
+  }
+  return false;
+}
+
+/*
+ * Node4 and Node16 keep their keys sorted, so shift the larger keys (and
+ * their children) one slot to the right.
+ */
+template <typename NodeType>
+static void InsertSorted(NodeType *node, uint8_t key, ArtNode *child) {
+  uint16_t pos = 0;
+  while (pos < node->count_ && node->keys_[pos] < key) {
+    pos++;
+  }
+  for (uint16_t i = node->count_; i > pos; i--) {
+    node->keys_[i] = node->keys_[i - 1];
+    node->children_[i].store(node->children_[i - 1].load(std::memory_order_relaxed), std::memory_order_release);
+  }
+  node->keys_[pos] = key;
+  node->children_[pos].store(child, std::memory_order_release);
+  node->count_++;
+}
+
+template <typename NodeType>
+static void RemoveSorted(NodeType *node, uint8_t key) {
+  uint16_t pos = 0;
+  while (pos < node->count_ && node->keys_[pos] != key) {
+    pos++;
+  }
+  for (uint16_t i = pos; i + 1 < node->count_; i++) {
+    node->keys_[i] = node->keys_[i + 1];
+    node->children_[i].store(node->children_[i + 1].load(std::memory_order_relaxed), std::memory_order_release);
+  }
+  node->count_--;
+}
+
+void AdaptiveRadixTree::InsertChild(ArtNode *node, uint8_t key, ArtNode *child) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4:
+      InsertSorted(static_cast<ArtNode4 *>(node), key, child);
+      break;
+    case ArtNodeType::NODE16:
+      InsertSorted(static_cast<ArtNode16 *>(node), key, child);
+      break;
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<ArtNode48 *>(node);
+      // slots freed by removals are reused
+      uint8_t slot = 0;
+      while (n->children_[slot].load(std::memory_order_relaxed) != nullptr) {
+        slot++;
+      }
+      n->children_[slot].store(child, std::memory_order_release);
+      n->child_index_[key] = slot;
+      n->count_++;
+      break;
+    }
+    case ArtNodeType::NODE256:
+      static_cast<ArtNode256 *>(node)->children_[key].store(child, std::memory_order_release);
+      node->count_++;
+      break;
+  }
+}
+
+void AdaptiveRadixTree::ChangeChild(ArtNode *node, uint8_t key, ArtNode *child) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<ArtNode4 *>(node);
+      for (uint16_t i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == key) {
+          n->children_[i].store(child, std::memory_order_release);
+          return;
+        }
+      }
+      break;
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<ArtNode16 *>(node);
+      for (uint16_t i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == key) {
+          n->children_[i].store(child, std::memory_order_release);
+          return;
+        }
+      }
+      break;
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<ArtNode48 *>(node);
+      n->children_[n->child_index_[key]].store(child, std::memory_order_release);
+      break;
+    }
+    case ArtNodeType::NODE256:
+      static_cast<ArtNode256 *>(node)->children_[key].store(child, std::memory_order_release);
+      break;
+  }
+}
+
+void AdaptiveRadixTree::RemoveChild(ArtNode *node, uint8_t key) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4:
+      RemoveSorted(static_cast<ArtNode4 *>(node), key);
+      break;
+    case ArtNodeType::NODE16:
+      RemoveSorted(static_cast<ArtNode16 *>(node), key);
+      break;
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<ArtNode48 *>(node);
+      n->children_[n->child_index_[key]].store(nullptr, std::memory_order_release);
+      n->child_index_[key] = ArtNode48::EMPTY_MARKER;
+      n->count_--;
+      break;
+    }
+    case ArtNodeType::NODE256:
+      static_cast<ArtNode256 *>(node)->children_[key].store(nullptr, std::memory_order_release);
+      node->count_--;
+      break;
+  }
+}
+
+/*
+ * Copy a full node into a node of the next larger kind. The caller replaces
+ * the old node in its parent and retires it.
+ */
+ArtNode *AdaptiveRadixTree::Grow(const ArtNode *node) {
+  switch (node->type_) {
+    case ArtNodeType::NODE4: {
+      auto *n = static_cast<const ArtNode4 *>(node);
+      auto *grown = new ArtNode16(n->prefix_, n->prefix_len_);
+      for (uint16_t i = 0; i < n->count_; i++) {
+        grown->keys_[i] = n->keys_[i];
+        grown->children_[i].store(n->children_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+      grown->count_ = n->count_;
+      return grown;
+    }
+    case ArtNodeType::NODE16: {
+      auto *n = static_cast<const ArtNode16 *>(node);
+      auto *grown = new ArtNode48(n->prefix_, n->prefix_len_);
+      for (uint16_t i = 0; i < n->count_; i++) {
+        grown->child_index_[n->keys_[i]] = static_cast<uint8_t>(i);
+        grown->children_[i].store(n->children_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+      grown->count_ = n->count_;
+      return grown;
+    }
+    case ArtNodeType::NODE48: {
+      auto *n = static_cast<const ArtNode48 *>(node);
+      auto *grown = new ArtNode256(n->prefix_, n->prefix_len_);
+      for (int byte = 0; byte < 256; byte++) {
+        if (n->child_index_[byte] != ArtNode48::EMPTY_MARKER) {
+          grown->children_[byte].store(n->children_[n->child_index_[byte]].load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+        }
+      }
+      grown->count_ = n->count_;
+      return grown;
+    }
+    case ArtNodeType::NODE256:
+      break;
+  }
+  UNREACHABLE("Node256 cannot grow");
+}
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+AdaptiveRadixTree::AdaptiveRadixTree() : root_(new ArtNode256(nullptr, 0)) {
+  for (auto &active : active_) {
+    active.store(0);
+  }
+}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() {
+  FreeSubtree(root_);
+  for (auto &garbage : garbage_) {
+    for (auto *node : garbage) {
+      FreeNode(node);
+    }
+  }
+}
+
+bool AdaptiveRadixTree::GetValue(const std::string &key, RID *value) {
+  EpochGuard guard(this);
+  while (true) {
+    bool restart = false;
+    bool found = LookupOrRestart(key, value, &restart);
+    if (!restart) {
+      return found;
+    }
+  }
+}
+
+bool AdaptiveRadixTree::Insert(const std::string &key, RID value) {
+  EpochGuard guard(this);
+  ArtNode *leaf = MakeLeaf(key, value);
+  while (true) {
+    bool restart = false;
+    bool inserted = InsertOrRestart(key, leaf, &restart);
+    if (!restart) {
+      if (!inserted) {
+        FreeNode(leaf);
+      }
+      return inserted;
+    }
+  }
+}
+
+bool AdaptiveRadixTree::Remove(const std::string &key) {
+  EpochGuard guard(this);
+  while (true) {
+    bool restart = false;
+    bool removed = RemoveOrRestart(key, &restart);
+    if (!restart) {
+      return removed;
+    }
+  }
+}
+
+/*
+ * Descend without taking any lock. Every child pointer is only followed
+ * after checking that the node it was read from did not change meanwhile.
+ */
+bool AdaptiveRadixTree::LookupOrRestart(const std::string &key, RID *value, bool *restart) {
+  ArtNode *node = root_;
+  uint64_t version = node->ReadLockOrRestart(restart);
+  if (*restart) {
+    return false;
+  }
+  uint32_t level = 0;
+  while (true) {
+    bool match = PrefixMatches(node, key, &level);
+    node->CheckOrRestart(version, restart);
+    if (*restart || !match) {
+      return false;
+    }
+    ArtNode *child = GetChild(node, static_cast<uint8_t>(key[level]));
+    node->CheckOrRestart(version, restart);
+    if (*restart || child == nullptr) {
+      return false;
+    }
+    if (IsLeaf(child)) {
+      if (!LeafMatches(child, key)) {
+        return false;
+      }
+      *value = AsLeaf(child)->value_;
+      return true;
+    }
+    uint64_t child_version = child->ReadLockOrRestart(restart);
+    if (*restart) {
+      return false;
+    }
+    node->ReadUnlockOrRestart(version, restart);
+    if (*restart) {
+      return false;
+    }
+    node = child;
+    version = child_version;
+    level++;
+  }
+}
+
+/*
+ * Descend like a lookup and write lock only what has to change:
+ * (1) a prefix that differs from the key is split by a new Node4 above the node
+ * (2) a missing child is added to the node, which may grow into a copy of the next kind
+ * (3) an existing leaf is pushed down into a new Node4 together with the new leaf
+ */
+bool AdaptiveRadixTree::InsertOrRestart(const std::string &key, ArtNode *leaf, bool *restart) {
+  ArtNode *node = nullptr;
+  ArtNode *next_node = root_;
+  ArtNode *parent = nullptr;
+  uint8_t parent_key = 0;
+  uint8_t node_key = 0;
+  uint64_t parent_version = 0;
+  uint32_t level = 0;
+  while (true) {
+    parent = node;
+    parent_key = node_key;
+    node = next_node;
+    uint64_t version = node->ReadLockOrRestart(restart);
+    if (*restart) {
+      return false;
+    }
+
+    uint32_t next_level = level;
+    uint8_t non_matching_key;
+    uint8_t remaining_prefix[ART_MAX_STORED_PREFIX];
+    bool mismatch = CheckPrefixPessimistic(node, key, &next_level, &non_matching_key, remaining_prefix, restart);
+    if (*restart) {
+      return false;
+    }
+    if (mismatch) {
+      // the root has no prefix, so there is a parent
+      parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+      node->UpgradeToWriteLockOrRestart(&version, restart);
+      if (*restart) {
+        parent->WriteUnlock();
+        return false;
+      }
+      auto *new_node = new ArtNode4(node->prefix_, next_level - level);
+      InsertChild(new_node, static_cast<uint8_t>(key[next_level]), leaf);
+      InsertChild(new_node, non_matching_key, node);
+      ChangeChild(parent, parent_key, new_node);
+      parent->WriteUnlock();
+      node->SetPrefix(remaining_prefix, node->prefix_len_ - (next_level - level + 1));
+      node->WriteUnlock();
+      return true;
+    }
+
+    level = next_level;
+    if (level >= key.size()) {
+      node->CheckOrRestart(version, restart);
+      if (*restart) {
+        return false;
+      }
+      UNREACHABLE("a key of the radix tree is a prefix of another one");
+    }
+    node_key = static_cast<uint8_t>(key[level]);
+    next_node = GetChild(node, node_key);
+    node->CheckOrRestart(version, restart);
+    if (*restart) {
+      return false;
+    }
+    if (next_node == nullptr) {
+      InsertAndUnlock(node, version, parent, parent_version, parent_key, node_key, leaf, restart);
+      return !*restart;
+    }
+    if (parent != nullptr) {
+      parent->ReadUnlockOrRestart(parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+    }
+
+    if (IsLeaf(next_node)) {
+      if (LeafMatches(next_node, key)) {
+        node->ReadUnlockOrRestart(version, restart);
+        return false;
+      }
+      node->UpgradeToWriteLockOrRestart(&version, restart);
+      if (*restart) {
+        return false;
+      }
+      const ArtLeaf *existing = AsLeaf(next_node);
+      level++;
+      uint32_t limit = std::min<uint32_t>(key.size(), existing->key_len_);
+      uint32_t prefix_len = 0;
+      while (level + prefix_len < limit &&
+             existing->key_[level + prefix_len] == static_cast<uint8_t>(key[level + prefix_len])) {
+        prefix_len++;
+      }
+      if (level + prefix_len == limit) {
+        node->WriteUnlock();
+        UNREACHABLE("a key of the radix tree is a prefix of another one");
+      }
+      auto *new_node = new ArtNode4(reinterpret_cast<const uint8_t *>(key.data()) + level, prefix_len);
+      InsertChild(new_node, static_cast<uint8_t>(key[level + prefix_len]), leaf);
+      InsertChild(new_node, existing->key_[level + prefix_len], next_node);
+      ChangeChild(node, node_key, new_node);
+      node->WriteUnlock();
+      return true;
+    }
+    level++;
+    parent_version = version;
+  }
+}
+
+void AdaptiveRadixTree::InsertAndUnlock(ArtNode *node, uint64_t version, ArtNode *parent, uint64_t parent_version,
+                                        uint8_t parent_key, uint8_t key, ArtNode *child, bool *restart) {
+  if (!IsFull(node)) {
+    if (parent != nullptr) {
+      parent->ReadUnlockOrRestart(parent_version, restart);
+      if (*restart) {
+        return;
+      }
+    }
+    node->UpgradeToWriteLockOrRestart(&version, restart);
+    if (*restart) {
+      return;
+    }
+    InsertChild(node, key, child);
+    node->WriteUnlock();
+    return;
+  }
+
+  // the root never fills up, so there is a parent
+  parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+  if (*restart) {
+    return;
+  }
+  node->UpgradeToWriteLockOrRestart(&version, restart);
+  if (*restart) {
+    parent->WriteUnlock();
+    return;
+  }
+  ArtNode *grown = Grow(node);
+  InsertChild(grown, key, child);
+  ChangeChild(parent, parent_key, grown);
+  parent->WriteUnlock();
+  node->WriteUnlockObsolete();
+  Retire(node);
+}
+
+/*
+ * Unlink the leaf. Inner nodes other than the root keep at least two
+ * children: a node left with a single child is replaced by that child, whose
+ * prefix absorbs the prefix of the node. Nodes do not shrink to smaller kinds.
+ */
+bool AdaptiveRadixTree::RemoveOrRestart(const std::string &key, bool *restart) {
+  ArtNode *node = nullptr;
+  ArtNode *next_node = root_;
+  ArtNode *parent = nullptr;
+  uint8_t parent_key = 0;
+  uint8_t node_key = 0;
+  uint64_t parent_version = 0;
+  uint32_t level = 0;
+  while (true) {
+    parent = node;
+    parent_key = node_key;
+    node = next_node;
+    uint64_t version = node->ReadLockOrRestart(restart);
+    if (*restart) {
+      return false;
+    }
+    bool match = PrefixMatches(node, key, &level);
+    node->CheckOrRestart(version, restart);
+    if (*restart || !match) {
+      return false;
+    }
+    node_key = static_cast<uint8_t>(key[level]);
+    next_node = GetChild(node, node_key);
+    node->CheckOrRestart(version, restart);
+    if (*restart || next_node == nullptr) {
+      return false;
+    }
+
+    if (IsLeaf(next_node)) {
+      if (!LeafMatches(next_node, key)) {
+        return false;
+      }
+      if (node->count_ == 2 && parent != nullptr) {
+        parent->UpgradeToWriteLockOrRestart(&parent_version, restart);
+        if (*restart) {
+          return false;
+        }
+        node->UpgradeToWriteLockOrRestart(&version, restart);
+        if (*restart) {
+          parent->WriteUnlock();
+          return false;
+        }
+        uint8_t second_key;
+        ArtNode *second = GetSecondChild(node, node_key, &second_key);
+        if (!IsLeaf(second)) {
+          second->WriteLockOrRestart(restart);
+          if (*restart) {
+            node->WriteUnlock();
+            parent->WriteUnlock();
+            return false;
+          }
+          second->AddPrefixBefore(node, second_key);
+        }
+        ChangeChild(parent, parent_key, second);
+        parent->WriteUnlock();
+        if (!IsLeaf(second)) {
+          second->WriteUnlock();
+        }
+        node->WriteUnlockObsolete();
+        Retire(node);
+      } else {
+        node->UpgradeToWriteLockOrRestart(&version, restart);
+        if (*restart) {
+          return false;
+        }
+        RemoveChild(node, node_key);
+        node->WriteUnlock();
+      }
+      Retire(next_node);
+      return true;
+    }
+    level++;
+    parent_version = version;
+  }
+}
+
+const ArtLeaf *AdaptiveRadixTree::AnyLeaf(const ArtNode *node, bool *restart) {
+  while (!IsLeaf(node)) {
+    uint64_t version = node->ReadLockOrRestart(restart);
+    if (*restart) {
+      return nullptr;
+    }
+    const ArtNode *child = GetAnyChild(node);
+    node->ReadUnlockOrRestart(version, restart);
+    if (*restart) {
+      return nullptr;
+    }
+    if (child == nullptr) {
+      *restart = true;
+      return nullptr;
+    }
+    node = child;
+  }
+  return AsLeaf(node);
+}
+
+bool AdaptiveRadixTree::PrefixMatches(const ArtNode *node, const std::string &key, uint32_t *level) {
+  uint32_t prefix_len = node->prefix_len_;
+  // below the prefix at least one more key byte selects the child
+  if (*level + prefix_len >= key.size()) {
+    return false;
+  }
+  uint32_t stored = std::min<uint32_t>(prefix_len, ART_MAX_STORED_PREFIX);
+  for (uint32_t i = 0; i < stored; i++) {
+    if (node->prefix_[i] != static_cast<uint8_t>(key[*level + i])) {
+      return false;
+    }
+  }
+  *level += prefix_len;
+  return true;
+}
+
+bool AdaptiveRadixTree::CheckPrefixPessimistic(const ArtNode *node, const std::string &key, uint32_t *level,
+                                               uint8_t *non_matching_key, uint8_t *non_matching_prefix,
+                                               bool *restart) {
+  uint32_t prefix_len = node->prefix_len_;
+  const ArtLeaf *leaf = nullptr;
+  for (uint32_t i = 0; i < prefix_len; i++) {
+    if (i == ART_MAX_STORED_PREFIX) {
+      leaf = AnyLeaf(node, restart);
+      if (*restart) {
+        return false;
+      }
+    }
+    // a prefix running past the key or the leaf can only be seen while the node is modified
+    if (*level >= key.size() || (leaf != nullptr && *level >= leaf->key_len_)) {
+      *restart = true;
+      return false;
+    }
+    uint8_t current = i < ART_MAX_STORED_PREFIX ? node->prefix_[i] : leaf->key_[*level];
+    if (current != static_cast<uint8_t>(key[*level])) {
+      *non_matching_key = current;
+      uint32_t remaining = std::min<uint32_t>(prefix_len - i - 1, ART_MAX_STORED_PREFIX);
+      if (prefix_len > ART_MAX_STORED_PREFIX) {
+        if (leaf == nullptr) {
+          leaf = AnyLeaf(node, restart);
+          if (*restart) {
+            return false;
+          }
+        }
+        if (*level + remaining >= leaf->key_len_) {
+          *restart = true;
+          return false;
+        }
+        memcpy(non_matching_prefix, leaf->key_ + *level + 1, remaining);
+      } else {
+        memcpy(non_matching_prefix, node->prefix_ + i + 1, remaining);
+      }
+      return true;
+    }
+    (*level)++;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * MEMORY RECLAMATION
+ *****************************************************************************/
+AdaptiveRadixTree::EpochGuard::EpochGuard(AdaptiveRadixTree *tree) : tree_(tree) {
+  while (true) {
+    epoch_ = tree_->epoch_.load();
+    tree_->active_[epoch_ % 3].fetch_add(1);
+    // registered too late if the epoch moved on in between
+    if (tree_->epoch_.load() == epoch_) {
+      return;
+    }
+    tree_->active_[epoch_ % 3].fetch_sub(1);
+  }
+}
+
+AdaptiveRadixTree::EpochGuard::~EpochGuard() { tree_->active_[epoch_ % 3].fetch_sub(1); }
+
+/*
+ * Operations only ever run in the current or the previous epoch. So once no
+ * operation is left in the previous epoch e - 1, moving to e + 1 frees what
+ * was retired in e - 1: every operation that could still reach it is done.
+ */
+void AdaptiveRadixTree::Retire(ArtNode *node) {
+  std::lock_guard<std::mutex> guard(garbage_latch_);
+  uint64_t epoch = epoch_.load();
+  garbage_[epoch % 3].push_back(node);
+  if (++retired_since_advance_ < ART_RETIRE_BATCH || active_[(epoch + 2) % 3].load() != 0) {
+    return;
+  }
+  auto &garbage = garbage_[(epoch + 2) % 3];
+  for (auto *retired : garbage) {
+    FreeNode(retired);
+  }
+  garbage.clear();
+  epoch_.store(epoch + 1);
+  retired_since_advance_ = 0;
+}
+
+void AdaptiveRadixTree::FreeNode(ArtNode *node) {
+  if (IsLeaf(node)) {
+    ::operator delete(AsLeaf(node));
+    return;
+  }
+  switch (node->type_) {
+    case ArtNodeType::NODE4:
+      delete static_cast<ArtNode4 *>(node);
+      break;
+    case ArtNodeType::NODE16:
+      delete static_cast<ArtNode16 *>(node);
+      break;
+    case ArtNodeType::NODE48:
+      delete static_cast<ArtNode48 *>(node);
+      break;
+    case ArtNodeType::NODE256:
+      delete static_cast<ArtNode256 *>(node);
+      break;
+  }
+}
+
+void AdaptiveRadixTree::FreeSubtree(ArtNode *node) {
+  if (!IsLeaf(node)) {
+    for (int byte = 0; byte < 256; byte++) {
+      ArtNode *child = GetChild(node, static_cast<uint8_t>(byte));
+      if (child != nullptr) {
+        FreeSubtree(child);
+      }
+    }
+  }
+  FreeNode(node);
+}
+
+}  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.cpp
+//
+// Identification: src/storage/index/art_index.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art_index.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ArtIndex::ArtIndex(IndexMetadata *metadata) : Index(metadata) {}
+
+void ArtIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(EncodeKey(key), rid);
+}
+
+void ArtIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) { container_.Remove(EncodeKey(key)); }
+
+void ArtIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  RID rid;
+  if (container_.GetValue(EncodeKey(key), &rid)) {
+    result->push_back(rid);
+  }
+}
+
+// appends the lowest bytes of the bits, most significant first
+static void AppendBigEndian(std::string *key, uint64_t bits, size_t bytes) {
+  for (size_t i = bytes; i > 0; i--) {
+    key->push_back(static_cast<char>(bits >> (8 * (i - 1))));
+  }
+}
+
+std::string ArtIndex::EncodeKey(const Tuple &key) const {
+  std::string encoded;
+  Schema *key_schema = GetKeySchema();
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value value = key.GetValue(key_schema, i);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendBigEndian(&encoded, static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1);
+        break;
+      case TypeId::SMALLINT:
+        AppendBigEndian(&encoded, static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2);
+        break;
+      case TypeId::INTEGER:
+        AppendBigEndian(&encoded, static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4);
+        break;
+      case TypeId::BIGINT:
+        AppendBigEndian(&encoded, static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), 8);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(&encoded, value.GetAs<uint64_t>(), 8);
+        break;
+      case TypeId::DECIMAL: {
+        double decimal = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &decimal, sizeof(bits));
+        // negative numbers order reversed by their magnitude, positive ones after all of them
+        bits = (bits >> 63) != 0 ? ~bits : bits | (1ULL << 63);
+        AppendBigEndian(&encoded, bits, 8);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        if (!value.IsNull()) {
+          const char *data = value.GetData();
+          for (uint32_t j = 0; j < value.GetLength(); j++) {
+            encoded.push_back(data[j]);
+            if (data[j] == '\0') {
+              encoded.push_back(static_cast<char>(0xFF));
+            }
+          }
+        }
+        encoded.append(2, '\0');
+        break;
+      }
+      default:
+        throw Exception(ExceptionType::NOT_IMPLEMENTED, "Unsupported key column type for ART index");
+    }
+  }
+  return encoded;
+}
+
+}  // namespace bustub
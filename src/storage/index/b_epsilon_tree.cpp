@@ -0,0 +1,374 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/b_epsilon_tree.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/b_epsilon_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+INDEX_TEMPLATE_ARGUMENTS
+BEPSILONTREE_TYPE::BEpsilonTree(std::string name, BufferPoolManager *buffer_pool_manager,
+                                const KeyComparator &comparator, int leaf_max_size, int internal_max_fanout)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_fanout_(internal_max_fanout) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BEPSILONTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the value associated with input key. The messages pending for the
+ * key are picked up on the way down and replayed on top of the leaf, oldest
+ * (lowest) first.
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BEPSILONTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  std::vector<Message> pending;
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch tree page");
+    }
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      auto *leaf = reinterpret_cast<LeafPage *>(node);
+      ValueType value;
+      bool present = leaf->Lookup(key, &value, comparator_);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+        Apply(*it, &present, &value);
+      }
+      if (present) {
+        result->push_back(value);
+      }
+      return present;
+    }
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    const Message *message = internal->FindMessage(key, comparator_);
+    if (message != nullptr) {
+      pending.push_back(*message);
+    }
+    page_id_t child_page_id = internal->LookupChild(key, comparator_);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = child_page_id;
+  }
+}
+
+/*****************************************************************************
+ * UPDATE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  Put({key, value, BEpsilonMessageType::INSERT});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Upsert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  Put({key, value, BEpsilonMessageType::UPSERT});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  Put({key, ValueType(), BEpsilonMessageType::DELETE});
+}
+
+/*
+ * Hand the message to the root. If the root splits on the way, grow the tree
+ * by a new root over the old one and its new siblings, which may split again
+ * when the old root fell apart into more nodes than the fanout allows.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Put(const Message &message) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    Page *page = NewTreePage(&root_page_id_);
+    reinterpret_cast<LeafPage *>(page->GetData())->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    UpdateRootPageId(1);
+  }
+
+  // common case: the message is absorbed by the root buffer in place
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch tree page");
+  }
+  auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+  if (!root->IsLeafPage()) {
+    Message *older = root->FindMessage(message.key_, comparator_);
+    if (older != nullptr) {
+      Combine(older, message);
+      buffer_pool_manager_->UnpinPage(root_page_id_, true);
+      return;
+    }
+    if (root->InsertMessage(message, comparator_)) {
+      buffer_pool_manager_->UnpinPage(root_page_id_, true);
+      return;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(root_page_id_, false);
+
+  std::vector<Pivot> splits;
+  FlushInto(root_page_id_, {message}, &splits);
+  while (!splits.empty()) {
+    std::vector<Pivot> pivots;
+    pivots.reserve(splits.size() + 1);
+    pivots.emplace_back(KeyType(), root_page_id_);
+    pivots.insert(pivots.end(), splits.begin(), splits.end());
+    splits.clear();
+
+    page_id_t root_page_id;
+    Page *page = NewTreePage(&root_page_id);
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(root_page_id, internal_max_fanout_);
+    StoreInternal(page, pivots, {}, &splits);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::FlushInto(page_id_t page_id, const std::vector<Message> &messages,
+                                  std::vector<Pivot> *splits) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch tree page");
+  }
+  if (reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+    ApplyToLeaf(page, messages, splits);
+  } else {
+    FlushInternal(page, messages, splits);
+  }
+}
+
+/*
+ * Merge the batch into the entries of the leaf. The result is written back
+ * into the leaf and, if it no longer fits, into new leaves linked in after it
+ * which all get an even share of the entries.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::ApplyToLeaf(Page *page, const std::vector<Message> &messages, std::vector<Pivot> *splits) {
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  std::vector<MappingType> entries;
+  entries.reserve(leaf->GetSize() + messages.size());
+  int index = 0;
+  for (const auto &message : messages) {
+    while (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), message.key_) < 0) {
+      entries.push_back(leaf->GetItem(index++));
+    }
+    bool present = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), message.key_) == 0;
+    ValueType value = present ? leaf->GetItem(index++).second : ValueType();
+    Apply(message, &present, &value);
+    if (present) {
+      entries.emplace_back(message.key_, value);
+    }
+  }
+  while (index < leaf->GetSize()) {
+    entries.push_back(leaf->GetItem(index++));
+  }
+
+  page_id_t page_id = leaf->GetPageId();
+  page_id_t next_page_id = leaf->GetNextPageId();
+  size_t chunks = std::max<size_t>(1, (entries.size() + leaf_max_size_ - 1) / leaf_max_size_);
+  size_t begin = 0;
+  for (size_t chunk = 0; chunk < chunks; chunk++) {
+    size_t end = entries.size() * (chunk + 1) / chunks;
+    if (chunk > 0) {
+      page_id_t new_page_id;
+      Page *new_page = NewTreePage(&new_page_id);
+      leaf->SetNextPageId(new_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      page = new_page;
+      page_id = new_page_id;
+      splits->emplace_back(entries[begin].first, new_page_id);
+    }
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    for (size_t i = begin; i < end; i++) {
+      leaf->Insert(entries[i].first, entries[i].second, comparator_);
+    }
+    begin = end;
+  }
+  leaf->SetNextPageId(next_page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+/*
+ * Merge the batch into the buffer of the node, newer messages overriding
+ * older ones for the same key. While the buffer overflows, the messages of
+ * the child that has the most of them are flushed to it, and the nodes the
+ * child split into become children of this node.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::FlushInternal(Page *page, const std::vector<Message> &messages, std::vector<Pivot> *splits) {
+  auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+  std::vector<Pivot> pivots;
+  std::vector<Message> buffer;
+  node->Load(&pivots, &buffer);
+
+  std::vector<Message> merged;
+  merged.reserve(buffer.size() + messages.size());
+  auto older = buffer.begin();
+  for (const auto &message : messages) {
+    while (older != buffer.end() && comparator_(older->key_, message.key_) < 0) {
+      merged.push_back(*older++);
+    }
+    if (older != buffer.end() && comparator_(older->key_, message.key_) == 0) {
+      merged.push_back(*older++);
+      Combine(&merged.back(), message);
+    } else {
+      merged.push_back(message);
+    }
+  }
+  merged.insert(merged.end(), older, buffer.end());
+
+  auto key_less = [this](const Message &lhs, const KeyType &rhs) { return comparator_(lhs.key_, rhs) < 0; };
+  while (static_cast<int>(merged.size()) > node->GetBufferCapacity()) {
+    // the messages of child i are [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds(pivots.size() + 1);
+    bounds[0] = 0;
+    for (size_t i = 1; i < pivots.size(); i++) {
+      bounds[i] = std::lower_bound(merged.begin(), merged.end(), pivots[i].first, key_less) - merged.begin();
+    }
+    bounds[pivots.size()] = merged.size();
+    size_t child = 0;
+    for (size_t i = 1; i < pivots.size(); i++) {
+      if (bounds[i + 1] - bounds[i] > bounds[child + 1] - bounds[child]) {
+        child = i;
+      }
+    }
+
+    std::vector<Message> batch(merged.begin() + bounds[child], merged.begin() + bounds[child + 1]);
+    merged.erase(merged.begin() + bounds[child], merged.begin() + bounds[child + 1]);
+    std::vector<Pivot> child_splits;
+    FlushInto(pivots[child].second, batch, &child_splits);
+    pivots.insert(pivots.begin() + child + 1, child_splits.begin(), child_splits.end());
+  }
+
+  StoreInternal(page, pivots, merged, splits);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::StoreInternal(Page *page, const std::vector<Pivot> &pivots,
+                                      const std::vector<Message> &messages, std::vector<Pivot> *splits) {
+  page_id_t page_id = page->GetPageId();
+  size_t chunks = (pivots.size() + internal_max_fanout_ - 1) / internal_max_fanout_;
+  auto key_less = [this](const Message &lhs, const KeyType &rhs) { return comparator_(lhs.key_, rhs) < 0; };
+  size_t begin = 0;
+  auto message_begin = messages.begin();
+  for (size_t chunk = 0; chunk < chunks; chunk++) {
+    size_t end = pivots.size() * (chunk + 1) / chunks;
+    auto message_end = end == pivots.size()
+                           ? messages.end()
+                           : std::lower_bound(message_begin, messages.end(), pivots[end].first, key_less);
+    if (chunk > 0) {
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      page = NewTreePage(&page_id);
+      reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, internal_max_fanout_);
+      splits->emplace_back(pivots[begin].first, page_id);
+    }
+    reinterpret_cast<InternalPage *>(page->GetData())
+        ->Store(std::vector<Pivot>(pivots.begin() + begin, pivots.begin() + end),
+                std::vector<Message>(message_begin, message_end));
+    begin = end;
+    message_begin = message_end;
+  }
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+/*
+ * An insert only takes effect on an absent key, so on top of a delete it
+ * turns into an upsert and on top of anything else it is a no-op. Every other
+ * message decides the state of the key on its own.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Combine(Message *older, const Message &newer) {
+  if (newer.type_ != BEpsilonMessageType::INSERT) {
+    *older = newer;
+  } else if (older->type_ == BEpsilonMessageType::DELETE) {
+    older->value_ = newer.value_;
+    older->type_ = BEpsilonMessageType::UPSERT;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::Apply(const Message &message, bool *present, ValueType *value) {
+  switch (message.type_) {
+    case BEpsilonMessageType::INSERT:
+      if (!*present) {
+        *present = true;
+        *value = message.value_;
+      }
+      break;
+    case BEpsilonMessageType::UPSERT:
+      *present = true;
+      *value = message.value_;
+      break;
+    case BEpsilonMessageType::DELETE:
+      *present = false;
+      break;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BEPSILONTREE_TYPE::NewTreePage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new tree page");
+  }
+  return page;
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * Call this method everytime root page id is changed.
+ * @parameter: insert_record      defualt value is false. When set to true,
+ * insert a record <index_name, root_page_id> into header page instead of
+ * updating it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_TYPE::UpdateRootPageId(int insert_record) {
+  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    // create a new record<index_name + root_page_id> in header_page
+    header_page->InsertRecord(index_name_, root_page_id_);
+  } else {
+    // update root_page_id in header_page
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template class BEpsilonTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
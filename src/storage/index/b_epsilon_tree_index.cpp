@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/b_epsilon_tree_index.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/b_epsilon_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+INDEX_TEMPLATE_ARGUMENTS
+BEPSILONTREE_INDEX_TYPE::BEpsilonTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata),
+      comparator_(metadata->GetKeySchema()),
+      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Insert(index_key, rid, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Remove(index_key, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BEPSILONTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.GetValue(index_key, result, transaction);
+}
+
+template class BEpsilonTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,383 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/b_link_tree.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/b_link_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+INDEX_TEMPLATE_ARGUMENTS
+BLINKTREE_TYPE::BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {}
+
+/*
+ * Helper function to decide whether the tree holds no entries. Since nodes
+ * never merge, only a tree whose root is still a leaf can be empty.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BLINKTREE_TYPE::IsEmpty() const {
+  page_id_t root_page_id = root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id);
+  page->RLatch();
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  bool empty = root->IsLeafPage() && root->GetSize() == 0;
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(root_page_id, false);
+  return empty;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the value associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BLINKTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  Page *page = FindNode(key, 0, false);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  ReleaseLatched(page, false, false);
+  return found;
+}
+
+/*
+ * Walk the leaf level from the leaf covering low along the right links.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::ScanRange(const KeyType &low, const KeyType &high,
+                               std::vector<std::pair<KeyType, ValueType>> *result, Transaction *transaction) {
+  Page *page = FindNode(low, 0, false);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(low, comparator_);
+  while (true) {
+    for (; index < leaf->GetSize(); index++) {
+      if (comparator_(leaf->KeyAt(index), high) > 0) {
+        ReleaseLatched(page, false, false);
+        return;
+      }
+      result->push_back(leaf->GetItem(index));
+    }
+    page_id_t right_page_id = leaf->GetRightPageId();
+    if (right_page_id == INVALID_PAGE_ID) {
+      ReleaseLatched(page, false, false);
+      return;
+    }
+    Page *right_page = FetchLatched(right_page_id, false);
+    ReleaseLatched(page, false, false);
+    page = right_page;
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    index = 0;
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into the tree
+ * if current tree is empty, start new tree, update root page id and insert
+ * entry, otherwise insert into leaf page.
+ * @return: since only support unique key, if user try to insert duplicate
+ * keys return false, otherwise return true.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BLINKTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    std::lock_guard<std::mutex> guard(root_latch_);
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      StartNewTree(key, value);
+      return true;
+    }
+  }
+
+  std::vector<page_id_t> path;
+  Page *page = FindNode(key, 0, true, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    ReleaseLatched(page, true, false);
+    return false;
+  }
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    leaf->Insert(key, value, comparator_);
+    ReleaseLatched(page, true, true);
+    return true;
+  }
+
+  // split first, the new sibling is linked in before any latch is released
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_page == nullptr) {
+    ReleaseLatched(page, true, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page for split");
+  }
+  new_page->WLatch();
+  auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+  new_leaf->Init(new_page_id, 0, leaf_max_size_);
+  KeyType separator = leaf->MoveHalfTo(new_leaf);
+  (comparator_(key, separator) < 0 ? leaf : new_leaf)->Insert(key, value, comparator_);
+  page_id_t old_page_id = page->GetPageId();
+  ReleaseLatched(new_page, true, true);
+  ReleaseLatched(page, true, true);
+
+  InsertIntoParent(old_page_id, separator, new_page_id, 1, &path);
+  return true;
+}
+
+/*
+ * Create the first leaf, which is also the root. Called with root_latch_ held.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t root_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&root_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new root page");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(root_page_id, 0, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = root_page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+}
+
+/*
+ * Post the separator of a split into the parent level. The parent is taken
+ * from the path remembered on the way down and corrected by moving right; if
+ * the split node was the root (or the path ran out because the tree grew in
+ * the meantime) the parent is looked up from the current root. A parent that
+ * is full splits in turn and the loop continues one level up.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::InsertIntoParent(page_id_t old_page_id, const KeyType &key, page_id_t new_page_id, int level,
+                                      std::vector<page_id_t> *path) {
+  KeyType separator = key;
+  while (true) {
+    Page *page;
+    if (!path->empty()) {
+      page = MoveRight(FetchLatched(path->back(), true), separator, true);
+      path->pop_back();
+    } else {
+      std::unique_lock<std::mutex> guard(root_latch_);
+      if (root_page_id_ == old_page_id) {
+        page_id_t root_page_id;
+        Page *root_page = buffer_pool_manager_->NewPage(&root_page_id);
+        if (root_page == nullptr) {
+          throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new root page");
+        }
+        auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+        root->Init(root_page_id, level, internal_max_size_);
+        root->PopulateNewRoot(old_page_id, separator, new_page_id);
+        root_page_id_ = root_page_id;
+        UpdateRootPageId();
+        buffer_pool_manager_->UnpinPage(root_page_id, true);
+        return;
+      }
+      guard.unlock();
+      // another thread split the root of this level and has not grown the tree yet
+      page = FindNode(separator, level, true);
+      if (page == nullptr) {
+        std::this_thread::yield();
+        continue;
+      }
+    }
+
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    if (node->GetSize() < node->GetMaxSize()) {
+      node->Insert(separator, new_page_id, comparator_);
+      ReleaseLatched(page, true, true);
+      return;
+    }
+
+    page_id_t sibling_page_id;
+    Page *sibling_page = buffer_pool_manager_->NewPage(&sibling_page_id);
+    if (sibling_page == nullptr) {
+      ReleaseLatched(page, true, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page for split");
+    }
+    sibling_page->WLatch();
+    auto *sibling = reinterpret_cast<InternalPage *>(sibling_page->GetData());
+    sibling->Init(sibling_page_id, level, internal_max_size_);
+    KeyType middle_key = node->MoveHalfTo(sibling);
+    (comparator_(separator, middle_key) < 0 ? node : sibling)->Insert(separator, new_page_id, comparator_);
+    old_page_id = page->GetPageId();
+    ReleaseLatched(sibling_page, true, true);
+    ReleaseLatched(page, true, true);
+
+    separator = middle_key;
+    new_page_id = sibling_page_id;
+    level++;
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key. The leaf is left as is
+ * even if it becomes underfull or empty.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  Page *page = FindNode(key, 0, true);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    leaf->RemoveAt(index);
+  }
+  ReleaseLatched(page, true, found);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+/*
+ * Descend from the root without latch coupling: the latch of a node is
+ * released before its child is latched, and a child that was split in between
+ * is caught up with by moving right. Only the target node is latched
+ * exclusively.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BLINKTREE_TYPE::FindNode(const KeyType &key, int level, bool exclusive, std::vector<page_id_t> *path) {
+  page_id_t root_page_id = root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *page = MoveRight(FetchLatched(root_page_id, false), key, false);
+  auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+  if (node->GetLevel() < level) {
+    ReleaseLatched(page, false, false);
+    return nullptr;
+  }
+  if (node->GetLevel() == level) {
+    if (!exclusive) {
+      return page;
+    }
+    // the root is the target itself, retake it exclusively and catch up with a split that happened meanwhile
+    ReleaseLatched(page, false, false);
+    return MoveRight(FetchLatched(root_page_id, true), key, true);
+  }
+
+  while (true) {
+    if (path != nullptr) {
+      path->push_back(page->GetPageId());
+    }
+    page_id_t child_page_id = node->LookupChild(key, comparator_);
+    bool child_exclusive = exclusive && node->GetLevel() == level + 1;
+    ReleaseLatched(page, false, false);
+    page = MoveRight(FetchLatched(child_page_id, child_exclusive), key, child_exclusive);
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+    if (node->GetLevel() == level) {
+      return page;
+    }
+  }
+}
+
+/*
+ * Every node shares the header and high key layout, so leaves are handled
+ * through the internal page type as well.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BLINKTREE_TYPE::MoveRight(Page *page, const KeyType &key, bool exclusive) {
+  auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+  while (node->IsBeyondHighKey(key, comparator_)) {
+    Page *right_page = FetchLatched(node->GetRightPageId(), exclusive);
+    ReleaseLatched(page, exclusive, false);
+    page = right_page;
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BLINKTREE_TYPE::FetchLatched(page_id_t page_id, bool exclusive) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch index page, all frames are pinned");
+  }
+  if (exclusive) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::ReleaseLatched(Page *page, bool exclusive, bool is_dirty) {
+  page_id_t page_id = page->GetPageId();
+  if (exclusive) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * Call this method everytime root page id is changed, with root_latch_ held.
+ * @parameter: insert_record      default value is false. When set to true,
+ * insert a record <index_name, root_page_id> into header page instead of
+ * updating it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::UpdateRootPageId(int insert_record) {
+  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    // create a new record<index_name + root_page_id> in header_page
+    header_page->InsertRecord(index_name_, root_page_id_);
+  } else {
+    // update root_page_id in header_page
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template class BLinkTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
 
 #include "common/exception.h"
@@ -19,70 +20,163 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool allow_duplicates)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      allow_duplicates_(allow_duplicates),
+      inline_posting_size_(std::min(BPLUSTREE_INLINE_POSTING_SIZE, std::max(1, leaf_max_size / 2))) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::IsEmpty() const { 
-  // return true if no root node exists or if there are no keys stored in the root node
-  printf("Root page id: %d\n",root_page_id_);
-  if(root_page_id_ == INVALID_PAGE_ID)  return true;
-  else{
-    //TODO: Add logic for stored keys in root node
-    Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
-    BPlusTreePage *root_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
-    printf("Root page size: %d\n",root_page->GetSize());
-    return root_page->GetSize() == 0;
-  //return true; 
+bool BPLUSTREE_TYPE::IsEmpty() const {
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return true;
   }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  bool empty = reinterpret_cast<BPlusTreePage *>(page->GetData())->GetSize() == 0;
+  buffer_pool_manager_->UnpinPage(root_page_id_, false);
+  return empty;
 }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the value(s) associated with input key; with duplicates allowed
+ * every value of the key's posting list is returned in sorted order
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  BPlusTreePage *root_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>  *leaf_page;
-  //Instantiating leaf/internal page as per root node
-  if(root_page->IsLeafPage()){
-    leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>  *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  } else{
-    BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>  *internal_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-    Page* internal_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    BPlusTreePage *internal_btree_page = reinterpret_cast<BPlusTreePage *>(internal_page->GetData());
-    page_id_t child_page_id = internal_root_page-> Lookup(key, comparator_);
-    while(!internal_btree_page->IsLeafPage()){
-      internal_btree_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
-      if(!internal_btree_page->IsLeafPage()){
-        internal_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>  *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
-        child_page_id = internal_root_page-> Lookup(key, comparator_);
-      }
+  if (adaptive_hash_index_ != nullptr) {
+    page_id_t leaf_page_id;
+    int slot;
+    if (adaptive_hash_index_->Find(key, &leaf_page_id, &slot)) {
+      return GetValueFromHashedLeaf(leaf_page_id, slot, key, result);
     }
-    //TODO: Check if leaf page is correct
-    leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
   }
+  Page *page = FindLeafPage(key);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  int slot = SlotOf(leaf_page, key);
+  if (slot >= 0) {
+    GetValueFromLeaf(leaf_page, slot, result);
+  }
+  if (adaptive_hash_index_ != nullptr) {
+    adaptive_hash_index_->RecordTraversal(leaf_page, key, slot);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return slot >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::SlotOf(LeafPage *leaf_page, const KeyType &key) {
   int index = leaf_page->KeyIndex(key, comparator_);
-  if(comparator_(leaf_page->KeyAt(index),key) == 0){
-    //printf("Element found, pushing into vector array....\n");
-    MappingType element = leaf_page->GetItem(index);
-    result->push_back(element.second);
-    return true;
-  }  
+  return index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), key) == 0 ? index : -1;
+}
 
-  return false;
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValueFromLeaf(LeafPage *leaf_page, int slot, std::vector<ValueType> *result) {
+  const ValueType &value = leaf_page->GetItem(slot).second;
+  if (allow_duplicates_ && BPlusTreePostingPage::IsReference(value)) {
+    BPlusTreePostingPage::ReadAll(buffer_pool_manager_, value.GetPageId(), result);
+    return;
+  }
+  // a short list of duplicates is stored inline as adjacent entries starting at slot
+  const KeyType key = leaf_page->KeyAt(slot);
+  for (int index = slot; index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), key) == 0; index++) {
+    result->push_back(leaf_page->GetItem(index).second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValueFromHashedLeaf(page_id_t leaf_page_id, int slot, const KeyType &key,
+                                            std::vector<ValueType> *result) {
+  Page *page = buffer_pool_manager_->FetchPage(leaf_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch leaf page");
+  }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  if (slot >= leaf_page->GetSize() || comparator_(leaf_page->KeyAt(slot), key) != 0 ||
+      (slot > 0 && comparator_(leaf_page->KeyAt(slot - 1), key) == 0)) {
+    // inserts and removes shifted the slot, but the key range of the leaf is still the same
+    slot = SlotOf(leaf_page, key);
+    if (slot >= 0) {
+      adaptive_hash_index_->UpdateSlot(key, leaf_page_id, slot);
+    }
+  }
+  if (slot >= 0) {
+    GetValueFromLeaf(leaf_page, slot, result);
+  }
+  buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+  return slot >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::EnableAdaptiveHashIndex(size_t num_entries) {
+  adaptive_hash_index_ =
+      std::make_unique<AdaptiveHashIndex<KeyType, ValueType, KeyComparator>>(comparator_, num_entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetNumAdaptiveHashHits() const {
+  return adaptive_hash_index_ == nullptr ? 0 : adaptive_hash_index_->GetNumHits();
+}
+
+// starts loading the cache lines that a binary search over a node reads first
+static inline void PrefetchNode(const char *data) {
+  __builtin_prefetch(data);
+  __builtin_prefetch(data + PAGE_SIZE / 4);
+  __builtin_prefetch(data + PAGE_SIZE / 2);
+  __builtin_prefetch(data + 3 * PAGE_SIZE / 4);
+}
+
+/*
+ * Looks up a batch of keys. A group of keys descends together: at every
+ * level all of them first pick and fetch their child and prefetch it, and
+ * only then search it, so that the cache misses of the group overlap
+ * instead of each lookup stalling on its own. The tree is balanced, so all
+ * keys of a group reach the leaves at the same time.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  results->resize(keys.size());
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  Page *pages[BPLUSTREE_PREFETCH_GROUP];
+  for (size_t group = 0; group < keys.size(); group += BPLUSTREE_PREFETCH_GROUP) {
+    size_t group_size = std::min<size_t>(BPLUSTREE_PREFETCH_GROUP, keys.size() - group);
+    for (size_t i = 0; i < group_size; i++) {
+      pages[i] = buffer_pool_manager_->FetchPage(root_page_id_);
+    }
+    while (!reinterpret_cast<BPlusTreePage *>(pages[0]->GetData())->IsLeafPage()) {
+      for (size_t i = 0; i < group_size; i++) {
+        auto *internal = reinterpret_cast<InternalPage *>(pages[i]->GetData());
+        Page *child = buffer_pool_manager_->FetchPage(internal->Lookup(keys[group + i], comparator_));
+        PrefetchNode(child->GetData());
+        buffer_pool_manager_->UnpinPage(pages[i]->GetPageId(), false);
+        pages[i] = child;
+      }
+    }
+    for (size_t i = 0; i < group_size; i++) {
+      auto *leaf_page = reinterpret_cast<LeafPage *>(pages[i]->GetData());
+      int slot = SlotOf(leaf_page, keys[group + i]);
+      if (slot >= 0) {
+        GetValueFromLeaf(leaf_page, slot, &(*results)[group + i]);
+      }
+      buffer_pool_manager_->UnpinPage(pages[i]->GetPageId(), false);
+    }
+  }
 }
 
 /*****************************************************************************
@@ -92,21 +186,18 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: for a unique tree, inserting a duplicate key returns false. With
+ * duplicates allowed only an already present key & value pair returns false.
+ * A key keeps up to inline_posting_size_ values inline in its leaf and moves
+ * them to a posting list when one more arrives.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { 
-  if(IsEmpty()){
-    printf("Starting new tree...\n");
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (IsEmpty()) {
     StartNewTree(key, value);
     return true;
-  } 
-  else{
-    printf("Inserting into leaf...\n");
-    return InsertIntoLeaf(key,value);
-  } 
-  //return false; 
+  }
+  return InsertIntoLeaf(key, value, transaction);
 }
 /*
  * Insert constant key & value pair into an empty tree
@@ -116,16 +207,16 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *root_page =
-      reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(buffer_pool_manager_->NewPage(&root_page_id_)->GetData());
-  root_page->Init(root_page_id_,INVALID_PAGE_ID, leaf_max_size_);
+  Page *page = buffer_pool_manager_->NewPage(&root_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new root page");
+  }
+  auto *root_page = reinterpret_cast<LeafPage *>(page->GetData());
+  root_page->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
   root_page->SetNextPageId(INVALID_PAGE_ID);
-  //Check if root page id updated
-  root_page_id_ = root_page->GetPageId();
   UpdateRootPageId(0);
-  root_page->Insert(key,value, comparator_);
-  buffer_pool_manager_->UnpinPage(root_page->GetPageId(), true);
-  //TODO: Check if exception needs to be returned
+  root_page->Insert(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
 }
 
 /*
@@ -138,41 +229,65 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  BPlusTreePage *root_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_page;
-  //Instantiating leaf/internal page as per root node
-  if(root_page->IsLeafPage()){
-    printf("Root page is only page which is leaf page, inserting...\n");
-    leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  } else{
-    BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *internal_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-    BPlusTreePage *internal_btree_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-    page_id_t child_page_id = internal_root_page-> Lookup(key, comparator_);
-    while(!internal_btree_page->IsLeafPage()){
-      internal_btree_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
-      if(!internal_btree_page->IsLeafPage()){
-        internal_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
-        child_page_id = internal_root_page-> Lookup(key, comparator_);
+  Page *page = FindLeafPage(key);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf_page->KeyIndex(key, comparator_);
+  int end = index;
+  while (end < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(end), key) == 0) {
+    end++;
+  }
+  if (end > index) {
+    if (!allow_duplicates_) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return false;
+    }
+    const ValueType existing = leaf_page->GetItem(index).second;
+    if (BPlusTreePostingPage::IsReference(existing)) {
+      // the key stays in place, only its posting list changes
+      bool inserted = InsertIntoPostingList(existing.GetPageId(), value);
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return inserted;
+    }
+    // the inline values of a key are kept sorted
+    int pos = index;
+    while (pos < end && leaf_page->GetItem(pos).second.Get() < value.Get()) {
+      pos++;
+    }
+    if (pos < end && leaf_page->GetItem(pos).second == value) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return false;
+    }
+    if (end - index >= inline_posting_size_) {
+      // one value too many to stay inline: the first entry now refers to a posting list holding all of them
+      std::vector<ValueType> values;
+      for (int i = index; i < end; i++) {
+        values.push_back(leaf_page->GetItem(i).second);
+      }
+      values.insert(values.begin() + (pos - index), value);
+      while (--end > index) {
+        leaf_page->RemoveAt(end);
       }
+      leaf_page->SetValueAt(index, BPlusTreePostingPage::MakeReference(CreatePostingList(values)));
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      return true;
     }
-    //TODO: Check if leaf page is correct
-    leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
+    index = pos;
   }
-  int index = leaf_page->KeyIndex(key, comparator_);
-  if(comparator_(leaf_page->KeyAt(index),key) == 0) return false;
-  leaf_page->Insert(key,value, comparator_);
-  if(leaf_page->GetSize() > leaf_max_size_){
-    printf("Leaf size full, need to split nodes...max size: %d\n", leaf_max_size_);
-    //split the leaf into two pages
-    BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *new_Leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(Split(leaf_page));
-    leaf_page->MoveHalfTo(new_Leaf_page);
-    leaf_page->SetNextPageId(new_Leaf_page->GetPageId());
-    new_Leaf_page->SetNextPageId(INVALID_PAGE_ID);
-    InsertIntoParent(leaf_page,new_Leaf_page->KeyAt(0), new_Leaf_page, transaction);
-    buffer_pool_manager_->UnpinPage(new_Leaf_page->GetPageId(), true);
-  }
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
-  return false;
+  leaf_page->InsertAt(index, key, value);
+  if (leaf_page->GetSize() > leaf_max_size_) {
+    // split the leaf into two pages, keeping the sibling chain intact for range scans
+    if (adaptive_hash_index_ != nullptr) {
+      adaptive_hash_index_->InvalidateLeaf(leaf_page->GetPageId());
+    }
+    LeafPage *new_leaf_page = Split(leaf_page);
+    leaf_page->MoveHalfTo(new_leaf_page, comparator_);
+    new_leaf_page->SetNextPageId(leaf_page->GetNextPageId());
+    leaf_page->SetNextPageId(new_leaf_page->GetPageId());
+    InsertIntoParent(leaf_page, new_leaf_page->KeyAt(0), new_leaf_page, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf_page->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  return true;
 }
 
 /*
@@ -186,10 +301,13 @@ INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
   page_id_t child_page_id;
-  N *page = reinterpret_cast<N *>(buffer_pool_manager_->NewPage(&child_page_id)->GetData());
+  Page *new_page = buffer_pool_manager_->NewPage(&child_page_id);
+  if (new_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page for split");
+  }
+  N *page = reinterpret_cast<N *>(new_page->GetData());
   page->Init(child_page_id, node->GetParentPageId(), node->GetMaxSize());
   return page;
-  //return nullptr;
 }
 
 /*
@@ -202,36 +320,33 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  * recursively if necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node, Transaction *transaction) {
-  if(!old_node->IsRootPage()){
-    printf("Inserting into parent page....\n");
-    Page* page = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
-    BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *parent_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(page->GetData());
-    parent_page->InsertNodeAfter(old_node->GetPageId(),key, new_node->GetPageId());
-    if(parent_page->GetSize() > internal_max_size_){
-      //split the leaf into two pages
-      printf("Creating new parent.....\n");
-      BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *new_internal_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(Split(parent_page));
-      parent_page->MoveHalfTo(new_internal_page, buffer_pool_manager_);
-      InsertIntoParent(parent_page, new_internal_page->KeyAt(1), new_internal_page, transaction);
-      new_internal_page->SetParentPageId(parent_page->GetParentPageId());
-      buffer_pool_manager_->UnpinPage(new_internal_page->GetPageId(), true);
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    Page *root_page = buffer_pool_manager_->NewPage(&root_page_id_);
+    if (root_page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new root page");
     }
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-  } else{
-    //page_id_t *new_root_id; 
-    printf("Creating new root page....\n");
-    Page* root_page = buffer_pool_manager_->NewPage(&root_page_id_);
-    BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *new_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(root_page->GetData());
-    printf("Created new root page with id: %d\n",root_page_id_);
+    auto *new_root_page = reinterpret_cast<InternalPage *>(root_page->GetData());
     new_root_page->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
     new_root_page->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(root_page_id_);
     new_node->SetParentPageId(root_page_id_);
     UpdateRootPageId(0);
     buffer_pool_manager_->UnpinPage(root_page->GetPageId(), true);
+    return;
   }
-
+  Page *page = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
+  auto *parent_page = reinterpret_cast<InternalPage *>(page->GetData());
+  parent_page->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  if (parent_page->GetSize() > internal_max_size_) {
+    // the first key of the new sibling is the separator that moves up; the sibling keeps it as its invalid key
+    InternalPage *new_internal_page = Split(parent_page);
+    parent_page->MoveHalfTo(new_internal_page, buffer_pool_manager_);
+    InsertIntoParent(parent_page, new_internal_page->KeyAt(0), new_internal_page, transaction);
+    buffer_pool_manager_->UnpinPage(new_internal_page->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
 }
 
 /*****************************************************************************
@@ -246,11 +361,64 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  if(IsEmpty()) return;
-  Page* page = FindLeafPage(key, false);
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_page = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page->GetData());
-  leaf_page->RemoveAndDeleteRecord(key, comparator_);
-  //Find leaf page and remove from it
+  if (IsEmpty()) {
+    return;
+  }
+  Page *page = FindLeafPage(key, false);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf_page->KeyIndex(key, comparator_);
+  int end = index;
+  while (end < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(end), key) == 0) {
+    end++;
+  }
+  if (allow_duplicates_ && end > index && BPlusTreePostingPage::IsReference(leaf_page->GetItem(index).second)) {
+    DeletePostingList(leaf_page->GetItem(index).second.GetPageId());
+  }
+  while (end > index) {
+    leaf_page->RemoveAt(--end);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
+/*
+ * Delete a single key & value pair. In a unique tree this removes the key
+ * only if it maps to the given value. With duplicates allowed the value is
+ * taken out of the key's posting list, and the key goes away together with
+ * its last value.
+ * @return: true means the pair existed and was removed
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page = FindLeafPage(key, false);
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf_page->KeyIndex(key, comparator_);
+  if (index == leaf_page->GetSize() || comparator_(leaf_page->KeyAt(index), key) != 0) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  const ValueType existing = leaf_page->GetItem(index).second;
+  bool removed = false;
+  if (allow_duplicates_ && BPlusTreePostingPage::IsReference(existing)) {
+    bool collapsed = false;
+    ValueType remaining;
+    removed = RemoveFromPostingList(existing.GetPageId(), value, &collapsed, &remaining);
+    if (collapsed) {
+      leaf_page->SetValueAt(index, remaining);
+    }
+  } else {
+    for (; index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), key) == 0; index++) {
+      if (leaf_page->GetItem(index).second == value) {
+        leaf_page->RemoveAt(index);
+        removed = true;
+        break;
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+  return removed;
 }
 
 /*
@@ -311,6 +479,163 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
 
+/*****************************************************************************
+ * POSTING LISTS
+ *****************************************************************************/
+/*
+ * Move the sorted inline values of a key that outgrew its leaf into a new
+ * posting list
+ * @return : page id of the head of the new posting list
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::CreatePostingList(const std::vector<ValueType> &values) {
+  page_id_t head_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&head_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new posting page");
+  }
+  auto *posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+  posting_page->Init(head_page_id);
+  posting_page->Encode(values, 0, values.size());
+  buffer_pool_manager_->UnpinPage(head_page_id, true);
+  return head_page_id;
+}
+
+/*
+ * Insert value into the sorted posting list. The value goes to the first page
+ * whose range covers it; a page that overflows is split in half and the upper
+ * half moves to a new page linked right after it.
+ * @return : false if the value is already in the list
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoPostingList(page_id_t head_page_id, const ValueType &value) {
+  std::vector<RID> rids;
+  page_id_t page_id = head_page_id;
+  while (true) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    auto *posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    rids.clear();
+    posting_page->Decode(&rids);
+    if (posting_page->GetNextPageId() != INVALID_PAGE_ID && rids.back().Get() < value.Get()) {
+      page_id_t next_page_id = posting_page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+      continue;
+    }
+    auto pos = std::lower_bound(rids.begin(), rids.end(), value,
+                                [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    if (pos != rids.end() && *pos == value) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    rids.insert(pos, value);
+    if (posting_page->Encode(rids, 0, rids.size()) < rids.size()) {
+      page_id_t new_page_id;
+      Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+      if (new_page == nullptr) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new posting page");
+      }
+      auto *new_posting_page = reinterpret_cast<BPlusTreePostingPage *>(new_page->GetData());
+      new_posting_page->Init(new_page_id);
+      size_t half = rids.size() / 2;
+      posting_page->Encode(rids, 0, half);
+      new_posting_page->Encode(rids, half, rids.size());
+      new_posting_page->SetNextPageId(posting_page->GetNextPageId());
+      posting_page->SetNextPageId(new_page_id);
+      buffer_pool_manager_->UnpinPage(new_page_id, true);
+    }
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return true;
+  }
+}
+
+/*
+ * Remove value from the posting list. Emptied pages are unlinked and deleted;
+ * an emptied head page takes over the content of its successor so the
+ * reference stored in the leaf stays valid. When a single value is left the
+ * list is deleted and that value is handed back through "remaining" so the
+ * caller can store it inline again.
+ * @return : true means the value was found and removed
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::RemoveFromPostingList(page_id_t head_page_id, const ValueType &value, bool *collapsed,
+                                           ValueType *remaining) {
+  std::vector<RID> rids;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    auto *posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    rids.clear();
+    posting_page->Decode(&rids);
+    page_id_t next_page_id = posting_page->GetNextPageId();
+    auto pos = std::lower_bound(rids.begin(), rids.end(), value,
+                                [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    if (pos == rids.end() || !(*pos == value)) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      if (pos != rids.end()) {
+        // the list is sorted, so the value cannot show up on a later page
+        return false;
+      }
+      prev_page_id = page_id;
+      page_id = next_page_id;
+      continue;
+    }
+    rids.erase(pos);
+    if (!rids.empty() || (next_page_id == INVALID_PAGE_ID && prev_page_id == INVALID_PAGE_ID)) {
+      posting_page->Encode(rids, 0, rids.size());
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    } else if (prev_page_id == INVALID_PAGE_ID) {
+      // emptied head page: pull in the content of the next page
+      Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+      auto *next_posting_page = reinterpret_cast<BPlusTreePostingPage *>(next_page->GetData());
+      next_posting_page->Decode(&rids);
+      posting_page->Encode(rids, 0, rids.size());
+      posting_page->SetNextPageId(next_posting_page->GetNextPageId());
+      buffer_pool_manager_->UnpinPage(next_page_id, false);
+      buffer_pool_manager_->DeletePage(next_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    } else {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      Page *prev_page = buffer_pool_manager_->FetchPage(prev_page_id);
+      reinterpret_cast<BPlusTreePostingPage *>(prev_page->GetData())->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    }
+
+    Page *head_page = buffer_pool_manager_->FetchPage(head_page_id);
+    auto *head_posting_page = reinterpret_cast<BPlusTreePostingPage *>(head_page->GetData());
+    *collapsed = head_posting_page->GetCount() == 1 && head_posting_page->GetNextPageId() == INVALID_PAGE_ID;
+    if (*collapsed) {
+      rids.clear();
+      head_posting_page->Decode(&rids);
+      *remaining = rids[0];
+    }
+    buffer_pool_manager_->UnpinPage(head_page_id, false);
+    if (*collapsed) {
+      buffer_pool_manager_->DeletePage(head_page_id);
+    }
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Delete every page of the posting list starting at head_page_id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePostingList(page_id_t head_page_id) {
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    page_id_t next_page_id = reinterpret_cast<BPlusTreePostingPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -321,9 +646,14 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
-  KeyType dummy;
+  KeyType dummy{};
   Page *page = FindLeafPage(dummy, true);
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, page->GetPageId(), 0);
+  if (page == nullptr) {
+    return end();
+  }
+  page_id_t page_id = page->GetPageId();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page_id, 0);
 }
 
 /*
@@ -334,8 +664,19 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
   Page *page = FindLeafPage(key);
-  LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, page->GetPageId(), leaf->KeyIndex(key, comparator_));
+  if (page == nullptr) {
+    return end();
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  page_id_t page_id = page->GetPageId();
+  int index = leaf->KeyIndex(key, comparator_);
+  page_id_t next_page_id = leaf->GetNextPageId();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (index == leaf->GetSize()) {
+    // every key in this leaf is smaller, so the scan starts at the next leaf
+    return next_page_id == INVALID_PAGE_ID ? end() : INDEXITERATOR_TYPE(buffer_pool_manager_, next_page_id, 0);
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page_id, index);
 }
 
 /*
@@ -355,26 +696,21 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(buffer_pool
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  BPlusTreePage *root_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  Page *leaf_page;
-  if(root_page->IsLeafPage()){
-    leaf_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  } else{
-    BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>  *internal_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-    Page* internal_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    BPlusTreePage *internal_btree_page = reinterpret_cast<BPlusTreePage *>(internal_page->GetData());
-    page_id_t child_page_id = internal_root_page-> Lookup(key, comparator_);
-    while(!internal_btree_page->IsLeafPage()){
-      internal_btree_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
-      if(!internal_btree_page->IsLeafPage()){
-        internal_root_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>  *>(buffer_pool_manager_->FetchPage(child_page_id)->GetData());
-        child_page_id = (leftMost) ? internal_root_page-> ValueAt(0) : internal_root_page-> Lookup(key, comparator_);
-      }
-    }
-    leaf_page = buffer_pool_manager_->FetchPage(child_page_id);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  // hold at most two pins at a time: the current node and the child we are moving to
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+    Page *child = buffer_pool_manager_->FetchPage(child_page_id);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   }
-  return leaf_page;
-  //throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
+  return page;
 }
 
 /*
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/storage/index/bloom_filter.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/bloom_filter.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+// spreads weak hashes over all 64 bits (the MurmurHash3 finalizer)
+uint64_t Mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+}  // namespace
+
+BloomFilter::BloomFilter(size_t num_keys, size_t bits_per_key) {
+  num_bits_ = std::max<uint64_t>(64, num_keys * bits_per_key);
+  bits_.resize((num_bits_ + 63) / 64, 0);
+  num_bits_ = bits_.size() * 64;
+  // k = ln 2 * bits per key minimizes the false positive rate
+  num_probes_ = std::clamp<uint32_t>(static_cast<uint32_t>(bits_per_key * 69 / 100), 1, 30);
+}
+
+void BloomFilter::Insert(hash_t hash) {
+  uint64_t h = Mix(hash);
+  uint64_t delta = (h >> 33) | (h << 31);
+  for (uint32_t i = 0; i < num_probes_; i++) {
+    uint64_t bit = h % num_bits_;
+    bits_[bit / 64] |= 1ULL << (bit % 64);
+    h += delta;
+  }
+}
+
+bool BloomFilter::MayContain(hash_t hash) const {
+  uint64_t h = Mix(hash);
+  uint64_t delta = (h >> 33) | (h << 31);
+  for (uint32_t i = 0; i < num_probes_; i++) {
+    uint64_t bit = h % num_bits_;
+    if ((bits_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+    h += delta;
+  }
+  return true;
+}
+
+}  // namespace bustub
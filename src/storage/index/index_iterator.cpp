@@ -26,12 +26,17 @@ bool INDEXITERATOR_TYPE::isEnd() { return current_page_id_ == INVALID_PAGE_ID; }
 
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const {
-  return current_page_id_ == itr.current_page_id_ && index_ == itr.index_;
+  return current_page_id_ == itr.current_page_id_ && index_ == itr.index_ && posting_index_ == itr.posting_index_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const {
-  return current_page_id_ != itr.current_page_id_ || index_ != itr.index_;
+bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const { return !(*this == itr); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadPostingList(const MappingType &item) {
+  if (posting_values_.empty() && BPlusTreePostingPage::IsReference(item.second)) {
+    BPlusTreePostingPage::ReadAll(buffer_pool_manager_, item.second.GetPageId(), &posting_values_);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -40,17 +45,30 @@ const MappingType &INDEXITERATOR_TYPE::operator*() {
   page->RLatch();
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
   const MappingType &val = leaf->GetItem(index_);
+  LoadPostingList(val);
+  if (!posting_values_.empty()) {
+    current_ = MappingType(val.first, posting_values_[posting_index_]);
+  }
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-  return val;
+  return posting_values_.empty() ? val : current_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  index_++;
   Page *page = buffer_pool_manager_->FetchPage(current_page_id_);
   page->RLatch();
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+  LoadPostingList(leaf->GetItem(index_));
+  if (++posting_index_ < posting_values_.size()) {
+    // still walking the posting list of the same key
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return *this;
+  }
+  posting_values_.clear();
+  posting_index_ = 0;
+  index_++;
   if (index_ >= leaf->GetSize()) {
     current_page_id_ = leaf->GetNextPageId();
     index_ = 0;
@@ -60,6 +78,53 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+size_t INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *batch, const KeyComparator &comparator,
+                                     const KeyType *upper_bound, bool prefetch_next) {
+  batch->clear();
+  // loop so that leaves emptied by removals do not end the scan early
+  while (batch->empty() && !isEnd()) {
+    Page *page = buffer_pool_manager_->FetchPage(current_page_id_);
+    page->RLatch();
+    auto *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+    int end = leaf->GetSize();
+    bool reached_bound = false;
+    if (upper_bound != nullptr && end > index_ && comparator(leaf->KeyAt(end - 1), *upper_bound) > 0) {
+      end = leaf->KeyIndex(*upper_bound, comparator);
+      while (end < leaf->GetSize() && comparator(leaf->KeyAt(end), *upper_bound) == 0) {
+        end++;
+      }
+      reached_bound = true;
+    }
+    for (int i = index_; i < end; i++) {
+      const MappingType &item = leaf->GetItem(i);
+      if (!BPlusTreePostingPage::IsReference(item.second)) {
+        batch->push_back(item);
+        continue;
+      }
+      LoadPostingList(item);
+      for (size_t j = posting_index_; j < posting_values_.size(); j++) {
+        batch->emplace_back(item.first, posting_values_[j]);
+      }
+      posting_values_.clear();
+      posting_index_ = 0;
+    }
+    page_id_t next_page_id = reached_bound ? INVALID_PAGE_ID : leaf->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+
+    current_page_id_ = next_page_id;
+    index_ = 0;
+  }
+  if (prefetch_next && !isEnd()) {
+    Page *next_page = buffer_pool_manager_->FetchPage(current_page_id_);
+    if (next_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(current_page_id_, false);
+    }
+  }
+  return batch->size();
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
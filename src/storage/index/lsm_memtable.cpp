@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/lsm_memtable.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/lsm_memtable.h"
+
+#include <new>
+#include <random>
+
+#include "common/rid.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+LSM_MEMTABLE_TYPE::LSMMemTable(const KeyComparator &comparator)
+    : comparator_(comparator), head_(NewNode(Record(), 0, LSM_MEMTABLE_MAX_HEIGHT)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+LSM_MEMTABLE_TYPE::~LSMMemTable() {
+  Node *node = head_;
+  while (node != nullptr) {
+    Node *next = node->next_[0].load();
+    node->~Node();
+    ::operator delete(node);
+    node = next;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename LSM_MEMTABLE_TYPE::Node *LSM_MEMTABLE_TYPE::NewNode(const Record &record, uint64_t sequence, int height) {
+  void *memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<Node *>));
+  auto *node = new (memory) Node;
+  node->record_ = record;
+  node->sequence_ = sequence;
+  node->height_ = height;
+  for (int level = 0; level < height; level++) {
+    new (&node->next_[level]) std::atomic<Node *>(nullptr);
+  }
+  return node;
+}
+
+/*
+ * Each level holds a quarter of the nodes of the level below.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int LSM_MEMTABLE_TYPE::RandomHeight() {
+  thread_local std::mt19937 generator(std::random_device{}());
+  int height = 1;
+  while (height < LSM_MEMTABLE_MAX_HEIGHT && (generator() & 3) == 0) {
+    height++;
+  }
+  return height;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool LSM_MEMTABLE_TYPE::Before(const Node *a, const Node *b) const {
+  int cmp = comparator_(a->record_.key_, b->record_.key_);
+  return cmp < 0 || (cmp == 0 && a->sequence_ > b->sequence_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSM_MEMTABLE_TYPE::FindSplice(Node *start, int level, const Node *node, Node **prev, Node **next) const {
+  Node *current = start;
+  while (true) {
+    Node *candidate = current->next_[level].load(std::memory_order_acquire);
+    if (candidate == nullptr || !Before(candidate, node)) {
+      *prev = current;
+      *next = candidate;
+      return;
+    }
+    current = candidate;
+  }
+}
+
+/*
+ * The node becomes visible once it is linked on level 0; the upper levels
+ * are only shortcuts, so linking them afterwards cannot make a reader miss it.
+ * A failed compare-and-swap means another writer linked a node right after
+ * prev, so the search resumes from prev.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void LSM_MEMTABLE_TYPE::Put(const Record &record, uint64_t sequence) {
+  Node *node = NewNode(record, sequence, RandomHeight());
+  Node *prev[LSM_MEMTABLE_MAX_HEIGHT];
+  Node *next[LSM_MEMTABLE_MAX_HEIGHT];
+  Node *start = head_;
+  for (int level = LSM_MEMTABLE_MAX_HEIGHT - 1; level >= 0; level--) {
+    FindSplice(start, level, node, &prev[level], &next[level]);
+    start = prev[level];
+  }
+  for (int level = 0; level < node->height_; level++) {
+    while (true) {
+      node->next_[level].store(next[level], std::memory_order_relaxed);
+      if (prev[level]->next_[level].compare_exchange_strong(next[level], node, std::memory_order_release)) {
+        break;
+      }
+      FindSplice(prev[level], level, node, &prev[level], &next[level]);
+    }
+  }
+  num_records_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool LSM_MEMTABLE_TYPE::Get(const KeyType &key, Record *record) const {
+  Node *current = head_;
+  for (int level = LSM_MEMTABLE_MAX_HEIGHT - 1; level >= 0; level--) {
+    Node *next = current->next_[level].load(std::memory_order_acquire);
+    while (next != nullptr && comparator_(next->record_.key_, key) < 0) {
+      current = next;
+      next = current->next_[level].load(std::memory_order_acquire);
+    }
+  }
+  Node *node = current->next_[0].load(std::memory_order_acquire);
+  if (node == nullptr || comparator_(node->record_.key_, key) != 0) {
+    return false;
+  }
+  *record = node->record_;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSM_MEMTABLE_TYPE::Collect(std::vector<Record> *records) const {
+  const Node *last = nullptr;
+  for (Node *node = head_->next_[0].load(); node != nullptr; node = node->next_[0].load()) {
+    // older records of a key follow its newest one
+    if (last == nullptr || comparator_(last->record_.key_, node->record_.key_) != 0) {
+      records->push_back(node->record_);
+      last = node;
+    }
+  }
+}
+
+template class LSMMemTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class LSMMemTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class LSMMemTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class LSMMemTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class LSMMemTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
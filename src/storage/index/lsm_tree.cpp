@@ -0,0 +1,398 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/lsm_tree.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/lsm_tree.h"
+
+namespace bustub {
+INDEX_TEMPLATE_ARGUMENTS
+LSMTREE_TYPE::LSMTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                      size_t memtable_capacity, size_t level0_max_runs, size_t size_ratio,
+                      size_t num_background_threads)
+    : index_name_(std::move(name)),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      memtable_capacity_(memtable_capacity),
+      level0_max_runs_(level0_max_runs),
+      size_ratio_(size_ratio),
+      background_(num_background_threads) {
+  auto version = std::make_shared<Version>();
+  version->memtable_ = std::make_shared<MemTable>(comparator_);
+  memtable_ = version->memtable_.get();
+  current_ = version;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+LSMTREE_TYPE::SortedRun::~SortedRun() {
+  for (page_id_t page_id : page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the value associated with input key. The first record found,
+ * searching from the newest data to the oldest, is the current state of the
+ * key.
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool LSMTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  std::shared_ptr<const Version> version = GetVersion();
+  Record record;
+  bool found = version->memtable_->Get(key, &record);
+  for (size_t i = 0; !found && i < version->immutables_.size(); i++) {
+    found = version->immutables_[i]->Get(key, &record);
+  }
+  hash_t hash = HashKey(key);
+  for (size_t i = 0; !found && i < version->level0_.size(); i++) {
+    found = SearchRun(*version->level0_[i], key, hash, &record);
+  }
+  for (size_t i = 0; !found && i < version->levels_.size(); i++) {
+    found = version->levels_[i] != nullptr && SearchRun(*version->levels_[i], key, hash, &record);
+  }
+  if (!found || record.deleted_) {
+    return false;
+  }
+  result->push_back(record.value_);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool LSMTREE_TYPE::SearchRun(const SortedRun &run, const KeyType &key, hash_t hash, Record *record) {
+  if (!run.bloom_.MayContain(hash)) {
+    return false;
+  }
+  // the key can only be on the last page starting at or before it
+  auto it = std::upper_bound(run.fence_keys_.begin(), run.fence_keys_.end(), key,
+                             [this](const KeyType &a, const KeyType &b) { return comparator_(a, b) < 0; });
+  if (it == run.fence_keys_.begin()) {
+    return false;
+  }
+  page_id_t page_id = run.page_ids_[it - run.fence_keys_.begin() - 1];
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch run page");
+  }
+  // runs are never modified, so the page needs no latch
+  bool found = reinterpret_cast<RunPage *>(page->GetData())->Lookup(key, record, comparator_);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::shared_ptr<const typename LSMTREE_TYPE::Version> LSMTREE_TYPE::GetVersion() {
+  std::lock_guard<std::mutex> guard(version_latch_);
+  return current_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<size_t> LSMTREE_TYPE::GetLevelSizes() {
+  std::shared_ptr<const Version> version = GetVersion();
+  std::vector<size_t> sizes(1, 0);
+  for (const auto &run : version->level0_) {
+    sizes[0] += run->num_records_;
+  }
+  for (const auto &run : version->levels_) {
+    sizes.push_back(run == nullptr ? 0 : run->num_records_);
+  }
+  return sizes;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  Put(Record{key, value, false});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) { Put(Record{key, ValueType(), true}); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::Put(const Record &record) {
+  memtable_latch_.RLock();
+  memtable_->Put(record, next_sequence_++);
+  bool full = memtable_->GetNumRecords() >= memtable_capacity_;
+  memtable_latch_.RUnlock();
+  if (full) {
+    RotateMemTable();
+  }
+}
+
+/*
+ * The exclusive latch waits for the writers still adding to the memtable, so
+ * it is complete once it becomes immutable. Waiting for a flush with the latch
+ * held stalls all writers until the background threads catch up.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::RotateMemTable() {
+  memtable_latch_.WLock();
+  // another writer may have rotated it already
+  if (memtable_->GetNumRecords() >= memtable_capacity_) {
+    std::unique_lock<std::mutex> lock(version_latch_);
+    background_cv_.wait(lock, [this] { return current_->immutables_.size() < LSM_MAX_IMMUTABLE_MEMTABLES; });
+    auto version = std::make_shared<Version>(*current_);
+    version->immutables_.insert(version->immutables_.begin(), version->memtable_);
+    version->memtable_ = std::make_shared<MemTable>(comparator_);
+    memtable_ = version->memtable_.get();
+    current_ = version;
+    lock.unlock();
+    Schedule(&LSMTree::FlushOldestMemTable);
+  }
+  memtable_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * BACKGROUND WORK
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::Schedule(void (LSMTree::*task)()) {
+  {
+    std::lock_guard<std::mutex> guard(version_latch_);
+    pending_tasks_++;
+  }
+  background_.Submit([this, task] {
+    (this->*task)();
+    std::lock_guard<std::mutex> guard(version_latch_);
+    pending_tasks_--;
+    background_cv_.notify_all();
+  });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::WaitForBackgroundWork() {
+  std::unique_lock<std::mutex> lock(version_latch_);
+  background_cv_.wait(lock, [this] { return pending_tasks_ == 0; });
+}
+
+/*
+ * Flushes run one at a time and always take the oldest memtable, so level 0
+ * stays ordered from newest to oldest.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::FlushOldestMemTable() {
+  std::lock_guard<std::mutex> flush_guard(flush_latch_);
+  std::shared_ptr<MemTable> memtable;
+  {
+    std::lock_guard<std::mutex> guard(version_latch_);
+    if (current_->immutables_.empty()) {
+      return;
+    }
+    memtable = current_->immutables_.back();
+  }
+
+  std::vector<Record> records;
+  memtable->Collect(&records);
+  size_t index = 0;
+  std::shared_ptr<SortedRun> run = WriteRun(
+      [&](Record *record) {
+        if (index == records.size()) {
+          return false;
+        }
+        *record = records[index++];
+        return true;
+      },
+      records.size());
+
+  bool compact;
+  {
+    std::lock_guard<std::mutex> guard(version_latch_);
+    auto version = std::make_shared<Version>(*current_);
+    version->immutables_.pop_back();
+    if (run != nullptr) {
+      version->level0_.insert(version->level0_.begin(), run);
+    }
+    compact = version->level0_.size() >= level0_max_runs_;
+    current_ = version;
+  }
+  background_cv_.notify_all();
+  if (compact) {
+    Schedule(&LSMTree::Compact);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t LSMTREE_TYPE::LevelCapacity(size_t level) const {
+  size_t capacity = memtable_capacity_ * size_ratio_;
+  for (size_t i = 0; i < level; i++) {
+    capacity *= size_ratio_;
+  }
+  return capacity;
+}
+
+/*
+ * Merges levels until none is over its limit. Flushes may add runs to level 0
+ * meanwhile; they are newer than everything merged here and stay in level 0.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::Compact() {
+  std::lock_guard<std::mutex> compaction_guard(compaction_latch_);
+  while (true) {
+    std::shared_ptr<const Version> version = GetVersion();
+    // inputs are ordered newest first, target is the index into levels_ of the output
+    std::vector<std::shared_ptr<SortedRun>> inputs;
+    size_t target;
+    if (version->level0_.size() >= level0_max_runs_) {
+      inputs = version->level0_;
+      target = 0;
+    } else {
+      size_t level = 0;
+      while (level < version->levels_.size() &&
+             (version->levels_[level] == nullptr || version->levels_[level]->num_records_ <= LevelCapacity(level))) {
+        level++;
+      }
+      if (level == version->levels_.size()) {
+        return;
+      }
+      inputs.push_back(version->levels_[level]);
+      target = level + 1;
+    }
+    if (target < version->levels_.size() && version->levels_[target] != nullptr) {
+      inputs.push_back(version->levels_[target]);
+    }
+    bool last_level = true;
+    for (size_t level = target + 1; level < version->levels_.size(); level++) {
+      last_level = last_level && version->levels_[level] == nullptr;
+    }
+
+    // k-way merge; on equal keys the newest input wins and the others are skipped
+    DiskManager *disk_manager = buffer_pool_manager_->GetDiskManager();
+    std::vector<RunReader> readers;
+    size_t expected_records = 0;
+    for (const auto &input : inputs) {
+      readers.emplace_back(input.get(), disk_manager);
+      expected_records += input->num_records_;
+    }
+    std::shared_ptr<SortedRun> output = WriteRun(
+        [&](Record *record) {
+          while (true) {
+            int newest = -1;
+            for (size_t i = 0; i < readers.size(); i++) {
+              if (!readers[i].IsEnd() &&
+                  (newest < 0 || comparator_(readers[i].Get().key_, readers[newest].Get().key_) < 0)) {
+                newest = i;
+              }
+            }
+            if (newest < 0) {
+              return false;
+            }
+            *record = readers[newest].Get();
+            for (auto &reader : readers) {
+              if (!reader.IsEnd() && comparator_(reader.Get().key_, record->key_) == 0) {
+                reader.Next();
+              }
+            }
+            // with nothing older below, a tombstone has nothing left to hide
+            if (!last_level || !record->deleted_) {
+              return true;
+            }
+          }
+        },
+        expected_records);
+
+    {
+      std::lock_guard<std::mutex> guard(version_latch_);
+      auto next = std::make_shared<Version>(*current_);
+      if (target == 0) {
+        next->level0_.resize(next->level0_.size() - version->level0_.size());
+      } else {
+        next->levels_[target - 1] = nullptr;
+      }
+      if (next->levels_.size() <= target) {
+        next->levels_.resize(target + 1);
+      }
+      next->levels_[target] = output;
+      current_ = next;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::shared_ptr<typename LSMTREE_TYPE::SortedRun> LSMTREE_TYPE::WriteRun(const std::function<bool(Record *)> &next,
+                                                                         size_t expected_records) {
+  auto run = std::make_shared<SortedRun>(buffer_pool_manager_, expected_records);
+  DiskManager *disk_manager = buffer_pool_manager_->GetDiskManager();
+  std::vector<char> batch(LSM_WRITE_BATCH_PAGES * PAGE_SIZE);
+  size_t batch_pages = 0;
+  RunPage *page = nullptr;
+
+  // pages of a batch get consecutive ids and go to disk with a single write
+  auto write_batch = [&] {
+    page_id_t first_page_id = disk_manager->AllocatePages(batch_pages);
+    disk_manager->WritePages(first_page_id, batch.data(), batch_pages);
+    for (size_t i = 0; i < batch_pages; i++) {
+      run->page_ids_.push_back(first_page_id + i);
+    }
+    batch_pages = 0;
+  };
+
+  Record record;
+  while (next(&record)) {
+    if (page == nullptr || page->IsFull()) {
+      if (batch_pages == LSM_WRITE_BATCH_PAGES) {
+        write_batch();
+      }
+      page = reinterpret_cast<RunPage *>(batch.data() + batch_pages * PAGE_SIZE);
+      page->Init();
+      batch_pages++;
+      run->fence_keys_.push_back(record.key_);
+    }
+    page->Append(record);
+    run->bloom_.Insert(HashKey(record.key_));
+    run->num_records_++;
+  }
+  if (batch_pages > 0) {
+    write_batch();
+  }
+  return run->num_records_ == 0 ? nullptr : run;
+}
+
+/*****************************************************************************
+ * RUN READER
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+LSMTREE_TYPE::RunReader::RunReader(const SortedRun *run, DiskManager *disk_manager)
+    : run_(run), disk_manager_(disk_manager), buffer_(PAGE_SIZE) {
+  ReadPage();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::RunReader::Next() {
+  if (++slot_ == CurrentPage()->GetSize()) {
+    page_index_++;
+    slot_ = 0;
+    ReadPage();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSMTREE_TYPE::RunReader::ReadPage() {
+  if (!IsEnd()) {
+    disk_manager_->ReadPage(run_->page_ids_[page_index_], buffer_.data());
+  }
+}
+
+template class LSMTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class LSMTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class LSMTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class LSMTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class LSMTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_epsilon_tree_internal_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_epsilon_tree_internal_page.h"
+
+#include <algorithm>
+
+#include "common/rid.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new internal page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int max_fanout) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(INVALID_PAGE_ID);
+  SetMaxSize(max_fanout);
+  buffer_size_ = 0;
+  buffer_capacity_ = BufferCapacity(max_fanout);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_EPSILON_TREE_INTERNAL_PAGE_TYPE::BufferCapacity(int max_fanout) {
+  return static_cast<int>((PAGE_SIZE - B_EPSILON_INTERNAL_PAGE_HEADER_SIZE - max_fanout * sizeof(Pivot)) /
+                          sizeof(Message));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_EPSILON_TREE_INTERNAL_PAGE_TYPE::LookupChild(const KeyType &key, const KeyComparator &comparator) const {
+  const Pivot *pivots = PivotArray();
+  // the last pivot whose key is <= the search key, ignoring the invalid first key
+  auto it = std::upper_bound(pivots + 1, pivots + GetSize(), key, [&comparator](const KeyType &lhs, const Pivot &rhs) {
+    return comparator(lhs, rhs.first) < 0;
+  });
+  return (it - 1)->second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_EPSILON_TREE_INTERNAL_PAGE_TYPE::FindMessage(const KeyType &key, const KeyComparator &comparator) const
+    -> const Message * {
+  const Message *messages = MessageArray();
+  auto it = std::lower_bound(messages, messages + buffer_size_, key, [&comparator](const Message &lhs,
+                                                                                    const KeyType &rhs) {
+    return comparator(lhs.key_, rhs) < 0;
+  });
+  if (it == messages + buffer_size_ || comparator(it->key_, key) != 0) {
+    return nullptr;
+  }
+  return it;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_EPSILON_TREE_INTERNAL_PAGE_TYPE::InsertMessage(const Message &message, const KeyComparator &comparator) {
+  if (buffer_size_ == buffer_capacity_) {
+    return false;
+  }
+  auto *messages = const_cast<Message *>(MessageArray());
+  auto it = std::lower_bound(messages, messages + buffer_size_, message.key_,
+                             [&comparator](const Message &lhs, const KeyType &rhs) {
+                               return comparator(lhs.key_, rhs) < 0;
+                             });
+  std::copy_backward(it, messages + buffer_size_, messages + buffer_size_ + 1);
+  *it = message;
+  buffer_size_++;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::Load(std::vector<Pivot> *pivots, std::vector<Message> *messages) const {
+  pivots->assign(PivotArray(), PivotArray() + GetSize());
+  messages->assign(MessageArray(), MessageArray() + buffer_size_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_EPSILON_TREE_INTERNAL_PAGE_TYPE::Store(const std::vector<Pivot> &pivots, const std::vector<Message> &messages) {
+  BUSTUB_ASSERT(static_cast<int>(pivots.size()) <= GetMaxSize(), "too many pivots for the node");
+  BUSTUB_ASSERT(static_cast<int>(messages.size()) <= buffer_capacity_, "too many messages for the node");
+  std::copy(pivots.begin(), pivots.end(), reinterpret_cast<Pivot *>(data_));
+  std::copy(messages.begin(), messages.end(), const_cast<Message *>(MessageArray()));
+  SetSize(static_cast<int>(pivots.size()));
+  buffer_size_ = static_cast<int>(messages.size());
+}
+
+template class BEpsilonTreeInternalPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTreeInternalPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTreeInternalPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTreeInternalPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTreeInternalPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
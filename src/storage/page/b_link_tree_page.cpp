@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_link_tree_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_link_tree_page.h"
+
+#include <algorithm>
+
+#include "common/rid.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new node, leaves live on level 0
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::Init(page_id_t page_id, int level, int max_size) {
+  page_type_ = level == 0 ? IndexPageType::LEAF_PAGE : IndexPageType::INTERNAL_PAGE;
+  level_ = level;
+  size_ = 0;
+  max_size_ = max_size;
+  page_id_ = page_id;
+  right_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_LINK_TREE_PAGE_TYPE::IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const {
+  // the rightmost node of a level has no high key
+  return right_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_LINK_TREE_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  int low = IsLeafPage() ? 0 : 1;
+  int high = size_;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_LINK_TREE_PAGE_TYPE::LookupChild(const KeyType &key, const KeyComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index < size_ && comparator(array_[index].first, key) == 0) {
+    return array_[index].second;
+  }
+  return array_[index - 1].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                            const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1] = MappingType(new_key, new_value);
+  size_ = 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  std::move_backward(array_ + index, array_ + size_, array_ + size_ + 1);
+  array_[index] = MappingType(key, value);
+  size_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::RemoveAt(int index) {
+  std::move(array_ + index + 1, array_ + size_, array_ + index);
+  size_--;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_LINK_TREE_PAGE_TYPE::MoveHalfTo(BLinkTreePage *recipient) {
+  int keep = size_ / 2;
+  std::copy(array_ + keep, array_ + size_, recipient->array_);
+  recipient->size_ = size_ - keep;
+  size_ = keep;
+
+  recipient->high_key_ = high_key_;
+  recipient->right_page_id_ = right_page_id_;
+  high_key_ = recipient->array_[0].first;
+  right_page_id_ = recipient->page_id_;
+  return high_key_;
+}
+
+// leaves map keys to RIDs, internal nodes map keys to child page ids
+template class BLinkTreePage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTreePage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTreePage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTreePage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTreePage<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BLinkTreePage<GenericKey<4>, page_id_t, GenericComparator<4>>;
+template class BLinkTreePage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+template class BLinkTreePage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+template class BLinkTreePage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+template class BLinkTreePage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -89,6 +89,12 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
   //return array[0];
 }
 
+/*
+ * Helper method to replace the value associated with input "index"
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array[index].second = value; }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -100,7 +106,18 @@ INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
   BUSTUB_ASSERT((uint64_t)GetSize() < LEAF_PAGE_SIZE, "inserting into non full leaf node");
   //Fetch
-  int index = KeyIndex(key, comparator);
+  InsertAt(KeyIndex(key, comparator), key, value);
+  return GetSize();
+  //return 0;
+}
+
+/*
+ * Insert key & value pair at input "index", shifting the following entries
+ * back. The caller is responsible for keeping keys ordered.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT((uint64_t)GetSize() < LEAF_PAGE_SIZE, "inserting into non full leaf node");
   int cur = GetSize();
   while (cur > index) {
     array[cur] = array[cur - 1];
@@ -108,21 +125,32 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
   }
   array[cur] = MappingType(key, value);
   IncreaseSize(1);
-  return GetSize();
-  //return 0;
 }
 
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
 /*
- * Remove half of key & value pairs from this page to "recipient" page
+ * Remove half of key & value pairs from this page to "recipient" page. The
+ * split point moves to the nearest key boundary so that entries sharing a key
+ * never end up on different pages; the page must hold at least two keys.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
-  recipient->CopyNFrom(array + (GetSize() + 1) / 2, GetSize() / 2);
-  recipient->SetSize(GetSize() / 2);
-  SetSize((GetSize() + 1) / 2);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient, const KeyComparator &comparator) {
+  int half = (GetSize() + 1) / 2;
+  int lower = half;
+  int upper = half;
+  while (lower > 0 && comparator(array[lower - 1].first, array[lower].first) == 0) {
+    lower--;
+  }
+  while (upper < GetSize() && comparator(array[upper - 1].first, array[upper].first) == 0) {
+    upper++;
+  }
+  int split = lower > 0 && (upper == GetSize() || half - lower <= upper - half) ? lower : upper;
+  BUSTUB_ASSERT(split > 0 && split < GetSize(), "a leaf holding a single key cannot be split");
+  recipient->CopyNFrom(array + split, GetSize() - split);
+  recipient->SetSize(GetSize() - split);
+  SetSize(split);
 }
 
 /*
@@ -146,7 +174,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
-  for (int cur = 1; cur < GetSize(); cur++) {
+  for (int cur = 0; cur < GetSize(); cur++) {
     if (comparator(key, array[cur].first) == 0) {
       *value = array[cur].second;
       return true;
@@ -171,16 +199,24 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
   //TODO: Check if need to return size or 0
   //KeyIndex would give index with matching key, since key is present
   int index = KeyIndex(key, comparator);
-  for(int cur=index; cur< GetSize(); cur++){
-    array[cur] = array[cur+1];
-  }
-  IncreaseSize(-1);
+  RemoveAt(index);
   return GetSize();
 
 
   //return 0;
 }
 
+/*
+ * Remove the key & value pair at input "index"
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  for (int cur = index; cur < GetSize() - 1; cur++) {
+    array[cur] = array[cur + 1];
+  }
+  IncreaseSize(-1);
+}
+
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new posting page
+ */
+void BPlusTreePostingPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  next_page_id_ = INVALID_PAGE_ID;
+  count_ = 0;
+  data_size_ = 0;
+}
+
+void BPlusTreePostingPage::Decode(std::vector<RID> *result) const {
+  uint64_t previous = 0;
+  size_t offset = 0;
+  for (int i = 0; i < count_; i++) {
+    uint64_t delta = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+      byte = data_[offset++];
+      delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      shift += 7;
+    } while ((byte & 0x80) != 0);
+    previous += delta;
+    result->emplace_back(static_cast<int64_t>(previous));
+  }
+}
+
+size_t BPlusTreePostingPage::Encode(const std::vector<RID> &rids, size_t begin, size_t end) {
+  // a varint of a 64 bit delta never takes more than 10 bytes
+  static constexpr size_t MAX_VARINT_SIZE = 10;
+  uint64_t previous = 0;
+  size_t offset = 0;
+  size_t cur = begin;
+  for (; cur < end && offset + MAX_VARINT_SIZE <= DATA_CAPACITY; cur++) {
+    auto current = static_cast<uint64_t>(rids[cur].Get());
+    uint64_t delta = current - previous;
+    while (delta >= 0x80) {
+      data_[offset++] = static_cast<uint8_t>(delta | 0x80);
+      delta >>= 7;
+    }
+    data_[offset++] = static_cast<uint8_t>(delta);
+    previous = current;
+  }
+  count_ = static_cast<int>(cur - begin);
+  data_size_ = static_cast<int>(offset);
+  return cur - begin;
+}
+
+void BPlusTreePostingPage::ReadAll(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id,
+                                   std::vector<RID> *result) {
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager->FetchPage(page_id);
+    auto *posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    posting_page->Decode(result);
+    page_id_t next_page_id = posting_page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
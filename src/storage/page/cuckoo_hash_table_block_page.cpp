@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table_block_page.cpp
+//
+// Identification: src/storage/page/cuckoo_hash_table_block_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/cuckoo_hash_table_block_page.h"
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_BLOCK_TYPE::GetValue(size_t bucket, const KeyType &key, uint8_t fingerprint,
+                                            const KeyComparator &cmp, std::vector<ValueType> *result) const {
+  bool found = false;
+  for (size_t slot = 0; slot < CUCKOO_BUCKET_SLOTS; slot++) {
+    if (fingerprints_[bucket][slot] == fingerprint && cmp(array_[bucket][slot].first, key) == 0) {
+      result->push_back(array_[bucket][slot].second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_BLOCK_TYPE::Contains(size_t bucket, const KeyType &key, const ValueType &value,
+                                            uint8_t fingerprint, const KeyComparator &cmp) const {
+  for (size_t slot = 0; slot < CUCKOO_BUCKET_SLOTS; slot++) {
+    if (fingerprints_[bucket][slot] == fingerprint && cmp(array_[bucket][slot].first, key) == 0 &&
+        array_[bucket][slot].second == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_BLOCK_TYPE::Insert(size_t bucket, const KeyType &key, const ValueType &value,
+                                          uint8_t fingerprint) {
+  static_assert(sizeof(CuckooHashTableBlockPage) <= PAGE_SIZE, "cuckoo hash table block does not fit into a page");
+  for (size_t slot = 0; slot < CUCKOO_BUCKET_SLOTS; slot++) {
+    if (fingerprints_[bucket][slot] == CUCKOO_FINGERPRINT_EMPTY) {
+      SetAt(bucket, slot, key, value, fingerprint);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_BLOCK_TYPE::Remove(size_t bucket, const KeyType &key, const ValueType &value,
+                                          uint8_t fingerprint, const KeyComparator &cmp) {
+  for (size_t slot = 0; slot < CUCKOO_BUCKET_SLOTS; slot++) {
+    if (fingerprints_[bucket][slot] == fingerprint && cmp(array_[bucket][slot].first, key) == 0 &&
+        array_[bucket][slot].second == value) {
+      fingerprints_[bucket][slot] = CUCKOO_FINGERPRINT_EMPTY;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_BLOCK_TYPE::SetAt(size_t bucket, size_t slot, const KeyType &key, const ValueType &value,
+                                         uint8_t fingerprint) {
+  array_[bucket][slot] = MappingType(key, value);
+  fingerprints_[bucket][slot] = fingerprint;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_BLOCK_TYPE::Size(size_t bucket) const {
+  size_t size = 0;
+  for (size_t slot = 0; slot < CUCKOO_BUCKET_SLOTS; slot++) {
+    size += IsOccupied(bucket, slot) ? 1 : 0;
+  }
+  return size;
+}
+
+template class CuckooHashTableBlockPage<int, int, IntComparator>;
+template class CuckooHashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class CuckooHashTableBlockPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class CuckooHashTableBlockPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class CuckooHashTableBlockPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class CuckooHashTableBlockPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_bucket_page.cpp
+//
+// Identification: src/storage/page/extendible_hash_table_bucket_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_hash_table_bucket_page.h"
+
+#include "common/macros.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::Init(uint32_t max_size) {
+  BUSTUB_ASSERT(max_size > 0 && max_size <= BUCKET_ARRAY_SIZE, "bucket size out of range");
+  size_ = 0;
+  max_size_ = max_size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::GetValue(const KeyType &key, const KeyComparator &cmp,
+                                      std::vector<ValueType> *result) const {
+  bool found = false;
+  for (uint32_t i = 0; i < size_; i++) {
+    if (cmp(array_[i].first, key) == 0) {
+      result->push_back(array_[i].second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::Contains(const KeyType &key, const ValueType &value, const KeyComparator &cmp) const {
+  for (uint32_t i = 0; i < size_; i++) {
+    if (cmp(array_[i].first, key) == 0 && array_[i].second == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  if (IsFull()) {
+    return false;
+  }
+  array_[size_++] = MappingType(key, value);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::Remove(const KeyType &key, const ValueType &value, const KeyComparator &cmp) {
+  for (uint32_t i = 0; i < size_; i++) {
+    if (cmp(array_[i].first, key) == 0 && array_[i].second == value) {
+      RemoveAt(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  array_[bucket_idx] = array_[--size_];
+}
+
+template class ExtendibleHashTableBucketPage<int, int, IntComparator>;
+template class ExtendibleHashTableBucketPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
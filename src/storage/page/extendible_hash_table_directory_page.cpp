@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/extendible_hash_table_directory_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_hash_table_directory_page.h"
+
+#include <unordered_map>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void ExtendibleHashTableDirectoryPage::Init(page_id_t page_id, uint32_t max_depth) {
+  BUSTUB_ASSERT(max_depth <= DIRECTORY_MAX_DEPTH, "directory depth out of range");
+  page_id_ = page_id;
+  max_depth_ = max_depth;
+  global_depth_ = 0;
+  for (uint32_t i = 0; i < DIRECTORY_ARRAY_SIZE; i++) {
+    local_depths_[i] = 0;
+    bucket_page_ids_[i] = INVALID_PAGE_ID;
+  }
+}
+
+uint32_t ExtendibleHashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_index) const {
+  uint32_t local_depth = local_depths_[bucket_index];
+  return local_depth == 0 ? bucket_index : bucket_index ^ (1U << (local_depth - 1));
+}
+
+void ExtendibleHashTableDirectoryPage::IncrGlobalDepth() {
+  BUSTUB_ASSERT(global_depth_ < max_depth_, "directory is at its maximal depth");
+  uint32_t size = Size();
+  for (uint32_t i = 0; i < size; i++) {
+    local_depths_[size + i] = local_depths_[i];
+    bucket_page_ids_[size + i] = bucket_page_ids_[i];
+  }
+  global_depth_++;
+}
+
+void ExtendibleHashTableDirectoryPage::DecrGlobalDepth() {
+  BUSTUB_ASSERT(CanShrink(), "directory cannot shrink");
+  global_depth_--;
+  uint32_t size = Size();
+  for (uint32_t i = size; i < 2 * size; i++) {
+    local_depths_[i] = 0;
+    bucket_page_ids_[i] = INVALID_PAGE_ID;
+  }
+}
+
+bool ExtendibleHashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExtendibleHashTableDirectoryPage::VerifyIntegrity() const {
+  std::unordered_map<page_id_t, uint32_t> slots_per_bucket;
+  std::unordered_map<page_id_t, uint32_t> depth_of_bucket;
+  for (uint32_t i = 0; i < Size(); i++) {
+    page_id_t bucket_page_id = bucket_page_ids_[i];
+    BUSTUB_ASSERT(bucket_page_id != INVALID_PAGE_ID, "directory slot without bucket");
+    BUSTUB_ASSERT(local_depths_[i] <= global_depth_, "local depth exceeds global depth");
+    auto depth = depth_of_bucket.emplace(bucket_page_id, local_depths_[i]).first;
+    BUSTUB_ASSERT(depth->second == local_depths_[i], "slots of a bucket disagree on its local depth");
+    BUSTUB_ASSERT(bucket_page_ids_[i & ((1U << local_depths_[i]) - 1)] == bucket_page_id,
+                  "slot does not share the bucket of its low bits");
+    slots_per_bucket[bucket_page_id]++;
+  }
+  for (const auto &entry : slots_per_bucket) {
+    BUSTUB_ASSERT(entry.second == 1U << (global_depth_ - depth_of_bucket[entry.first]),
+                  "bucket is not referenced by all slots of its local depth");
+  }
+}
+
+}  // namespace bustub
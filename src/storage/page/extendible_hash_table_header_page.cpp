@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_header_page.cpp
+//
+// Identification: src/storage/page/extendible_hash_table_header_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_hash_table_header_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void ExtendibleHashTableHeaderPage::Init(page_id_t page_id, uint32_t max_depth) {
+  BUSTUB_ASSERT(max_depth <= HEADER_MAX_DEPTH, "header depth out of range");
+  page_id_ = page_id;
+  max_depth_ = max_depth;
+  for (page_id_t &directory_page_id : directory_page_ids_) {
+    directory_page_id = INVALID_PAGE_ID;
+  }
+}
+
+uint32_t ExtendibleHashTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const {
+  // shifting a 32 bit value by 32 is undefined
+  return max_depth_ == 0 ? 0 : hash >> (32 - max_depth_);
+}
+
+page_id_t ExtendibleHashTableHeaderPage::GetDirectoryPageId(uint32_t directory_index) const {
+  return directory_page_ids_[directory_index];
+}
+
+void ExtendibleHashTableHeaderPage::SetDirectoryPageId(uint32_t directory_index, page_id_t directory_page_id) {
+  directory_page_ids_[directory_index] = directory_page_id;
+}
+
+}  // namespace bustub
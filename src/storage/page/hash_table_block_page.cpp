@@ -10,37 +10,143 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
+#include <thread>  // NOLINT
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
 
 namespace bustub {
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Init() {
+  BeginWrite();
+  next_page_id_ = INVALID_PAGE_ID;
+  for (auto &flags : occupied_) {
+    flags.store(0);
+  }
+  for (auto &flags : readable_) {
+    flags.store(0);
+  }
+  memset(fingerprints_, HASH_TABLE_FINGERPRINT_EMPTY, sizeof(fingerprints_));
+  EndWrite();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::BeginWrite() {
+  version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  // keeps the writes below from becoming visible before the odd version
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::EndWrite() {
+  version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t fingerprint) {
+  static_assert(sizeof(HashTableBlockPage) + BLOCK_ARRAY_SIZE * sizeof(MappingType) <= PAGE_SIZE,
+                "block page does not fit into a page");
+  if (IsReadable(bucket_ind)) {
+    return false;
+  }
+  BeginWrite();
+  array_[bucket_ind] = MappingType(key, value);
+  fingerprints_[bucket_ind] = fingerprint;
+  char mask = static_cast<char>(1 << (bucket_ind % 8));
+  occupied_[bucket_ind / 8].fetch_or(mask);
+  readable_[bucket_ind / 8].fetch_or(mask);
+  EndWrite();
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  BeginWrite();
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))));
+  fingerprints_[bucket_ind] = HASH_TABLE_FINGERPRINT_TOMBSTONE;
+  EndWrite();
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  return (occupied_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  return (readable_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::MatchGroup(slot_offset_t bucket_ind, size_t n, uint8_t fingerprint, uint32_t *matches,
+                                       uint32_t *empties) const {
+  // the group may run past the last slot into the padding of the fingerprints, whose bits are masked off below
+  const uint8_t *group = fingerprints_ + bucket_ind;
+#if defined(__AVX2__)
+  __m256i control = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(group));
+  *matches = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(control, _mm256_set1_epi8(static_cast<char>(fingerprint)))));
+  *empties = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(control, _mm256_set1_epi8(HASH_TABLE_FINGERPRINT_EMPTY))));
+#elif defined(__SSE2__)
+  __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  *matches = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(static_cast<char>(fingerprint)))));
+  *empties =
+      static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(HASH_TABLE_FINGERPRINT_EMPTY))));
+#else
+  *matches = 0;
+  *empties = 0;
+  for (uint32_t i = 0; i < HASH_TABLE_BLOCK_GROUP_SIZE; i++) {
+    *matches |= static_cast<uint32_t>(group[i] == fingerprint) << i;
+    *empties |= static_cast<uint32_t>(group[i] == HASH_TABLE_FINGERPRINT_EMPTY) << i;
+  }
+#endif
+  if (n < 32) {
+    uint32_t mask = (1U << n) - 1;
+    *matches &= mask;
+    *empties &= mask;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::ReadGroup(slot_offset_t bucket_ind, size_t n, uint8_t fingerprint, uint32_t *matches,
+                                      uint32_t *empties, MappingType *pairs) const {
+  while (true) {
+    uint32_t version = version_.load(std::memory_order_acquire);
+    if (version % 2 == 1) {
+      // a writer is changing the block
+      std::this_thread::yield();
+      continue;
+    }
+    MatchGroup(bucket_ind, n, fingerprint, matches, empties);
+    for (uint32_t bits = *matches; bits != 0; bits &= bits - 1) {
+      uint32_t i = __builtin_ctz(bits);
+      pairs[i] = array_[bucket_ind + i];
+    }
+    // keeps the reads above from moving past the check of the version
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load(std::memory_order_relaxed) == version) {
+      return;
+    }
+  }
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
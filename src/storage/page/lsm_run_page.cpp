@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/lsm_run_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/lsm_run_page.h"
+
+#include "common/rid.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSM_RUN_PAGE_TYPE::Init() {
+  size_ = 0;
+  unused_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void LSM_RUN_PAGE_TYPE::Append(const Record &record) { array_[size_++] = record; }
+
+INDEX_TEMPLATE_ARGUMENTS
+bool LSM_RUN_PAGE_TYPE::Lookup(const KeyType &key, Record *record, const KeyComparator &comparator) const {
+  int low = 0;
+  int high = size_ - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    int cmp = comparator(array_[mid].key_, key);
+    if (cmp == 0) {
+      *record = array_[mid];
+      return true;
+    }
+    if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return false;
+}
+
+template class LSMRunPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class LSMRunPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class LSMRunPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class LSMRunPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class LSMRunPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
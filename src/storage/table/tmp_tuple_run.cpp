@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.cpp
+//
+// Identification: src/storage/table/tmp_tuple_run.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_run.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleRun::~TmpTupleRun() {
+  Finish();
+  for (page_id_t page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleRun::Append(const Tuple &tuple) {
+  TmpTuple out(INVALID_PAGE_ID, 0);
+  if (page_ == nullptr || !page_->Insert(tuple, &out)) {
+    Finish();
+    page_id_t page_id;
+    page_ = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+    if (page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a temporary page");
+    }
+    page_ids_.push_back(page_id);
+    page_->Init(page_id, PAGE_SIZE);
+    if (!page_->Insert(tuple, &out)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "tuple too large for a temporary page");
+    }
+  }
+  num_tuples_++;
+  num_bytes_ += sizeof(uint32_t) + tuple.GetLength();
+}
+
+void TmpTupleRun::Finish() {
+  if (page_ != nullptr) {
+    bpm_->UnpinPage(page_->GetTablePageId(), true);
+    page_ = nullptr;
+  }
+}
+
+TmpTupleRun::Reader::~Reader() {
+  if (page_ != nullptr) {
+    run_->bpm_->UnpinPage(page_->GetTablePageId(), false);
+  }
+}
+
+bool TmpTupleRun::Reader::Next(Tuple *tuple) {
+  BUSTUB_ASSERT(run_->page_ == nullptr, "The run must be finished before it is read.");
+  while (page_ == nullptr || offsets_.empty()) {
+    if (page_ != nullptr) {
+      run_->bpm_->UnpinPage(page_->GetTablePageId(), false);
+      page_ = nullptr;
+    }
+    if (page_idx_ == run_->page_ids_.size()) {
+      return false;
+    }
+    page_ = reinterpret_cast<TmpTuplePage *>(run_->bpm_->FetchPage(run_->page_ids_[page_idx_++]));
+    if (page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a temporary page");
+    }
+    // a page holds its tuples from the end backwards, so the last one inserted comes first
+    for (uint32_t offset = page_->GetFreeSpacePointer(); offset != PAGE_SIZE; offset = page_->GetNextOffset(offset)) {
+      offsets_.push_back(offset);
+    }
+  }
+  page_->Get(offsets_.back(), tuple);
+  offsets_.pop_back();
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,283 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <bitset>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/plans/aggregation_plan.h"
+#include "gtest/gtest.h"
+#include "murmur3/MurmurHash3.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the chi-square statistic of the hashes spread over num_buckets buckets by bucket_of */
+template <typename BucketFn>
+double ChiSquare(const std::vector<hash_t> &hashes, size_t num_buckets, BucketFn bucket_of) {
+  std::vector<size_t> counts(num_buckets);
+  for (auto hash : hashes) {
+    counts[bucket_of(hash)]++;
+  }
+  double expected = static_cast<double>(hashes.size()) / num_buckets;
+  double chi_square = 0;
+  for (auto count : counts) {
+    chi_square += (count - expected) * (count - expected) / expected;
+  }
+  return chi_square;
+}
+
+/**
+ * Checks that flipping any input bit flips every output bit with probability close to 1/2. Inputs of
+ * more than 64 bytes only flip a sample of their bits.
+ */
+template <typename HashFn>
+void CheckAvalanche(size_t length, HashFn hash_fn) {
+  const int trials = 100;
+  std::mt19937_64 generator(length);
+  std::vector<char> input(length);
+  size_t bit_step = length > 64 ? 61 : 1;
+  std::vector<int> output_flips(64);
+  int samples = 0;
+  for (size_t bit = 0; bit < 8 * length; bit += bit_step) {
+    int flips = 0;
+    for (int trial = 0; trial < trials; trial++) {
+      for (auto &byte : input) {
+        byte = static_cast<char>(generator());
+      }
+      hash_t before = hash_fn(input.data(), length);
+      input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+      std::bitset<64> diff(before ^ hash_fn(input.data(), length));
+      flips += diff.count();
+      for (size_t out = 0; out < 64; out++) {
+        output_flips[out] += diff[out];
+      }
+    }
+    samples += trials;
+    double rate = flips / (64.0 * trials);
+    ASSERT_GT(rate, 0.4) << "length " << length << ", input bit " << bit;
+    ASSERT_LT(rate, 0.6) << "length " << length << ", input bit " << bit;
+  }
+  // five standard deviations of a fair coin
+  double tolerance = 5 * 0.5 / std::sqrt(samples);
+  for (size_t out = 0; out < 64; out++) {
+    double rate = static_cast<double>(output_flips[out]) / samples;
+    EXPECT_NEAR(rate, 0.5, tolerance) << "length " << length << ", output bit " << out;
+  }
+}
+
+}  // namespace
+
+TEST(HashUtilTest, IntegersNeverCollide) {
+  std::unordered_set<hash_t> hashes;
+  const uint64_t count = 1 << 18;
+  for (uint64_t i = 0; i < count; i++) {
+    hashes.insert(HashUtil::HashInt(i));
+    // keys that differ only in their high half
+    hashes.insert(HashUtil::HashInt((i + 1) << 32 | 7));
+  }
+  EXPECT_EQ(2 * count, hashes.size());
+}
+
+TEST(HashUtilTest, Crc32MatchesReferenceValues) {
+  // the iSCSI test vectors of RFC 3720: 32 bytes of zeros, of ones and counting up, with the register inverted
+  // before and after
+  auto crc32c = [](uint32_t first_byte, uint32_t byte_step, auto crc32) {
+    uint32_t crc = 0xffffffff;
+    for (uint32_t word = 0; word < 8; word++) {
+      uint32_t value = 0;
+      for (uint32_t i = 0; i < 4; i++) {
+        value |= ((first_byte + (4 * word + i) * byte_step) & 0xff) << (8 * i);
+      }
+      crc = crc32(crc, value);
+    }
+    return ~crc;
+  };
+  for (auto crc32 : {HashUtil::Crc32, HashUtil::Crc32Portable}) {
+    EXPECT_EQ(0x8a9136aa, crc32c(0, 0, crc32));
+    EXPECT_EQ(0x62a8ab43, crc32c(0xff, 0, crc32));
+    EXPECT_EQ(0x46dd794e, crc32c(0, 1, crc32));
+  }
+
+  // the table matches the instruction, so HashInt does not depend on the target
+  std::mt19937 generator(15445);
+  for (int i = 0; i < 10000; i++) {
+    uint32_t crc = generator();
+    uint32_t value = generator();
+    ASSERT_EQ(HashUtil::Crc32(crc, value), HashUtil::Crc32Portable(crc, value)) << crc << " " << value;
+  }
+}
+
+TEST(HashUtilTest, Avalanche) {
+  CheckAvalanche(sizeof(uint64_t), [](const char *bytes, size_t) {
+    uint64_t key;
+    memcpy(&key, bytes, sizeof(key));
+    return HashUtil::HashInt(key);
+  });
+  // every branch of HashBytes: tiny, short, medium, the 48-byte loop, and the striped long loop
+  for (size_t length : {1, 3, 4, 7, 8, 12, 16, 17, 33, 48, 49, 100, 256, 257, 320, 1100}) {
+    CheckAvalanche(length, HashUtil::HashBytes);
+  }
+  // the seed-dependent final stripe
+  CheckAvalanche(64 * 16 + 1, HashUtil::HashBytes);
+}
+
+TEST(HashUtilTest, BucketDistribution) {
+  const size_t num_keys = 100000;
+  const size_t num_buckets = 1024;
+  // the chi-square statistic of 1023 degrees of freedom has mean 1023 and standard deviation 45
+  const double max_chi_square = 1023 + 6 * 45;
+  auto low_bits = [&](hash_t hash) { return hash % num_buckets; };
+  auto high_bits = [&](hash_t hash) { return hash >> 54; };
+
+  std::vector<std::vector<hash_t>> key_sets(4);
+  for (size_t i = 0; i < num_keys; i++) {
+    // sequential integers, strided integers, sequential names and long strings that differ at the end
+    key_sets[0].push_back(HashUtil::HashInt(i));
+    key_sets[1].push_back(HashUtil::HashInt(i * num_buckets));
+    std::string name = "key_" + std::to_string(i);
+    key_sets[2].push_back(HashUtil::HashBytes(name.data(), name.size()));
+    std::string long_name = std::string(500, 'x') + name;
+    key_sets[3].push_back(HashUtil::HashBytes(long_name.data(), long_name.size()));
+  }
+  for (size_t set = 0; set < key_sets.size(); set++) {
+    EXPECT_LT(ChiSquare(key_sets[set], num_buckets, low_bits), max_chi_square) << "key set " << set;
+    EXPECT_LT(ChiSquare(key_sets[set], num_buckets, high_bits), max_chi_square) << "key set " << set;
+  }
+}
+
+TEST(HashUtilTest, LinearProbingClusters) {
+  // sequential names in an open addressing table at load factor 0.75
+  const size_t capacity = 1 << 16;
+  const size_t num_keys = capacity * 3 / 4;
+  std::vector<bool> occupied(capacity);
+  size_t total_probes = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    std::string name = "customer#" + std::to_string(i);
+    size_t slot = HashUtil::HashBytes(name.data(), name.size()) % capacity;
+    for (total_probes++; occupied[slot]; total_probes++) {
+      slot = (slot + 1) % capacity;
+    }
+    occupied[slot] = true;
+  }
+  // uniform hashing expects (1 + 1 / (1 - 0.75)) / 2 = 2.5 probes per successful lookup
+  EXPECT_LT(static_cast<double>(total_probes) / num_keys, 3.0);
+}
+
+TEST(HashUtilTest, EveryByteMatters) {
+  std::mt19937 generator(15445);
+  std::vector<char> buffer(3000);
+  for (auto &byte : buffer) {
+    byte = static_cast<char>(generator());
+  }
+  // all prefixes differ, and the hash does not depend on the alignment of the input
+  std::unordered_set<hash_t> hashes;
+  std::vector<char> shifted(buffer.size() + 1);
+  for (size_t length = 0; length <= 2000; length++) {
+    hashes.insert(HashUtil::HashBytes(buffer.data(), length));
+    memcpy(shifted.data() + 1, buffer.data(), length);
+    ASSERT_EQ(HashUtil::HashBytes(buffer.data(), length), HashUtil::HashBytes(shifted.data() + 1, length)) << length;
+  }
+  EXPECT_EQ(2001, hashes.size());
+
+  for (size_t length : {5, 20, 60, 200, 1000, 2999}) {
+    hash_t original = HashUtil::HashBytes(buffer.data(), length);
+    for (size_t i = 0; i < length; i++) {
+      buffer[i] ^= 0x40;
+      ASSERT_NE(original, HashUtil::HashBytes(buffer.data(), length)) << "length " << length << ", byte " << i;
+      buffer[i] ^= 0x40;
+    }
+  }
+}
+
+TEST(HashUtilTest, HashValue) {
+  auto hash_value = [](const Value &value) { return HashUtil::HashValue(&value); };
+  // equal values hash equally across integer types
+  hash_t five = hash_value(ValueFactory::GetIntegerValue(5));
+  EXPECT_EQ(five, hash_value(ValueFactory::GetTinyIntValue(5)));
+  EXPECT_EQ(five, hash_value(ValueFactory::GetBigIntValue(5)));
+  EXPECT_NE(five, hash_value(ValueFactory::GetIntegerValue(6)));
+  EXPECT_EQ(hash_value(ValueFactory::GetDecimalValue(0.0)), hash_value(ValueFactory::GetDecimalValue(-0.0)));
+  EXPECT_EQ(hash_value(ValueFactory::GetVarcharValue("bustub")),
+            hash_value(ValueFactory::GetVarcharValue(std::string("bustub"))));
+
+  // group by keys with a NULL in different positions
+  Value null = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  Value one = ValueFactory::GetIntegerValue(1);
+  std::hash<AggregateKey> hash_key;
+  EXPECT_NE(hash_key(AggregateKey{{null, one}}), hash_key(AggregateKey{{one, null}}));
+  EXPECT_EQ(hash_key(AggregateKey{{one, null}}), hash_key(AggregateKey{{one, null}}));
+}
+
+/*
+ * Hashes per second and bytes per second for each key length, for HashBytes, murmur3 and the
+ * shift-xor loop HashBytes used to be.
+ */
+TEST(HashUtilTest, DISABLED_BenchmarkThroughput) {
+  auto shift_xor = [](const char *bytes, size_t length) {
+    hash_t hash = length;
+    for (size_t i = 0; i < length; ++i) {
+      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+    }
+    return hash;
+  };
+  auto murmur = [](const char *bytes, size_t length) {
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(bytes, static_cast<int>(length), 0, hash);
+    return hash[0];
+  };
+  auto hash_bytes = [](const char *bytes, size_t length) { return HashUtil::HashBytes(bytes, length); };
+
+  std::vector<char> buffer(1 << 16);
+  std::mt19937 generator(15445);
+  for (auto &byte : buffer) {
+    byte = static_cast<char>(generator());
+  }
+  auto run = [&](const char *name, size_t length, auto &&hash_fn) {
+    // about 64MB per measurement
+    size_t iterations = std::max<size_t>((64 << 20) / std::max<size_t>(length, 64), 1);
+    hash_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+      // vary the input a little, so that nothing is hoisted out of the loop
+      sink ^= hash_fn(buffer.data() + (i & 7), length);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "  " << name << ": " << elapsed.count() * 1e9 / iterations << " ns/hash, "
+              << iterations * length / elapsed.count() / 1e9 << " GB/s" << (sink == 42 ? " " : "") << std::endl;
+  };
+
+  std::cout << "8-byte integers" << std::endl;
+  run("HashInt", 8, [](const char *bytes, size_t) {
+    uint64_t key;
+    memcpy(&key, bytes, sizeof(key));
+    return HashUtil::HashInt(key);
+  });
+  run("murmur3", 8, murmur);
+  run("shift-xor", 8, shift_xor);
+  for (size_t length : {4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096, 65536 - 8}) {
+    std::cout << length << "-byte strings" << std::endl;
+    run("HashBytes", length, hash_bytes);
+    run("murmur3", length, murmur);
+    run("shift-xor", length, shift_xor);
+  }
+}
+
+}  // namespace bustub
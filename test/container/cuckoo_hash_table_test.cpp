@@ -0,0 +1,277 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table_test.cpp
+//
+// Identification: test/container/cuckoo_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/hash/cuckoo_hash_table.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 100, HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // insert one more value for each key
+  for (int i = 0; i < 5; i++) {
+    if (i == 0) {
+      // duplicate values for the same key are not allowed
+      EXPECT_FALSE(ht.Insert(nullptr, i, 2 * i));
+    } else {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i));
+    }
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size());
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+  EXPECT_EQ(0, res.size());
+
+  // delete some values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    if (i == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      EXPECT_EQ(1, res.size());
+      EXPECT_EQ(2 * i, res[0]);
+    }
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, 0, 0));
+  EXPECT_EQ(4, ht.GetSize());
+
+  // a key has at most two full buckets of values
+  for (int i = 0; i < 2 * CUCKOO_BUCKET_SLOTS; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, 7, i));
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 7, 2 * CUCKOO_BUCKET_SLOTS));
+  res.clear();
+  ht.GetValue(nullptr, 7, &res);
+  EXPECT_EQ(2 * CUCKOO_BUCKET_SLOTS, res.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, GrowsOnlyWhenNearlyFull) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 2, HashFunction<int>());
+  const int num_keys = 50000;
+  size_t num_buckets = ht.GetNumBuckets();
+  double min_load_at_growth = 1;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i)) << i;
+    size_t new_num_buckets = ht.GetNumBuckets();
+    if (new_num_buckets != num_buckets) {
+      // the pairs before this insert filled the table that was too small for it
+      if (num_buckets >= 256) {
+        min_load_at_growth = std::min(min_load_at_growth, i / (num_buckets * CUCKOO_BUCKET_SLOTS * 1.0));
+      }
+      num_buckets = new_num_buckets;
+    }
+  }
+  EXPECT_GT(min_load_at_growth, 0.85);
+  EXPECT_EQ(num_keys, ht.GetSize());
+
+  std::vector<int> res;
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res)) << i;
+  }
+  EXPECT_EQ(num_keys / 2, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, KeepsAllPairsWhenGrowthFails) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(HEADER_MAX_BLOCKS + 10, disk_manager);
+
+  Schema key_schema({Column("a", TypeId::BIGINT)});
+  // as many blocks as the header page holds, so the table cannot grow
+  const size_t block_buckets = (PAGE_SIZE - 8) / (CUCKOO_BUCKET_SLOTS * (sizeof(std::pair<GenericKey<64>, RID>) + 1));
+  CuckooHashTable<GenericKey<64>, RID, GenericComparator<64>> ht("blah", bpm, GenericComparator<64>(&key_schema),
+                                                                 HEADER_MAX_BLOCKS * block_buckets,
+                                                                 HashFunction<GenericKey<64>>());
+  GenericKey<64> index_key;
+  int64_t num_keys = 0;
+  bool failed = false;
+  while (!failed) {
+    index_key.SetFromInteger(num_keys);
+    try {
+      ASSERT_TRUE(ht.Insert(nullptr, index_key, RID(0, num_keys)));
+      num_keys++;
+    } catch (Exception &e) {
+      failed = true;
+    }
+  }
+  // the insert that could not grow the table changed nothing, and no displaced pair was lost
+  EXPECT_GT(num_keys, HEADER_MAX_BLOCKS * block_buckets * CUCKOO_BUCKET_SLOTS / 2);
+  EXPECT_EQ(num_keys, ht.GetSize());
+  std::vector<RID> res;
+  for (int64_t key = 0; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    res.clear();
+    ASSERT_EQ(key < num_keys, ht.GetValue(nullptr, index_key, &res)) << key;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, ConcurrentInsertLookupRemove) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  // small, so that inserts displace pairs and the table grows while others read
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 16, HashFunction<int>());
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<int> res;
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        res.clear();
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+      }
+      for (int i = t; i < num_threads * keys_per_thread; i += 2 * num_threads) {
+        EXPECT_TRUE(ht.Remove(nullptr, i, i));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int> res;
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    res.clear();
+    EXPECT_EQ(i % (2 * num_threads) >= num_threads, ht.GetValue(nullptr, i, &res)) << i;
+  }
+  EXPECT_EQ(num_threads * keys_per_thread / 2, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Lookups against cuckoo and linear probing tables filled to increasing load
+ * factors. Lookups are Zipf-distributed (s = 0.99) over the stored keys, half
+ * of them for keys that are not in the table.
+ */
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, DISABLED_BenchmarkHighLoadLookup) {
+  const size_t num_keys = 200000;
+  const size_t num_lookups = 1 << 19;
+  std::vector<double> cdf(num_keys);
+  double sum = 0;
+  for (size_t rank = 0; rank < num_keys; rank++) {
+    sum += 1 / std::pow(rank + 1, 0.99);
+    cdf[rank] = sum;
+  }
+  std::mt19937 generator(15445);
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<int> lookups(num_lookups);
+  for (size_t i = 0; i < num_lookups; i++) {
+    int key = static_cast<int>(std::upper_bound(cdf.begin(), cdf.end(), uniform(generator)) - cdf.begin());
+    // odd keys are missing
+    lookups[i] = 2 * key + static_cast<int>(i % 2);
+  }
+
+  auto run = [&](const char *name, double load_factor, auto *ht) {
+    for (size_t key = 0; key < num_keys; key++) {
+      ht->Insert(nullptr, 2 * key, key);
+    }
+    std::vector<int> res;
+    auto start = std::chrono::steady_clock::now();
+    for (int key : lookups) {
+      res.clear();
+      ht->GetValue(nullptr, key, &res);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "  " << name << " at load factor " << load_factor << ": " << num_lookups / elapsed.count() / 1e6
+              << " Mlookups/s" << std::endl;
+  };
+
+  for (double load_factor : {0.5, 0.75, 0.9, 0.95}) {
+    {
+      DiskManager disk_manager("test.db");
+      BufferPoolManager bpm(2000, &disk_manager);
+      LinearProbeHashTable<int, int, IntComparator> ht("blah", &bpm, IntComparator(), num_keys / load_factor,
+                                                       HashFunction<int>());
+      run("linear probing", load_factor, &ht);
+    }
+    {
+      DiskManager disk_manager("test.db");
+      BufferPoolManager bpm(2000, &disk_manager);
+      CuckooHashTable<int, int, IntComparator> ht("blah", &bpm, IntComparator(),
+                                                  num_keys / load_factor / CUCKOO_BUCKET_SLOTS, HashFunction<int>());
+      run("cuckoo", load_factor, &ht);
+      std::cout << "    (cuckoo table load factor " << num_keys / (ht.GetNumBuckets() * CUCKOO_BUCKET_SLOTS * 1.0)
+                << ")" << std::endl;
+    }
+  }
+  remove("test.db");
+}
+
+}  // namespace bustub
@@ -10,6 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -21,7 +27,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
 
@@ -104,4 +110,445 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, ProbeAcrossBlocksAndResize) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  // starts smaller than a single probe group and grows to several blocks
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 7, HashFunction<int>());
+  const int num_keys = 1000;
+  for (int i = 0; i < num_keys; i++) {
+    for (int j = 0; j < 3; j++) {
+      ASSERT_TRUE(ht.Insert(nullptr, i, j)) << i;
+    }
+  }
+  EXPECT_GE(ht.GetSize(), 3 * num_keys);
+  EXPECT_FALSE(ht.Insert(nullptr, 5, 1));
+
+  std::vector<int> res;
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    EXPECT_EQ(3, res.size()) << i;
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, num_keys, &res));
+
+  // probes must skip over tombstones, and inserts reuse them
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, 1));
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, 0, 1));
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    EXPECT_EQ(2, res.size()) << i;
+    EXPECT_TRUE(std::find(res.begin(), res.end(), 1) == res.end()) << i;
+  }
+  size_t size = ht.GetSize();
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, 1));
+  }
+  EXPECT_EQ(size, ht.GetSize());
+
+  // an explicit resize keeps every pair
+  ht.Resize(size);
+  EXPECT_EQ(2 * size, ht.GetSize());
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+    EXPECT_EQ(3, res.size()) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentInsertLookupRemove) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+
+  // small enough to resize several times while the threads run
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 100, HashFunction<int>());
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  // key i keeps the pair (i, -1) throughout
+  for (int i = 0; i < num_threads * keys_per_thread; i += 7) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, -1));
+  }
+  std::atomic<bool> writers_done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int round = 0; round < 2; round++) {
+        // removed pairs leave tombstones that the next round reuses
+        for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+          EXPECT_TRUE(ht.Insert(nullptr, i, i));
+          EXPECT_FALSE(ht.Insert(nullptr, i, i));
+        }
+        for (int i = t; i < num_threads * keys_per_thread; i += (round == 0 ? num_threads : 2 * num_threads)) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  threads.emplace_back([&] {
+    std::vector<int> res;
+    while (!writers_done) {
+      for (int i = 0; i < num_threads * keys_per_thread; i += 7) {
+        res.clear();
+        ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+        EXPECT_TRUE(std::find(res.begin(), res.end(), -1) != res.end()) << i;
+      }
+    }
+  });
+  for (int t = 0; t < num_threads; t++) {
+    threads[t].join();
+  }
+  writers_done = true;
+  threads.back().join();
+
+  std::vector<int> res;
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    size_t expected = (i % 7 == 0 ? 1 : 0) + (i % (2 * num_threads) >= num_threads ? 1 : 0);
+    EXPECT_EQ(expected, res.size()) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, LinearHashingGrowth) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  for (double max_load_factor : {0.75, 4.0}) {
+    // a load factor above one keeps overflow blocks around
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>(),
+                                                     HashTableGrowth::LinearHashing, max_load_factor);
+    size_t block_size = ht.GetSize();
+    const int num_keys = 10000;
+    for (int i = 0; i < num_keys; i++) {
+      size_t size = ht.GetSize();
+      ASSERT_TRUE(ht.Insert(nullptr, i, i)) << i;
+      ASSERT_TRUE(ht.Insert(nullptr, i, num_keys + i)) << i;
+      // a bucket at a time
+      EXPECT_LE(ht.GetSize(), size + 2 * block_size);
+    }
+    EXPECT_FALSE(ht.Insert(nullptr, 5, 5));
+    EXPECT_GE(ht.GetSize(), 2 * num_keys / max_load_factor);
+    EXPECT_LT(ht.GetSize(), 2 * num_keys / max_load_factor + 2 * block_size);
+
+    std::vector<int> res;
+    for (int i = 0; i < num_keys; i++) {
+      res.clear();
+      ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+      EXPECT_EQ(2, res.size()) << i;
+    }
+    for (int i = 0; i < num_keys; i++) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, i)) << i;
+    }
+    for (int i = 0; i < num_keys; i++) {
+      res.clear();
+      ASSERT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+      ASSERT_EQ(1, res.size()) << i;
+      EXPECT_EQ(num_keys + i, res[0]);
+    }
+    res.clear();
+    EXPECT_FALSE(ht.GetValue(nullptr, num_keys, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, LinearHashingConcurrent) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(100, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>(),
+                                                   HashTableGrowth::LinearHashing);
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<int> res;
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        res.clear();
+        EXPECT_TRUE(ht.GetValue(nullptr, i, &res)) << i;
+      }
+      for (int i = t; i < num_threads * keys_per_thread; i += 2 * num_threads) {
+        EXPECT_TRUE(ht.Remove(nullptr, i, i));
+      }
+    });
+  }
+  // readers never miss a key that is in the table while buckets split
+  threads.emplace_back([&] {
+    std::vector<int> res;
+    for (int i = 0; i < 20000; i++) {
+      res.clear();
+      if (ht.GetValue(nullptr, i % (num_threads * keys_per_thread), &res)) {
+        EXPECT_EQ(i % (num_threads * keys_per_thread), res[0]);
+      }
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int> res;
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    res.clear();
+    EXPECT_EQ(i % (2 * num_threads) >= num_threads, ht.GetValue(nullptr, i, &res)) << i;
+  }
+  EXPECT_GT(ht.GetSize(), num_threads * keys_per_thread / 2);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MultiKeyLookup) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  for (auto growth : {HashTableGrowth::Resize, HashTableGrowth::LinearHashing}) {
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>(), growth);
+    std::vector<int> keys;
+    std::vector<std::vector<int>> results;
+    ht.GetValues(nullptr, keys, &results);
+    EXPECT_TRUE(results.empty());
+
+    // even keys only, some with two values
+    for (int i = 0; i < 5000; i += 2) {
+      ht.Insert(nullptr, i, i);
+      if (i % 10 == 0) {
+        ht.Insert(nullptr, i, -i - 1);
+      }
+    }
+    for (int i = 5003; i >= 0; i -= 3) {
+      keys.push_back(i);
+    }
+    ht.GetValues(nullptr, keys, &results);
+    ASSERT_EQ(keys.size(), results.size());
+    std::vector<int> expected;
+    for (size_t i = 0; i < keys.size(); i++) {
+      expected.clear();
+      ht.GetValue(nullptr, keys[i], &expected);
+      std::sort(expected.begin(), expected.end());
+      std::sort(results[i].begin(), results[i].end());
+      EXPECT_EQ(expected, results[i]) << keys[i];
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Lookups of random keys one at a time and in batches of increasing size.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BenchmarkMultiKeyLookup) {
+  auto *disk_manager = new DiskManager("test.db");
+  // a block holds 441 int pairs
+  const size_t num_buckets = 1000 * 441;
+  const size_t num_lookups = 1 << 20;
+  auto *bpm = new BufferPoolManager(1100, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), num_buckets, HashFunction<int>());
+  const int size = num_buckets / 2;
+  for (int i = 0; i < size; i++) {
+    ht.Insert(nullptr, i, i);
+  }
+  std::mt19937 generator(15445);
+  std::vector<int> keys(num_lookups);
+  for (auto &key : keys) {
+    key = static_cast<int>(generator() % size);
+  }
+
+  std::vector<int> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    result.clear();
+    ht.GetValue(nullptr, key, &result);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "GetValue: " << num_lookups / elapsed.count() / 1e6 << " Mlookups/s" << std::endl;
+
+  std::vector<int> batch;
+  std::vector<std::vector<int>> results;
+  for (size_t batch_size = 1; batch_size <= 1024; batch_size *= 4) {
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_lookups; i += batch_size) {
+      batch.assign(keys.begin() + i, keys.begin() + i + batch_size);
+      results.clear();
+      ht.GetValues(nullptr, batch, &results);
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "GetValues, batches of " << batch_size << ": " << num_lookups / elapsed.count() / 1e6
+              << " Mlookups/s" << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Per-insert latency while the table grows, with full-table resizes and with
+ * linear hashing. Resizing rebuilds the table every time it doubles, linear
+ * hashing splits a single bucket at a time.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BenchmarkGrowthTailLatency) {
+  // a resize past 256K slots would exceed the header page
+  const int num_keys = 200000;
+  for (auto growth : {HashTableGrowth::Resize, HashTableGrowth::LinearHashing}) {
+    auto *disk_manager = new DiskManager("test.db");
+    // large enough to hold the table twice during a resize
+    auto *bpm = new BufferPoolManager(2000, disk_manager);
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>(), growth);
+    std::mt19937 generator(15445);
+    std::vector<double> latencies;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_keys; i++) {
+      int key = static_cast<int>(generator());
+      auto insert_start = std::chrono::steady_clock::now();
+      ht.Insert(nullptr, key, i);
+      std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - insert_start;
+      latencies.push_back(elapsed.count());
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::cout << (growth == HashTableGrowth::Resize ? "resize" : "linear hashing") << ": "
+              << num_keys / elapsed.count() / 1e3 << " Kinserts/s, p50 " << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us, p99.9 " << percentile(0.999) << " us, max " << latencies.back()
+              << " us, size " << ht.GetSize() << std::endl;
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+/*
+ * Throughput of a mix of 80% lookups, 10% inserts and 10% removes with
+ * increasing numbers of threads, on a table that never resizes. Every
+ * thread works on its own keys, so threads only contend on blocks.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BenchmarkConcurrentScaling) {
+  // a block holds 441 int pairs
+  const size_t num_buckets = 500 * 441;
+  const int ops_per_thread = 500000;
+  const int keys_per_thread = 10000;
+  double base_throughput = 0;
+  for (int num_threads : {1, 2, 4, 8}) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(600, disk_manager);
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), num_buckets, HashFunction<int>());
+    for (int i = 0; i < num_threads * keys_per_thread; i++) {
+      ht.Insert(nullptr, i, i);
+    }
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        std::mt19937 generator(t);
+        std::vector<int> res;
+        for (int i = 0; i < ops_per_thread; i++) {
+          int key = t * keys_per_thread + static_cast<int>(generator() % keys_per_thread);
+          uint32_t op = generator() % 10;
+          if (op == 0) {
+            ht.Remove(nullptr, key, key);
+          } else if (op == 1) {
+            ht.Insert(nullptr, key, key);
+          } else {
+            res.clear();
+            ht.GetValue(nullptr, key, &res);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double throughput = num_threads * ops_per_thread / elapsed.count() / 1e6;
+    if (num_threads == 1) {
+      base_throughput = throughput;
+    }
+    std::cout << num_threads << " threads: " << throughput << " Mops/s, speedup " << throughput / base_throughput
+              << " on " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
+/*
+ * Lookup latency at increasing load factors, for keys in the table and for
+ * keys that are not. Misses are where fingerprints pay off: a probe reads
+ * the key of a slot only when its fingerprint matches, about once in 128.
+ */
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_BenchmarkProbe) {
+  auto *disk_manager = new DiskManager("test.db");
+  // a block holds 441 int pairs
+  const size_t num_buckets = 1000 * 441;
+  // large enough to hold the whole table
+  auto *bpm = new BufferPoolManager(1100, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), num_buckets, HashFunction<int>());
+  const int num_lookups = 1000000;
+  std::mt19937 generator(15445);
+  std::vector<int> res;
+  int size = 0;
+  for (double load_factor : {0.5, 0.75, 0.9}) {
+    // even keys are in the table, odd keys are not
+    for (; size < load_factor * num_buckets; size++) {
+      ht.Insert(nullptr, 2 * size, size);
+    }
+    for (bool hit : {true, false}) {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < num_lookups; i++) {
+        res.clear();
+        ht.GetValue(nullptr, 2 * static_cast<int>(generator() % size) + (hit ? 0 : 1), &res);
+      }
+      std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << "load factor " << load_factor << ", " << (hit ? "hits" : "misses") << ": "
+                << elapsed.count() / num_lookups << " ns per lookup" << std::endl;
+    }
+  }
+  EXPECT_EQ(num_buckets, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
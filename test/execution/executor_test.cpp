@@ -10,9 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
+#include <functional>
+#include <chrono>  // NOLINT
+#include <iostream>
 #include <memory>
+#include <optional>
+#include <random>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -26,13 +33,22 @@
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/top_n_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/top_n_plan.h"
 #include "gtest/gtest.h"
 #include "storage/b_plus_tree_test_util.h"  // NOLINT
 #include "storage/table/tuple.h"
@@ -47,7 +63,7 @@ class ExecutorTest : public ::testing::Test {
     ::testing::Test::SetUp();
     // For each test, we create a new DiskManager, BufferPoolManager, TransactionManager, and Catalog.
     disk_manager_ = std::make_unique<DiskManager>("executor_test.db");
-    bpm_ = std::make_unique<BufferPoolManager>(32, disk_manager_.get());
+    bpm_ = std::make_unique<BufferPoolManager>(pool_size_, disk_manager_.get());
     page_id_t page_id;
     bpm_->NewPage(&page_id);
     lock_manager_ = std::make_unique<LockManager>();
@@ -104,12 +120,28 @@ class ExecutorTest : public ::testing::Test {
     return allocated_exprs_.back().get();
   }
 
-  const AbstractExpression *MakeAggregateValueExpression(bool is_group_by_term, uint32_t term_idx) {
-    allocated_exprs_.emplace_back(
-        std::make_unique<AggregateValueExpression>(is_group_by_term, term_idx, TypeId::INTEGER));
+  const AbstractExpression *MakeAggregateValueExpression(bool is_group_by_term, uint32_t term_idx,
+                                                         TypeId type = TypeId::INTEGER) {
+    allocated_exprs_.emplace_back(std::make_unique<AggregateValueExpression>(is_group_by_term, term_idx, type));
     return allocated_exprs_.back().get();
   }
 
+  /** Creates a table with the columns of test_1 and the given number of rows. */
+  TableMetadata *MakeTest1LikeTable(const std::string &name, uint32_t num_rows) {
+    Schema &test_1_schema = GetCatalog()->GetTable("test_1")->schema_;
+    TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), name, test_1_schema);
+    std::mt19937 generator(15445);
+    for (uint32_t i = 0; i < num_rows; i++) {
+      std::vector<Value> values{ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                                ValueFactory::GetIntegerValue(static_cast<int32_t>(generator() % 10)),
+                                ValueFactory::GetIntegerValue(static_cast<int32_t>(generator() % 10000)),
+                                ValueFactory::GetIntegerValue(static_cast<int32_t>(generator() % 100000))};
+      RID rid;
+      EXPECT_TRUE(table_info->table_->InsertTuple(Tuple(values, &table_info->schema_), &rid, GetTxn()));
+    }
+    return table_info;
+  }
+
   const Schema *MakeOutputSchema(const std::vector<std::pair<std::string, const AbstractExpression *>> &exprs) {
     std::vector<Column> cols;
     cols.reserve(exprs.size());
@@ -124,6 +156,10 @@ class ExecutorTest : public ::testing::Test {
     return allocated_output_schemas_.back().get();
   }
 
+ protected:
+  /** The number of frames of the buffer pool. */
+  size_t pool_size_{32};
+
  private:
   std::unique_ptr<TransactionManager> txn_mgr_;
   Transaction *txn_{nullptr};
@@ -140,7 +176,7 @@ class ExecutorTest : public ::testing::Test {
 };
 
 // NOLINTNEXTLINE
-TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
+TEST_F(ExecutorTest, SimpleSeqScanTest) {
   // SELECT colA, colB FROM test_1 WHERE colA < 500
 
   // Construct query plan
@@ -386,7 +422,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleDeleteTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
+TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
   std::unique_ptr<AbstractPlanNode> scan_plan1;
   const Schema *out_schema1;
@@ -436,7 +472,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
+TEST_F(ExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
   std::unique_ptr<AbstractPlanNode> scan_plan;
   const Schema *scan_schema;
@@ -487,7 +523,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
+TEST_F(ExecutorTest, SimpleGroupByAggregation) {
   // SELECT count(colA), colB, sum(colC) FROM test_1 Group By colB HAVING count(colA) > 100
   std::unique_ptr<AbstractPlanNode> scan_plan;
   const Schema *scan_schema;
@@ -546,4 +582,1247 @@ TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, CoveringIndexScanTest) {
+  // SELECT colA, colB FROM test_1 WHERE colB = 5, through an index on colA that includes colB
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  Schema *key_schema = ParseCreateStatement("a integer");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "covering_index", "test_1", schema, *key_schema, {0}, 8, {1});
+  auto *plain_index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "plain_index", "test_1", schema, *key_schema, {0}, 8);
+  EXPECT_EQ(GetExecutorContext()->GetCatalog()->GetTableIndexes("test_1").size(), 2);
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto *const5 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5));
+  auto *predicate = MakeComparisonExpression(colB, const5, ComparisonType::Equal);
+  auto *covered_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  auto *uncovered_schema = MakeOutputSchema({{"colA", colA}, {"colC", colC}});
+
+  // expected rows, straight from the table heap
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  for (auto it = table_info->table_->Begin(GetTxn()); it != table_info->table_->End(); ++it) {
+    if (it->GetValue(&schema, 1).GetAs<int32_t>() == 5) {
+      expected.emplace_back(it->GetValue(&schema, 0).GetAs<int32_t>(), it->GetValue(&schema, 2).GetAs<int32_t>());
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  ASSERT_FALSE(expected.empty());
+
+  auto run = [&](const IndexInfo *info, const Schema *out_schema, bool expect_index_only) {
+    IndexScanPlanNode plan{out_schema, predicate, info->index_oid_};
+    IndexScanExecutor executor(GetExecutorContext(), &plan);
+    executor.Init();
+    EXPECT_EQ(executor.IsIndexOnly(), expect_index_only);
+    std::vector<Tuple> result_set;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      result_set.push_back(tuple);
+    }
+    return result_set;
+  };
+
+  // the covering index answers the query on its own, in key order
+  auto result_set = run(index_info, covered_schema, true);
+  ASSERT_EQ(result_set.size(), expected.size());
+  for (size_t i = 0; i < result_set.size(); i++) {
+    EXPECT_EQ(result_set[i].GetValue(covered_schema, 0).GetAs<int32_t>(), expected[i].first);
+    EXPECT_EQ(result_set[i].GetValue(covered_schema, 1).GetAs<int32_t>(), 5);
+  }
+
+  // a column outside the index sends the scan to the table heap
+  result_set = run(index_info, uncovered_schema, false);
+  ASSERT_EQ(result_set.size(), expected.size());
+  for (size_t i = 0; i < result_set.size(); i++) {
+    EXPECT_EQ(result_set[i].GetValue(uncovered_schema, 0).GetAs<int32_t>(), expected[i].first);
+    EXPECT_EQ(result_set[i].GetValue(uncovered_schema, 1).GetAs<int32_t>(), expected[i].second);
+  }
+
+  // so does a predicate on a column the index does not include
+  result_set = run(plain_index_info, covered_schema, false);
+  EXPECT_EQ(result_set.size(), expected.size());
+
+  // included columns must fit into the key along with the key columns
+  EXPECT_THROW((GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                   GetTxn(), "too_wide", "test_1", schema, *key_schema, {0}, 8, {1, 2})),
+               Exception);
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, CoveringIndexWithDuplicateKeys) {
+  // every key has three rows, whose colB differ
+  Schema table_schema({Column("colA", TypeId::INTEGER), Column("colB", TypeId::INTEGER)});
+  TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), "test_dup", table_schema);
+  for (int32_t i = 0; i < 30; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i / 3), ValueFactory::GetIntegerValue(i)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &table_info->schema_), &rid, GetTxn()));
+  }
+  Schema &schema = table_info->schema_;
+  Schema *key_schema = ParseCreateStatement("a integer");
+
+  // the duplicates of a key would share the included colB of one of them
+  EXPECT_THROW((GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                   GetTxn(), "dup_covering_index", "test_dup", schema, *key_schema, {0}, 8, {1}, false)),
+               Exception);
+
+  // SELECT colA, colB FROM test_dup WHERE colA = 4, through an index on colA, which reads colB from the table heap
+  auto *index_info = GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "dup_index", "test_dup", schema, *key_schema, {0}, 8, {}, false);
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *predicate = MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(4)),
+                                             ComparisonType::Equal);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+  IndexScanExecutor executor(GetExecutorContext(), &plan);
+  executor.Init();
+  EXPECT_FALSE(executor.IsIndexOnly());
+  std::vector<int32_t> values;
+  Tuple tuple;
+  RID rid;
+  while (executor.Next(&tuple, &rid)) {
+    EXPECT_EQ(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), 4);
+    values.push_back(tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values, (std::vector<int32_t>{12, 13, 14}));
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, IndexScanSeeksToPredicateRange) {
+  // SELECT colA FROM test_1 WHERE <predicate>, through an index on colA, whose values are 0 to TEST1_SIZE - 1
+  Schema &schema = GetCatalog()->GetTable("test_1")->schema_;
+  Schema *key_schema = ParseCreateStatement("a integer");
+  auto *index_info = GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "seek_index", "test_1", schema, *key_schema, {0}, 8);
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  auto run = [&](const AbstractExpression *left, const AbstractExpression *right, ComparisonType type,
+                 size_t expected_rows, size_t expected_entries) {
+    IndexScanPlanNode plan{out_schema, MakeComparisonExpression(left, right, type), index_info->index_oid_};
+    IndexScanExecutor executor(GetExecutorContext(), &plan);
+    executor.Init();
+    size_t num_rows = 0;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      num_rows++;
+    }
+    EXPECT_EQ(num_rows, expected_rows);
+    EXPECT_EQ(executor.GetNumEntriesRead(), expected_entries);
+  };
+  auto constant = [&](int32_t value) { return MakeConstantValueExpression(ValueFactory::GetIntegerValue(value)); };
+
+  run(colA, constant(500), ComparisonType::Equal, 1, 1);
+  // the entry equal to the bound of a strict comparison is read, and filtered out
+  run(colA, constant(900), ComparisonType::GreaterThan, TEST1_SIZE - 901, TEST1_SIZE - 900);
+  run(colA, constant(900), ComparisonType::GreaterThanOrEqual, TEST1_SIZE - 900, TEST1_SIZE - 900);
+  run(colA, constant(100), ComparisonType::LessThan, 100, 100);
+  run(colA, constant(100), ComparisonType::LessThanOrEqual, 101, 101);
+  // a constant on the left is a bound all the same
+  run(constant(5), colA, ComparisonType::GreaterThan, 5, 5);
+  // predicates that do not bound the key read the whole index
+  run(colA, constant(3), ComparisonType::NotEqual, TEST1_SIZE - 1, TEST1_SIZE);
+  run(colB, constant(10), ComparisonType::Equal, 0, TEST1_SIZE);
+  delete key_schema;
+
+  // with a second key column, all entries of a bound value of the first column are in range, whatever their colB
+  key_schema = ParseCreateStatement("a integer,b integer");
+  index_info = GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "seek_index_2", "test_1", schema, *key_schema, {0, 1}, 8);
+  run(colA, constant(500), ComparisonType::Equal, 1, 1);
+  run(colA, constant(100), ComparisonType::LessThan, 100, 100);
+  run(colA, constant(100), ComparisonType::LessThanOrEqual, 101, 101);
+  run(colA, constant(900), ComparisonType::GreaterThanOrEqual, TEST1_SIZE - 900, TEST1_SIZE - 900);
+  delete key_schema;
+}
+
+TEST_F(ExecutorTest, VectorizedMatchesVolcano) {
+  // a few batches worth of rows, so that batches end in the middle of table pages
+  TableMetadata *table_info = MakeTest1LikeTable("test_big", 5 * EXECUTION_BATCH_SIZE + 7);
+  Schema &schema = table_info->schema_;
+
+  // SELECT colA, colB, colC FROM test_big WHERE colB < 3
+  const Schema *scan_schema;
+  std::unique_ptr<AbstractPlanNode> scan_plan;
+  {
+    auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+    auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+    auto *predicate = MakeComparisonExpression(colB, MakeConstantValueExpression(ValueFactory::GetIntegerValue(3)),
+                                               ComparisonType::LessThan);
+    scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+    scan_plan = std::make_unique<SeqScanPlanNode>(scan_schema, predicate, table_info->oid_);
+  }
+
+  // SELECT colA FROM test_big WHERE colA < 0
+  std::unique_ptr<AbstractPlanNode> empty_scan_plan;
+  {
+    auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto *predicate = MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(0)),
+                                               ComparisonType::LessThan);
+    empty_scan_plan =
+        std::make_unique<SeqScanPlanNode>(MakeOutputSchema({{"colA", colA}}), predicate, table_info->oid_);
+  }
+
+  // SELECT colB, COUNT(colA), SUM(colC), MIN(colC), MAX(colC) FROM scan GROUP BY colB HAVING COUNT(colA) > 10
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  {
+    auto *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    auto *colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+    auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+    auto *countA = MakeAggregateValueExpression(false, 0);
+    auto *having = MakeComparisonExpression(countA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(10)),
+                                            ComparisonType::GreaterThan);
+    auto *agg_schema = MakeOutputSchema({{"colB", MakeAggregateValueExpression(true, 0)},
+                                         {"countA", countA},
+                                         {"sumC", MakeAggregateValueExpression(false, 1)},
+                                         {"minC", MakeAggregateValueExpression(false, 2)},
+                                         {"maxC", MakeAggregateValueExpression(false, 3)}});
+    agg_plan = std::make_unique<AggregationPlanNode>(
+        agg_schema, scan_plan.get(), having, std::vector<const AbstractExpression *>{colB},
+        std::vector<const AbstractExpression *>{colA, colC, colC, colC},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate});
+  }
+
+  // SELECT scan.colA, scan.colC, test_2.col3 FROM scan JOIN test_2 ON scan.colB = test_2.col2
+  std::unique_ptr<AbstractPlanNode> right_plan;
+  std::unique_ptr<AbstractPlanNode> join_plan;
+  {
+    auto *test_2_info = GetCatalog()->GetTable("test_2");
+    auto *col2 = MakeColumnValueExpression(test_2_info->schema_, 0, "col2");
+    auto *col3 = MakeColumnValueExpression(test_2_info->schema_, 0, "col3");
+    auto *right_schema = MakeOutputSchema({{"col2", col2}, {"col3", col3}});
+    right_plan = std::make_unique<SeqScanPlanNode>(right_schema, nullptr, test_2_info->oid_);
+    auto *colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    auto *colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+    auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+    auto *join_col2 = MakeColumnValueExpression(*right_schema, 1, "col2");
+    auto *join_col3 = MakeColumnValueExpression(*right_schema, 1, "col3");
+    auto *predicate = MakeComparisonExpression(colB, join_col2, ComparisonType::Equal);
+    join_plan = std::make_unique<NestedLoopJoinPlanNode>(
+        MakeOutputSchema({{"colA", colA}, {"colC", colC}, {"col3", join_col3}}),
+        std::vector<const AbstractPlanNode *>{scan_plan.get(), right_plan.get()}, predicate);
+  }
+
+  // SELECT colA, colB FROM test_1 WHERE colA < 500, through an index scan that only produces tuples one at a time
+  Schema *key_schema = ParseCreateStatement("a integer");
+  auto *index_info = GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index_1", "test_1", GetCatalog()->GetTable("test_1")->schema_, *key_schema, {0}, 8);
+  std::unique_ptr<AbstractPlanNode> index_scan_plan;
+  {
+    Schema &test_1_schema = GetCatalog()->GetTable("test_1")->schema_;
+    auto *colA = MakeColumnValueExpression(test_1_schema, 0, "colA");
+    auto *colB = MakeColumnValueExpression(test_1_schema, 0, "colB");
+    auto *predicate = MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(500)),
+                                               ComparisonType::LessThan);
+    index_scan_plan = std::make_unique<IndexScanPlanNode>(MakeOutputSchema({{"colA", colA}, {"colB", colB}}),
+                                                          predicate, index_info->index_oid_);
+  }
+
+  auto run = [&](const AbstractPlanNode *plan, bool vectorized) {
+    std::vector<Tuple> result_set;
+    if (vectorized) {
+      GetExecutionEngine()->ExecuteVectorized(plan, &result_set, GetTxn(), GetExecutorContext());
+    } else {
+      GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    }
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    return rows;
+  };
+  // scans produce the same rows in the same order
+  for (const AbstractPlanNode *plan : {scan_plan.get(), empty_scan_plan.get(), index_scan_plan.get()}) {
+    EXPECT_EQ(run(plan, false), run(plan, true));
+  }
+  EXPECT_GT(run(scan_plan.get(), true).size(), EXECUTION_BATCH_SIZE);
+  EXPECT_TRUE(run(empty_scan_plan.get(), true).empty());
+  EXPECT_EQ(run(index_scan_plan.get(), true).size(), 500);
+  // aggregations and joins produce the same rows in some order
+  for (const AbstractPlanNode *plan : {agg_plan.get(), join_plan.get()}) {
+    auto volcano_rows = run(plan, false);
+    auto vectorized_rows = run(plan, true);
+    std::sort(volcano_rows.begin(), volcano_rows.end());
+    std::sort(vectorized_rows.begin(), vectorized_rows.end());
+    EXPECT_FALSE(volcano_rows.empty());
+    EXPECT_EQ(volcano_rows, vectorized_rows);
+  }
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, VectorizedReportsExecutorExceptions) {
+  // SELECT SUM(col) FROM test_overflow, whose sum does not fit into an integer
+  Schema table_schema({Column("col", TypeId::INTEGER)});
+  TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), "test_overflow", table_schema);
+  for (int i = 0; i < 2; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &table_info->schema_), &rid, GetTxn()));
+  }
+  auto *col = MakeColumnValueExpression(table_info->schema_, 0, "col");
+  auto *scan_schema = MakeOutputSchema({{"col", col}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  AggregationPlanNode agg_plan{MakeOutputSchema({{"sum", MakeAggregateValueExpression(false, 0)}}),
+                               &scan_plan,
+                               nullptr,
+                               {},
+                               {MakeColumnValueExpression(*scan_schema, 0, "col")},
+                               {AggregationType::SumAggregate}};
+  std::vector<Tuple> result_set;
+  EXPECT_FALSE(GetExecutionEngine()->ExecuteVectorized(&agg_plan, &result_set, GetTxn(), GetExecutorContext()));
+  EXPECT_TRUE(result_set.empty());
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, HashJoinMatchesNestedLoopJoin) {
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    auto col3 = MakeColumnValueExpression(schema, 0, "col3");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}, {"col3", col3}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+  auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+  auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+  auto col3 = MakeColumnValueExpression(*out_schema2, 1, "col3");
+  auto *out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col3", col3}});
+
+  auto run = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  // test_1.colA = test_2.col1, with the keys on either side of the predicate
+  for (auto *predicate : {MakeComparisonExpression(colA, col1, ComparisonType::Equal),
+                          MakeComparisonExpression(col1, colA, ComparisonType::Equal)}) {
+    NestedLoopJoinPlanNode nested_loop_plan{
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate};
+    auto hash_join_plan = HashJoinPlanNode::FromNestedLoopJoin(&nested_loop_plan);
+    ASSERT_NE(hash_join_plan, nullptr);
+    auto expected = run(&nested_loop_plan);
+    EXPECT_EQ(expected.size(), TEST2_SIZE);
+    EXPECT_EQ(run(hash_join_plan.get()), expected);
+  }
+
+  // only equalities between columns of the two sides become hash joins
+  for (auto *predicate : {MakeComparisonExpression(colA, col1, ComparisonType::LessThan),
+                          MakeComparisonExpression(colA, colB, ComparisonType::Equal),
+                          MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(5)),
+                                                   ComparisonType::Equal)}) {
+    NestedLoopJoinPlanNode nested_loop_plan{
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate};
+    EXPECT_EQ(HashJoinPlanNode::FromNestedLoopJoin(&nested_loop_plan), nullptr);
+  }
+
+  // test_1.colB = test_2.col2 AND test_1.colA > test_2.col3, where every key has many matches
+  NestedLoopJoinPlanNode equi_join_plan{out_final,
+                                        std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()},
+                                        MakeComparisonExpression(colB, col2, ComparisonType::Equal)};
+  std::vector<Tuple> equi_join_result;
+  GetExecutionEngine()->Execute(&equi_join_plan, &equi_join_result, GetTxn(), GetExecutorContext());
+  std::vector<std::string> expected;
+  for (const auto &tuple : equi_join_result) {
+    if (tuple.GetValue(out_final, 0).CompareGreaterThan(tuple.GetValue(out_final, 3)) == CmpBool::CmpTrue) {
+      expected.push_back(tuple.ToString(out_final));
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  ASSERT_GT(expected.size(), TEST1_SIZE);
+  HashJoinPlanNode hash_join_plan{out_final,
+                                  {scan_plan1.get(), scan_plan2.get()},
+                                  {MakeColumnValueExpression(*out_schema1, 0, "colB")},
+                                  {MakeColumnValueExpression(*out_schema2, 0, "col2")},
+                                  MakeComparisonExpression(colA, col3, ComparisonType::GreaterThan)};
+  EXPECT_EQ(run(&hash_join_plan), expected);
+
+  // the hash table is built on the smaller child, whichever side it is on
+  HashJoinPlanNode swapped_plan{MakeOutputSchema({{"col1", MakeColumnValueExpression(*out_schema2, 0, "col1")},
+                                                  {"colA", MakeColumnValueExpression(*out_schema1, 1, "colA")}}),
+                                {scan_plan2.get(), scan_plan1.get()},
+                                {MakeColumnValueExpression(*out_schema2, 0, "col1")},
+                                {MakeColumnValueExpression(*out_schema1, 0, "colA")}};
+  for (const HashJoinPlanNode *plan : {&hash_join_plan, &swapped_plan}) {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    size_t count = 0;
+    while (executor->Next(&tuple, &rid)) {
+      count++;
+    }
+    EXPECT_EQ(dynamic_cast<HashJoinExecutor *>(executor.get())->IsBuildLeft(), plan == &swapped_plan);
+    EXPECT_EQ(count, plan == &swapped_plan ? TEST2_SIZE : expected.size());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, HashJoinSpillsToTmpTuplePages) {
+  TableMetadata *table_info = MakeTest1LikeTable("test_spill", 2 * TEST1_SIZE);
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  const Schema *scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+  // SELECT colA, colB, colC FROM test_spill
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  // SELECT colA, colB, colC FROM test_spill WHERE colA < 100
+  SeqScanPlanNode small_scan_plan{
+      scan_schema,
+      MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(100)),
+                               ComparisonType::LessThan),
+      table_info->oid_};
+  auto *out_schema = MakeOutputSchema({{"left_colA", MakeColumnValueExpression(*scan_schema, 0, "colA")},
+                                       {"left_colC", MakeColumnValueExpression(*scan_schema, 0, "colC")},
+                                       {"right_colA", MakeColumnValueExpression(*scan_schema, 1, "colA")},
+                                       {"right_colC", MakeColumnValueExpression(*scan_schema, 1, "colC")}});
+
+  auto run = [&](const HashJoinPlanNode *plan, size_t memory_budget, SpillStats *stats) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+    executor->Init();
+    std::vector<std::string> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      rows.push_back(tuple.ToString(out_schema));
+    }
+    *stats = dynamic_cast<HashJoinExecutor *>(executor.get())->GetSpillStats();
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  // a self join on the unique colA, whose partitions are partitioned once more to fit in 4 KB
+  HashJoinPlanNode unique_plan{out_schema,
+                               {&scan_plan, &scan_plan},
+                               {MakeColumnValueExpression(*scan_schema, 0, "colA")},
+                               {MakeColumnValueExpression(*scan_schema, 0, "colA")}};
+  SpillStats stats;
+  auto expected = run(&unique_plan, EXECUTION_MEMORY_BUDGET, &stats);
+  EXPECT_EQ(expected.size(), 2 * TEST1_SIZE);
+  EXPECT_EQ(stats.num_runs_, 0);
+  EXPECT_EQ(run(&unique_plan, 4096, &stats), expected);
+  EXPECT_GT(stats.num_pages_, 0);
+  EXPECT_GE(stats.num_tuples_, 4 * TEST1_SIZE);
+  EXPECT_GT(stats.num_repartitions_, 0);
+  EXPECT_EQ(stats.max_level_, 2);
+
+  // a join on colB, which has 10 values: repartitioning cannot split the tuples of a key, which are joined in chunks
+  HashJoinPlanNode skewed_plan{out_schema,
+                               {&scan_plan, &small_scan_plan},
+                               {MakeColumnValueExpression(*scan_schema, 0, "colB")},
+                               {MakeColumnValueExpression(*scan_schema, 0, "colB")}};
+  expected = run(&skewed_plan, EXECUTION_MEMORY_BUDGET, &stats);
+  EXPECT_GT(expected.size(), 2 * TEST1_SIZE);
+  EXPECT_EQ(run(&skewed_plan, 128, &stats), expected);
+  EXPECT_EQ(stats.max_level_, HashJoinExecutor::MAX_PARTITION_LEVEL);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, AggregationSpillsToTmpTuplePages) {
+  TableMetadata *table_info = MakeTest1LikeTable("test_spill", 2 * TEST1_SIZE);
+  Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *out_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"countC", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)},
+                                       {"minC", MakeAggregateValueExpression(false, 2)},
+                                       {"maxC", MakeAggregateValueExpression(false, 3)}});
+  auto make_plan = [&](const char *key_name) {
+    return std::make_unique<AggregationPlanNode>(
+        out_schema, &scan_plan, nullptr,
+        std::vector<const AbstractExpression *>{MakeColumnValueExpression(*scan_schema, 0, key_name)},
+        std::vector<const AbstractExpression *>{colC, colC, colC, colC},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate});
+  };
+
+  auto run = [&](const AggregationPlanNode *plan, size_t memory_budget, SpillStats *stats) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    AggregationExecutor executor(GetExecutorContext(), plan,
+                                 std::make_unique<SeqScanExecutor>(GetExecutorContext(), &scan_plan));
+    executor.Init();
+    std::vector<std::string> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      rows.push_back(tuple.ToString(out_schema));
+    }
+    *stats = executor.GetSpillStats();
+    // the vectorized path spills in the same way
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->ExecuteVectorized(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> vectorized_rows;
+    for (const auto &result : result_set) {
+      vectorized_rows.push_back(result.ToString(out_schema));
+    }
+    std::sort(rows.begin(), rows.end());
+    std::sort(vectorized_rows.begin(), vectorized_rows.end());
+    EXPECT_EQ(rows, vectorized_rows);
+    return rows;
+  };
+
+  // a group by the unique colA, whose partitions are partitioned once more to fit in 4 KB
+  auto unique_plan = make_plan("colA");
+  SpillStats stats;
+  auto expected = run(unique_plan.get(), EXECUTION_MEMORY_BUDGET, &stats);
+  EXPECT_EQ(expected.size(), 2 * TEST1_SIZE);
+  EXPECT_EQ(stats.num_runs_, 0);
+  EXPECT_EQ(run(unique_plan.get(), 4096, &stats), expected);
+  EXPECT_GT(stats.num_pages_, 0);
+  EXPECT_GT(stats.num_tuples_, 2 * TEST1_SIZE);
+  EXPECT_GT(stats.num_repartitions_, 0);
+  EXPECT_GE(stats.max_level_, 2);
+
+  // a group by colB, which has 10 values: with room for a single group, each pass produces one of them
+  auto small_plan = make_plan("colB");
+  expected = run(small_plan.get(), EXECUTION_MEMORY_BUDGET, &stats);
+  EXPECT_EQ(expected.size(), 10);
+  EXPECT_EQ(run(small_plan.get(), 1, &stats), expected);
+  EXPECT_GT(stats.num_repartitions_, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, TypedAggregatesSkipNulls) {
+  const int32_t num_rows = 3000;
+  // big does not fit in an INTEGER
+  const int64_t big_base = 3000000000;
+  Schema table_schema({Column("key", TypeId::INTEGER), Column("big", TypeId::BIGINT), Column("real", TypeId::DECIMAL),
+                       Column("maybe", TypeId::INTEGER), Column("name", TypeId::VARCHAR, 16)});
+  TableMetadata *table_info = GetCatalog()->CreateTable(GetTxn(), "test_types", table_schema);
+  // the group of key 0 has no value of maybe, and the other groups have one in every other row
+  auto maybe = [](int32_t i) { return i % 3 == 0 || i % 2 == 0 ? std::optional<int32_t>() : i; };
+  for (int32_t i = 0; i < num_rows; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i % 3), ValueFactory::GetBigIntValue(big_base + i),
+                              ValueFactory::GetDecimalValue(i * 0.5),
+                              maybe(i) ? ValueFactory::GetIntegerValue(*maybe(i))
+                                       : ValueFactory::GetNullValueByType(TypeId::INTEGER),
+                              ValueFactory::GetVarcharValue("n" + std::to_string(i % 100))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &table_info->schema_), &rid, GetTxn()));
+  }
+
+  Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"key", MakeColumnValueExpression(schema, 0, "key")},
+                                        {"big", MakeColumnValueExpression(schema, 0, "big")},
+                                        {"real", MakeColumnValueExpression(schema, 0, "real")},
+                                        {"maybe", MakeColumnValueExpression(schema, 0, "maybe")},
+                                        {"name", MakeColumnValueExpression(schema, 0, "name")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *key = MakeColumnValueExpression(*scan_schema, 0, "key");
+  auto *big = MakeColumnValueExpression(*scan_schema, 0, "big");
+  auto *real = MakeColumnValueExpression(*scan_schema, 0, "real");
+  auto *maybe_col = MakeColumnValueExpression(*scan_schema, 0, "maybe");
+  auto *name = MakeColumnValueExpression(*scan_schema, 0, "name");
+  // SELECT key, SUM(big), MIN(big), MAX(real), AVG(real), SUM(maybe), COUNT(maybe), AVG(maybe), MIN(name),
+  // APPROX_COUNT_DISTINCT(big), APPROX_COUNT_DISTINCT(name) FROM test_types GROUP BY key
+  auto *out_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"sumBig", MakeAggregateValueExpression(false, 0, TypeId::BIGINT)},
+                                       {"minBig", MakeAggregateValueExpression(false, 1, TypeId::BIGINT)},
+                                       {"maxReal", MakeAggregateValueExpression(false, 2, TypeId::DECIMAL)},
+                                       {"avgReal", MakeAggregateValueExpression(false, 3, TypeId::DECIMAL)},
+                                       {"sumMaybe", MakeAggregateValueExpression(false, 4)},
+                                       {"countMaybe", MakeAggregateValueExpression(false, 5)},
+                                       {"avgMaybe", MakeAggregateValueExpression(false, 6, TypeId::DECIMAL)},
+                                       {"minName", MakeAggregateValueExpression(false, 7, TypeId::VARCHAR)},
+                                       {"distinctBig", MakeAggregateValueExpression(false, 8)},
+                                       {"distinctName", MakeAggregateValueExpression(false, 9)}});
+  AggregationPlanNode agg_plan{
+      out_schema,
+      &scan_plan,
+      nullptr,
+      {key},
+      {big, big, real, real, maybe_col, maybe_col, maybe_col, name, big, name},
+      {AggregationType::SumAggregate, AggregationType::MinAggregate, AggregationType::MaxAggregate,
+       AggregationType::AvgAggregate, AggregationType::SumAggregate, AggregationType::CountAggregate,
+       AggregationType::AvgAggregate, AggregationType::MinAggregate, AggregationType::ApproxCountDistinctAggregate,
+       AggregationType::ApproxCountDistinctAggregate}};
+
+  auto check = [&](const std::vector<Tuple> &result_set) {
+    ASSERT_EQ(result_set.size(), 3);
+    for (const auto &tuple : result_set) {
+      int32_t k = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+      int64_t sum_big = 0;
+      int64_t min_big = BUSTUB_INT64_MAX;
+      double max_real = 0;
+      double sum_real = 0;
+      int32_t sum_maybe = 0;
+      int32_t num_maybe = 0;
+      for (int32_t i = k; i < num_rows; i += 3) {
+        sum_big += big_base + i;
+        min_big = std::min(min_big, big_base + i);
+        max_real = std::max(max_real, i * 0.5);
+        sum_real += i * 0.5;
+        if (maybe(i)) {
+          sum_maybe += *maybe(i);
+          num_maybe++;
+        }
+      }
+      EXPECT_EQ(tuple.GetValue(out_schema, 1).GetAs<int64_t>(), sum_big);
+      EXPECT_EQ(tuple.GetValue(out_schema, 2).GetAs<int64_t>(), min_big);
+      EXPECT_EQ(tuple.GetValue(out_schema, 3).GetAs<double>(), max_real);
+      EXPECT_DOUBLE_EQ(tuple.GetValue(out_schema, 4).GetAs<double>(), sum_real / (num_rows / 3));
+      EXPECT_EQ(tuple.GetValue(out_schema, 6).GetAs<int32_t>(), num_rows / 3);
+      if (num_maybe == 0) {
+        EXPECT_TRUE(tuple.GetValue(out_schema, 5).IsNull());
+        EXPECT_TRUE(tuple.GetValue(out_schema, 7).IsNull());
+      } else {
+        EXPECT_EQ(tuple.GetValue(out_schema, 5).GetAs<int32_t>(), sum_maybe);
+        EXPECT_DOUBLE_EQ(tuple.GetValue(out_schema, 7).GetAs<double>(), static_cast<double>(sum_maybe) / num_maybe);
+      }
+      EXPECT_EQ(tuple.GetValue(out_schema, 8).ToString(), "n0");
+      // the sketches are within a few standard errors of the 1000 distinct values of big and 100 of name
+      EXPECT_NEAR(tuple.GetValue(out_schema, 9).GetAs<int32_t>(), num_rows / 3, 100);
+      EXPECT_NEAR(tuple.GetValue(out_schema, 10).GetAs<int32_t>(), 100, 5);
+    }
+  };
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+  check(result_set);
+  // merging the states of the threads gives the same aggregates
+  GetExecutorContext()->SetNumThreads(2);
+  result_set.clear();
+  GetExecutionEngine()->ExecuteVectorized(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+  check(result_set);
+  GetExecutorContext()->SetNumThreads(1);
+
+  // a SUM that does not fit in its INTEGER type is out of range, and a SUM of strings is not defined
+  auto *max_int = MakeConstantValueExpression(ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
+  AggregationPlanNode overflow_plan{MakeOutputSchema({{"sum", MakeAggregateValueExpression(false, 0)}}),
+                                    &scan_plan,
+                                    nullptr,
+                                    {},
+                                    {max_int},
+                                    {AggregationType::SumAggregate}};
+  AggregationExecutor overflow_executor(GetExecutorContext(), &overflow_plan,
+                                        std::make_unique<SeqScanExecutor>(GetExecutorContext(), &scan_plan));
+  overflow_executor.Init();
+  Tuple tuple;
+  RID rid;
+  EXPECT_THROW(overflow_executor.Next(&tuple, &rid), Exception);
+  AggregationPlanNode string_plan{MakeOutputSchema({{"sum", MakeAggregateValueExpression(false, 0)}}),
+                                  &scan_plan,
+                                  nullptr,
+                                  {},
+                                  {name},
+                                  {AggregationType::SumAggregate}};
+  EXPECT_THROW(AggregationExecutor(GetExecutorContext(), &string_plan,
+                                   std::make_unique<SeqScanExecutor>(GetExecutorContext(), &scan_plan)),
+               Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SortMatchesStableSort) {
+  TableMetadata *table_info = MakeTest1LikeTable("test_sort", 2 * TEST1_SIZE);
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  const Schema *scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+  // SELECT colA, colB, colC FROM test_sort
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  std::vector<Tuple> scan_result;
+  GetExecutionEngine()->Execute(&scan_plan, &scan_result, GetTxn(), GetExecutorContext());
+
+  auto run = [&](const SortPlanNode *plan, size_t memory_budget, size_t num_threads, SpillStats *stats) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    GetExecutorContext()->SetNumThreads(num_threads);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+    executor->Init();
+    std::vector<std::string> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    *stats = dynamic_cast<SortExecutor *>(executor.get())->GetSpillStats();
+    return rows;
+  };
+  auto stable_sort = [](std::vector<Tuple> tuples, const Schema *schema,
+                        const std::function<bool(const Tuple &, const Tuple &)> &less) {
+    std::stable_sort(tuples.begin(), tuples.end(), less);
+    std::vector<std::string> rows;
+    for (const auto &tuple : tuples) {
+      rows.push_back(tuple.ToString(schema));
+    }
+    return rows;
+  };
+  auto value = [&](const Tuple &tuple, uint32_t column_idx) {
+    return tuple.GetValue(scan_schema, column_idx).GetAs<int32_t>();
+  };
+
+  // ORDER BY colB, where tuples with equal keys keep the order of the scan
+  SortPlanNode sort_plan{
+      scan_schema, &scan_plan, {{OrderByType::ASC, MakeColumnValueExpression(*scan_schema, 0, "colB")}}};
+  auto expected = stable_sort(scan_result, scan_schema, [&](const Tuple &a, const Tuple &b) {
+    return value(a, 1) < value(b, 1);
+  });
+  // ORDER BY colC DESC, colA
+  SortPlanNode multi_key_plan{scan_schema,
+                              &scan_plan,
+                              {{OrderByType::DESC, MakeColumnValueExpression(*scan_schema, 0, "colC")},
+                               {OrderByType::ASC, MakeColumnValueExpression(*scan_schema, 0, "colA")}}};
+  auto multi_key_expected = stable_sort(scan_result, scan_schema, [&](const Tuple &a, const Tuple &b) {
+    return value(a, 2) != value(b, 2) ? value(a, 2) > value(b, 2) : value(a, 0) < value(b, 0);
+  });
+
+  for (const auto &[plan, expected_rows] : {std::make_pair(&sort_plan, expected),
+                                            std::make_pair(&multi_key_plan, multi_key_expected)}) {
+    SpillStats stats;
+    EXPECT_EQ(run(plan, EXECUTION_MEMORY_BUDGET, 1, &stats), expected_rows);
+    EXPECT_EQ(stats.num_runs_, 0);
+    // runs of 2 KB, more than the buffer pool can merge at once
+    EXPECT_EQ(run(plan, 2048, 1, &stats), expected_rows);
+    EXPECT_GT(stats.num_runs_, SortExecutor::MAX_MERGE_FAN_IN / 4);
+    EXPECT_GT(stats.num_merge_passes_, 0);
+    // the same runs, sorted and spilled by 4 threads
+    EXPECT_EQ(run(plan, 4 * 2048, 4, &stats), expected_rows);
+    EXPECT_GT(stats.num_merge_passes_, 0);
+  }
+
+  // ORDER BY name DESC, over strings that share their first 8 bytes or are prefixes of one another
+  Schema string_schema({Column("name", TypeId::VARCHAR, 32), Column("id", TypeId::INTEGER)});
+  TableMetadata *string_table = GetCatalog()->CreateTable(GetTxn(), "test_sort_strings", string_schema);
+  std::mt19937 generator(15445);
+  for (int32_t i = 0; i < 500; i++) {
+    std::string name = (i % 2 == 0 ? "shared_prefix_" : "") + std::to_string(generator() % 1000);
+    std::vector<Value> values{ValueFactory::GetVarcharValue(name), ValueFactory::GetIntegerValue(i)};
+    RID rid;
+    ASSERT_TRUE(string_table->table_->InsertTuple(Tuple(values, &string_table->schema_), &rid, GetTxn()));
+  }
+  auto *name = MakeColumnValueExpression(string_table->schema_, 0, "name");
+  auto *id = MakeColumnValueExpression(string_table->schema_, 0, "id");
+  const Schema *string_scan_schema = MakeOutputSchema({{"name", name}, {"id", id}});
+  SeqScanPlanNode string_scan_plan{string_scan_schema, nullptr, string_table->oid_};
+  std::vector<Tuple> string_scan_result;
+  GetExecutionEngine()->Execute(&string_scan_plan, &string_scan_result, GetTxn(), GetExecutorContext());
+  SortPlanNode string_sort_plan{string_scan_schema,
+                                &string_scan_plan,
+                                {{OrderByType::DESC, MakeColumnValueExpression(*string_scan_schema, 0, "name")}}};
+  auto string_expected = stable_sort(string_scan_result, string_scan_schema, [&](const Tuple &a, const Tuple &b) {
+    return a.GetValue(string_scan_schema, 0).ToString() > b.GetValue(string_scan_schema, 0).ToString();
+  });
+  SpillStats stats;
+  EXPECT_EQ(run(&string_sort_plan, EXECUTION_MEMORY_BUDGET, 1, &stats), string_expected);
+  EXPECT_EQ(run(&string_sort_plan, 2048, 1, &stats), string_expected);
+  EXPECT_GT(stats.num_runs_, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, TopNMatchesSortAndLimit) {
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  const Schema *scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+  // SELECT colA, colB, colC FROM test_1
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+
+  auto run = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    return rows;
+  };
+  auto order_bys = [&](OrderByType first_type) {
+    return std::vector<std::pair<OrderByType, const AbstractExpression *>>{
+        {first_type, MakeColumnValueExpression(*scan_schema, 0, "colB")},
+        {OrderByType::DESC, MakeColumnValueExpression(*scan_schema, 0, "colC")}};
+  };
+
+  // ORDER BY colB, colC DESC LIMIT n, where colB has 10 values and colC has ties, against a sort and a limit
+  for (OrderByType first_type : {OrderByType::ASC, OrderByType::DESC}) {
+    SortPlanNode sort_plan{scan_schema, &scan_plan, order_bys(first_type)};
+    for (size_t n : {0U, 1U, 10U, 150U, 2 * TEST1_SIZE}) {
+      LimitPlanNode limit_plan{scan_schema, &sort_plan, n, 0};
+      TopNPlanNode top_n_plan{scan_schema, &scan_plan, order_bys(first_type), n};
+      auto expected = run(&limit_plan);
+      EXPECT_EQ(expected.size(), std::min<size_t>(n, TEST1_SIZE));
+      EXPECT_EQ(run(&top_n_plan), expected);
+    }
+  }
+
+  // an ORDER BY needs at least one key
+  EXPECT_THROW((SortPlanNode{scan_schema, &scan_plan, {}}), Exception);
+  EXPECT_THROW((TopNPlanNode{scan_schema, &scan_plan, {}, 10}), Exception);
+
+  // LIMIT 10 OFFSET 5 returns the 6th to the 15th tuple
+  SortPlanNode sort_plan{scan_schema, &scan_plan, order_bys(OrderByType::ASC)};
+  LimitPlanNode limit_plan{scan_schema, &sort_plan, 15, 0};
+  LimitPlanNode offset_plan{scan_schema, &sort_plan, 10, 5};
+  auto first_15 = run(&limit_plan);
+  EXPECT_EQ(run(&offset_plan), std::vector<std::string>(first_15.begin() + 5, first_15.end()));
+
+  // an index scan on colA produces its tuples in the order of ORDER BY colA, but not of ORDER BY colA DESC
+  Schema *key_schema = ParseCreateStatement("a integer");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "top_n_index", "test_1", schema, *key_schema, {0}, 8);
+  IndexScanPlanNode index_scan_plan{scan_schema, nullptr, index_info->index_oid_};
+  for (OrderByType type : {OrderByType::ASC, OrderByType::DESC}) {
+    TopNPlanNode top_n_plan{scan_schema, &index_scan_plan, {{type, MakeColumnValueExpression(*scan_schema, 0, "colA")}},
+                            10};
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &top_n_plan);
+    executor->Init();
+    EXPECT_EQ(dynamic_cast<TopNExecutor *>(executor.get())->IsInputOrdered(), type == OrderByType::ASC);
+    Tuple tuple;
+    RID rid;
+    std::vector<int32_t> col_a;
+    while (executor->Next(&tuple, &rid)) {
+      col_a.push_back(tuple.GetValue(scan_schema, 0).GetAs<int32_t>());
+    }
+    ASSERT_EQ(col_a.size(), 10);
+    for (int32_t i = 0; i < 10; i++) {
+      EXPECT_EQ(col_a[i], type == OrderByType::ASC ? i : static_cast<int32_t>(TEST1_SIZE) - 1 - i);
+    }
+  }
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelSeqScanMatchesSerialScan) {
+  TableMetadata *table_info = MakeTest1LikeTable("test_parallel", 5 * EXECUTION_BATCH_SIZE + 7);
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  // SELECT colA, colB FROM test_parallel WHERE colB < 3
+  auto *predicate = MakeComparisonExpression(colB, MakeConstantValueExpression(ValueFactory::GetIntegerValue(3)),
+                                             ComparisonType::LessThan);
+  const Schema *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+
+  auto to_rows = [&](const std::vector<Tuple> &result_set) {
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(out_schema));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&scan_plan, &result_set, GetTxn(), GetExecutorContext());
+  auto expected = to_rows(result_set);
+  ASSERT_GT(expected.size(), 0);
+
+  // the threads' batches are gathered in no particular order
+  for (size_t num_threads : {2, 4}) {
+    GetExecutorContext()->SetNumThreads(num_threads);
+    result_set.clear();
+    GetExecutionEngine()->Execute(&scan_plan, &result_set, GetTxn(), GetExecutorContext());
+    EXPECT_EQ(to_rows(result_set), expected);
+    result_set.clear();
+    GetExecutionEngine()->ExecuteVectorized(&scan_plan, &result_set, GetTxn(), GetExecutorContext());
+    EXPECT_EQ(to_rows(result_set), expected);
+  }
+
+  // a parallel scan stopped early stops its threads
+  SeqScanExecutor executor(GetExecutorContext(), &scan_plan);
+  executor.Init();
+  EXPECT_TRUE(executor.IsParallel());
+  Tuple tuple;
+  RID rid;
+  EXPECT_TRUE(executor.Next(&tuple, &rid));
+  executor.Init();
+
+  // a parent can run the pipelines of the scan itself, each worker claiming its own morsels
+  SeqScanExecutor::ScanWorker workers[2];
+  TupleBatch batch;
+  result_set.clear();
+  for (bool active = true; active;) {
+    active = false;
+    for (auto &worker : workers) {
+      if (executor.NextParallelBatch(&worker, &batch)) {
+        active = true;
+        for (uint32_t row : batch.GetSelection()) {
+          result_set.push_back(batch.GetTuple(row, out_schema));
+        }
+      }
+    }
+  }
+  EXPECT_EQ(to_rows(result_set), expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelAggregationMatchesSerialAggregation) {
+  TableMetadata *table_info = MakeTest1LikeTable("test_parallel", 5 * EXECUTION_BATCH_SIZE + 7);
+  Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *colD = MakeColumnValueExpression(*scan_schema, 0, "colD");
+  auto *out_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"countC", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)},
+                                       {"minD", MakeAggregateValueExpression(false, 2)},
+                                       {"maxD", MakeAggregateValueExpression(false, 3)}});
+
+  // SELECT key, COUNT(colC), SUM(colC), MIN(colD), MAX(colD) FROM test_parallel GROUP BY key, where the groups of
+  // colB share many rows, and those of colA none
+  for (const char *key_name : {"colB", "colA"}) {
+    bool high_cardinality = std::string(key_name) == "colA";
+    AggregationPlanNode agg_plan{out_schema,
+                                 &scan_plan,
+                                 nullptr,
+                                 {MakeColumnValueExpression(*scan_schema, 0, key_name)},
+                                 {colC, colC, colD, colD},
+                                 {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                  AggregationType::MinAggregate, AggregationType::MaxAggregate}};
+    auto to_rows = [&](const std::vector<Tuple> &result_set) {
+      std::vector<std::string> rows;
+      for (const auto &tuple : result_set) {
+        rows.push_back(tuple.ToString(out_schema));
+      }
+      std::sort(rows.begin(), rows.end());
+      return rows;
+    };
+    GetExecutorContext()->SetNumThreads(1);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+    auto expected = to_rows(result_set);
+    ASSERT_EQ(expected.size(), high_cardinality ? 5 * EXECUTION_BATCH_SIZE + 7 : 10);
+
+    for (size_t num_threads : {2, 4}) {
+      GetExecutorContext()->SetNumThreads(num_threads);
+      result_set.clear();
+      GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+      EXPECT_EQ(to_rows(result_set), expected);
+      result_set.clear();
+      GetExecutionEngine()->ExecuteVectorized(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+      EXPECT_EQ(to_rows(result_set), expected);
+    }
+
+    // pre-aggregating rows that all have groups of their own only doubles the work
+    AggregationExecutor executor(GetExecutorContext(), &agg_plan,
+                                 std::make_unique<SeqScanExecutor>(GetExecutorContext(), &scan_plan));
+    executor.Init();
+    EXPECT_TRUE(executor.IsParallel());
+    Tuple tuple;
+    RID rid;
+    EXPECT_TRUE(executor.Next(&tuple, &rid));
+    EXPECT_EQ(executor.SkippedPreAggregation(), high_cardinality);
+  }
+  GetExecutorContext()->SetNumThreads(1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DenseAggregationMatchesHashAggregation) {
+  const uint32_t num_rows = 5 * EXECUTION_BATCH_SIZE + 7;
+  TableMetadata *table_info = MakeTest1LikeTable("test_dense", num_rows);
+  Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")},
+                                        {"colD", MakeColumnValueExpression(schema, 0, "colD")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *colD = MakeColumnValueExpression(*scan_schema, 0, "colD");
+  auto *out_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"countC", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)},
+                                       {"minD", MakeAggregateValueExpression(false, 2)},
+                                       {"maxD", MakeAggregateValueExpression(false, 3)},
+                                       {"avgC", MakeAggregateValueExpression(false, 4, TypeId::DECIMAL)}});
+  // SELECT key, COUNT(colC), SUM(colC), MIN(colD), MAX(colD), AVG(colC) FROM test_dense GROUP BY key
+  auto make_plan = [&](const char *key_name) {
+    return std::make_unique<AggregationPlanNode>(
+        out_schema, &scan_plan, nullptr,
+        std::vector<const AbstractExpression *>{MakeColumnValueExpression(*scan_schema, 0, key_name)},
+        std::vector<const AbstractExpression *>{colC, colC, colD, colD, colC},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate,
+                                     AggregationType::AvgAggregate});
+  };
+  auto plan = make_plan("colB");
+
+  auto run = [&](bool dense) {
+    AggregationExecutor executor(GetExecutorContext(), plan.get(),
+                                 std::make_unique<SeqScanExecutor>(GetExecutorContext(), &scan_plan));
+    executor.Init();
+    EXPECT_EQ(executor.IsDense(), dense);
+    std::vector<std::string> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor.Next(&tuple, &rid)) {
+      rows.push_back(tuple.ToString(out_schema));
+    }
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->ExecuteVectorized(plan.get(), &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> vectorized_rows;
+    for (const auto &result : result_set) {
+      vectorized_rows.push_back(result.ToString(out_schema));
+    }
+    std::sort(rows.begin(), rows.end());
+    std::sort(vectorized_rows.begin(), vectorized_rows.end());
+    EXPECT_EQ(rows, vectorized_rows);
+    return rows;
+  };
+
+  // the generated tables are analyzed, but this one is not: its groups are hashed until it is
+  EXPECT_NE(GetCatalog()->GetTable("test_1")->stats_, nullptr);
+  auto expected = run(false);
+  ASSERT_EQ(expected.size(), 10);
+  const TableStats *stats = GetCatalog()->AnalyzeTable(GetTxn(), "test_dense");
+  EXPECT_EQ(stats->num_rows_, num_rows);
+  EXPECT_EQ(stats->columns_[1].num_nulls_, 0);
+  EXPECT_TRUE(stats->columns_[1].has_range_);
+  EXPECT_EQ(stats->columns_[1].min_, 0);
+  EXPECT_EQ(stats->columns_[1].max_, 9);
+  EXPECT_EQ(run(true), expected);
+
+  // rows inserted since the analysis, whose colB is out of the range of the statistics or NULL, are hashed
+  for (int32_t i = 0; i < 30; i++) {
+    Value key = i == 0       ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                : i % 2 == 0 ? ValueFactory::GetIntegerValue(-1)
+                             : ValueFactory::GetIntegerValue(10);
+    std::vector<Value> values{ValueFactory::GetIntegerValue(static_cast<int32_t>(num_rows) + i), key,
+                              ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(-i)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &table_info->schema_), &rid, GetTxn()));
+  }
+  std::unique_ptr<TableStats> stale_stats = std::move(table_info->stats_);
+  expected = run(false);
+  ASSERT_EQ(expected.size(), 13);
+  table_info->stats_ = std::move(stale_stats);
+  EXPECT_EQ(run(true), expected);
+
+  // the range of colA is too wide for arrays
+  auto wide_plan = make_plan("colA");
+  AggregationExecutor executor(GetExecutorContext(), wide_plan.get(),
+                               std::make_unique<SeqScanExecutor>(GetExecutorContext(), &scan_plan));
+  executor.Init();
+  EXPECT_FALSE(executor.IsDense());
+}
+
+/** Executor tests whose tables fit in the buffer pool, so that they measure execution rather than I/O. */
+class ExecutorBenchmarkTest : public ExecutorTest {
+ public:
+  ExecutorBenchmarkTest() { pool_size_ = 4096; }
+};
+
+/*
+ * A scan with a filter, a group by aggregation and a join over a table with the columns of test_1, executed
+ * tuple-at-a-time and a batch at a time.
+ */
+// NOLINTNEXTLINE
+TEST_F(ExecutorBenchmarkTest, DISABLED_BenchmarkVectorizedExecution) {
+  // table heap inserts look for free space from the first page on, so larger tables take long to load
+  const uint32_t num_rows = 100000;
+  TableMetadata *table_info = MakeTest1LikeTable("test_big", num_rows);
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+
+  // SELECT colA, colC FROM test_big WHERE colC < 5000
+  auto *scan_schema = MakeOutputSchema({{"colA", colA}, {"colC", colC}});
+  auto *scan_predicate = MakeComparisonExpression(
+      colC, MakeConstantValueExpression(ValueFactory::GetIntegerValue(5000)), ComparisonType::LessThan);
+  SeqScanPlanNode scan_plan{scan_schema, scan_predicate, table_info->oid_};
+
+  // SELECT colB, COUNT(colA), SUM(colC) FROM test_big GROUP BY colB
+  auto *group_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+  SeqScanPlanNode group_scan_plan{group_schema, nullptr, table_info->oid_};
+  auto *agg_colA = MakeColumnValueExpression(*group_schema, 0, "colA");
+  auto *agg_colB = MakeColumnValueExpression(*group_schema, 0, "colB");
+  auto *agg_colC = MakeColumnValueExpression(*group_schema, 0, "colC");
+  AggregationPlanNode agg_plan{MakeOutputSchema({{"colB", MakeAggregateValueExpression(true, 0)},
+                                                 {"countA", MakeAggregateValueExpression(false, 0)},
+                                                 {"sumC", MakeAggregateValueExpression(false, 1)}}),
+                               &group_scan_plan,
+                               nullptr,
+                               {agg_colB},
+                               {agg_colA, agg_colC},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate}};
+
+  // SELECT scan.colA, test_2.col3 FROM (SELECT colA, colC FROM test_big WHERE colA < 10000) JOIN test_2
+  // ON scan.colC = test_2.col4
+  auto *join_predicate_left = MakeComparisonExpression(
+      colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(10000)), ComparisonType::LessThan);
+  SeqScanPlanNode left_plan{scan_schema, join_predicate_left, table_info->oid_};
+  auto *test_2_info = GetCatalog()->GetTable("test_2");
+  auto *right_schema = MakeOutputSchema({{"col3", MakeColumnValueExpression(test_2_info->schema_, 0, "col3")},
+                                         {"col4", MakeColumnValueExpression(test_2_info->schema_, 0, "col4")}});
+  SeqScanPlanNode right_plan{right_schema, nullptr, test_2_info->oid_};
+  auto *join_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *join_colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *join_col3 = MakeColumnValueExpression(*right_schema, 1, "col3");
+  auto *join_col4 = MakeColumnValueExpression(*right_schema, 1, "col4");
+  NestedLoopJoinPlanNode join_plan{MakeOutputSchema({{"colA", join_colA}, {"col3", join_col3}}),
+                                   {&left_plan, &right_plan},
+                                   MakeComparisonExpression(join_colC, join_col4, ComparisonType::Equal)};
+
+  auto run = [&](const char *name, const AbstractPlanNode *plan, size_t num_inputs) {
+    std::cout << name << std::endl;
+    size_t num_results[2];
+    for (bool vectorized : {false, true}) {
+      std::vector<Tuple> result_set;
+      auto start = std::chrono::steady_clock::now();
+      if (vectorized) {
+        GetExecutionEngine()->ExecuteVectorized(plan, &result_set, GetTxn(), GetExecutorContext());
+      } else {
+        GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      num_results[vectorized] = result_set.size();
+      std::cout << "  " << (vectorized ? "vectorized" : "volcano") << ": " << elapsed.count() << " s, "
+                << num_inputs / elapsed.count() / 1e6 << " Mrows/s" << std::endl;
+    }
+    EXPECT_EQ(num_results[0], num_results[1]);
+  };
+  run("scan and filter", &scan_plan, num_rows);
+  run("group by aggregation", &agg_plan, num_rows);
+  // the input of the join is the scan of the table plus the pairs of rows that the join compares
+  run("nested loop join", &join_plan, num_rows + 10000 * TEST2_SIZE);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorBenchmarkTest, DISABLED_BenchmarkParallelSeqScan) {
+  const uint32_t num_rows = 100000;
+  TableMetadata *table_info = MakeTest1LikeTable("test_big", num_rows);
+  Schema &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colC = MakeColumnValueExpression(schema, 0, "colC");
+  // SELECT colA, colC FROM test_big WHERE colC < 5000
+  auto *scan_predicate = MakeComparisonExpression(
+      colC, MakeConstantValueExpression(ValueFactory::GetIntegerValue(5000)), ComparisonType::LessThan);
+  SeqScanPlanNode scan_plan{MakeOutputSchema({{"colA", colA}, {"colC", colC}}), scan_predicate, table_info->oid_};
+
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    GetExecutorContext()->SetNumThreads(num_threads);
+    SeqScanExecutor executor(GetExecutorContext(), &scan_plan);
+    executor.Init();
+    TupleBatch batch;
+    size_t num_results = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (executor.NextBatch(&batch)) {
+      num_results += batch.GetNumSelected();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "  " << num_threads << " threads: " << elapsed.count() << " s, " << num_rows / elapsed.count() / 1e6
+              << " Mrows/s" << std::endl;
+    EXPECT_GT(num_results, 0);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorBenchmarkTest, DISABLED_BenchmarkParallelAggregation) {
+  const uint32_t num_rows = 100000;
+  TableMetadata *table_info = MakeTest1LikeTable("test_big", num_rows);
+  Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")},
+                                        {"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *out_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"countC", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)}});
+
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+  // SELECT key, COUNT(colC), SUM(colC) FROM test_big GROUP BY key, with 10 groups of colB or 100000 of colA
+  for (const char *key_name : {"colB", "colA"}) {
+    AggregationPlanNode agg_plan{out_schema,
+                                 &scan_plan,
+                                 nullptr,
+                                 {MakeColumnValueExpression(*scan_schema, 0, key_name)},
+                                 {colC, colC},
+                                 {AggregationType::CountAggregate, AggregationType::SumAggregate}};
+    std::cout << "group by " << key_name << std::endl;
+    for (size_t num_threads : {1, 2, 4, 8}) {
+      GetExecutorContext()->SetNumThreads(num_threads);
+      std::vector<Tuple> result_set;
+      auto start = std::chrono::steady_clock::now();
+      GetExecutionEngine()->ExecuteVectorized(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << "  " << num_threads << " threads: " << elapsed.count() << " s, "
+                << num_rows / elapsed.count() / 1e6 << " Mrows/s, " << result_set.size() << " groups" << std::endl;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorBenchmarkTest, DISABLED_BenchmarkDenseAggregation) {
+  const uint32_t num_rows = 100000;
+  TableMetadata *table_info = MakeTest1LikeTable("test_big", num_rows);
+  Schema &schema = table_info->schema_;
+  auto *scan_schema = MakeOutputSchema({{"colB", MakeColumnValueExpression(schema, 0, "colB")},
+                                        {"colC", MakeColumnValueExpression(schema, 0, "colC")}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+  auto *colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *out_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"countC", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)},
+                                       {"maxC", MakeAggregateValueExpression(false, 2)}});
+  // SELECT colB, COUNT(colC), SUM(colC), MAX(colC) FROM test_big GROUP BY colB, hashed and then in arrays
+  AggregationPlanNode agg_plan{out_schema,
+                               &scan_plan,
+                               nullptr,
+                               {MakeColumnValueExpression(*scan_schema, 0, "colB")},
+                               {colC, colC, colC},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                AggregationType::MaxAggregate}};
+  for (bool analyzed : {false, true}) {
+    if (analyzed) {
+      GetCatalog()->AnalyzeTable(GetTxn(), "test_big");
+    }
+    for (bool vectorized : {false, true}) {
+      std::vector<Tuple> result_set;
+      auto start = std::chrono::steady_clock::now();
+      if (vectorized) {
+        GetExecutionEngine()->ExecuteVectorized(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+      } else {
+        GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << (analyzed ? "dense " : "hashed ") << (vectorized ? "vectorized: " : "volcano: ") << elapsed.count()
+                << " s, " << num_rows / elapsed.count() / 1e6 << " Mrows/s, " << result_set.size() << " groups"
+                << std::endl;
+    }
+  }
+}
+
 }  // namespace bustub
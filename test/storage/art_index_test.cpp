@@ -0,0 +1,228 @@
+/**
+ * art_index_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// a tag byte keeps the two key families from being prefixes of each other
+std::string ShortKey(uint64_t key) {
+  std::string result(1, '\x01');
+  for (int i = 7; i >= 0; i--) {
+    result.push_back(static_cast<char>(key >> (8 * i)));
+  }
+  return result;
+}
+
+// a shared prefix longer than what inner nodes store
+std::string LongKey(uint32_t key) {
+  std::string result(1, '\x02');
+  result.append(20, 'p');
+  for (int i = 3; i >= 0; i--) {
+    result.push_back(static_cast<char>(key >> (8 * i)));
+  }
+  return result;
+}
+
+TEST(AdaptiveRadixTreeTest, InsertLookupRemove) {
+  AdaptiveRadixTree tree;
+  std::mt19937_64 generator(15445);
+  std::vector<std::string> keys;
+  // dense keys fill Node256s, sparse ones keep Node4s and long prefixes around
+  for (uint64_t key = 0; key < 3000; key++) {
+    keys.push_back(ShortKey(key));
+  }
+  for (int i = 0; i < 5000; i++) {
+    keys.push_back(ShortKey(generator()));
+    keys.push_back(LongKey(static_cast<uint32_t>(generator())));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::shuffle(keys.begin(), keys.end(), generator);
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_TRUE(tree.Insert(keys[i], RID(0, i)));
+  }
+  EXPECT_FALSE(tree.Insert(keys[0], RID(1, 0)));
+  RID rid;
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_TRUE(tree.GetValue(keys[i], &rid)) << i;
+    EXPECT_EQ(rid.GetSlotNum(), i);
+  }
+  EXPECT_FALSE(tree.GetValue(ShortKey(1ULL << 63), &rid));
+  EXPECT_FALSE(tree.GetValue(LongKey(0).replace(5, 1, "q"), &rid));
+
+  // removing collapses nodes with a single child into it
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    EXPECT_TRUE(tree.Remove(keys[i]));
+  }
+  EXPECT_FALSE(tree.Remove(keys[0]));
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(tree.GetValue(keys[i], &rid), i % 2 == 1) << i;
+  }
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    EXPECT_TRUE(tree.Insert(keys[i], RID(0, i)));
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_TRUE(tree.GetValue(keys[i], &rid)) << i;
+    EXPECT_EQ(rid.GetSlotNum(), i);
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, ConcurrentInsertRemoveLookup) {
+  AdaptiveRadixTree tree;
+  const uint32_t num_writers = 4;
+  const uint32_t keys_per_writer = 5000;
+  std::atomic<bool> done{false};
+
+  std::thread reader([&] {
+    std::mt19937 generator(0);
+    RID rid;
+    while (!done) {
+      uint32_t key = generator() % (num_writers * keys_per_writer);
+      if (tree.GetValue(LongKey(key), &rid)) {
+        EXPECT_EQ(rid.GetSlotNum(), key);
+      }
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (uint32_t writer = 0; writer < num_writers; writer++) {
+    writers.emplace_back([&, writer] {
+      for (uint32_t key = writer; key < num_writers * keys_per_writer; key += num_writers) {
+        EXPECT_TRUE(tree.Insert(LongKey(key), RID(0, key)));
+        EXPECT_TRUE(tree.Insert(ShortKey(key), RID(0, key)));
+      }
+      for (uint32_t key = writer; key < num_writers * keys_per_writer; key += 2 * num_writers) {
+        EXPECT_TRUE(tree.Remove(LongKey(key)));
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+
+  RID rid;
+  for (uint32_t key = 0; key < num_writers * keys_per_writer; key++) {
+    ASSERT_TRUE(tree.GetValue(ShortKey(key), &rid)) << key;
+    EXPECT_EQ(tree.GetValue(LongKey(key), &rid), key % (2 * num_writers) >= num_writers) << key;
+  }
+}
+
+TEST(ArtIndexTest, MultiColumnKeys) {
+  Schema *schema = ParseCreateStatement("a bigint,b varchar(16),c double");
+  ArtIndex index(new IndexMetadata("foo_idx", "foo", schema, {0, 1}));
+  Schema *key_schema = index.GetKeySchema();
+  Transaction transaction(0);
+  auto make_key = [key_schema](int64_t number, const std::string &string) {
+    return Tuple({ValueFactory::GetBigIntValue(number), ValueFactory::GetVarcharValue(string)}, key_schema);
+  };
+
+  // strings that are prefixes of each other and negative numbers
+  std::vector<std::string> strings = {"", "a", "ab", "abc", "b"};
+  std::vector<int64_t> numbers = {-1000, -1, 0, 1, 1000};
+  int slot = 0;
+  for (auto number : numbers) {
+    for (const auto &string : strings) {
+      Tuple key = make_key(number, string);
+      index.InsertEntry(key, RID(0, slot++), &transaction);
+    }
+  }
+
+  slot = 0;
+  std::vector<RID> result;
+  for (auto number : numbers) {
+    for (const auto &string : strings) {
+      Tuple key = make_key(number, string);
+      result.clear();
+      index.ScanKey(key, &result, &transaction);
+      ASSERT_EQ(result.size(), 1);
+      EXPECT_EQ(result[0].GetSlotNum(), slot++);
+    }
+  }
+  Tuple missing = make_key(0, "abcd");
+  result.clear();
+  index.ScanKey(missing, &result, &transaction);
+  EXPECT_TRUE(result.empty());
+
+  Tuple key = make_key(-1, "ab");
+  index.DeleteEntry(key, RID(), &transaction);
+  result.clear();
+  index.ScanKey(key, &result, &transaction);
+  EXPECT_TRUE(result.empty());
+
+  delete schema;
+}
+
+/*
+ * Single threaded point inserts and lookups through the Index interface,
+ * with a buffer pool large enough to hold the whole B+ tree.
+ */
+TEST(ArtIndexTest, DISABLED_BenchmarkAgainstBPlusTreeIndex) {
+  Schema *schema = ParseCreateStatement("a bigint");
+  const int64_t size = 200000;
+  std::vector<Tuple> keys;
+  keys.reserve(size);
+  std::mt19937_64 generator(15445);
+  for (int64_t i = 0; i < size; i++) {
+    keys.emplace_back(std::vector<Value>{ValueFactory::GetBigIntValue(static_cast<int64_t>(generator()))}, schema);
+  }
+
+  auto run = [&](const char *name, Index *index) {
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < size; i++) {
+      index->InsertEntry(keys[i], RID(0, i), nullptr);
+    }
+    std::chrono::duration<double> inserts = std::chrono::steady_clock::now() - start;
+    std::shuffle(keys.begin(), keys.end(), generator);
+    std::vector<RID> result;
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < size; i++) {
+      result.clear();
+      index->ScanKey(keys[i], &result, nullptr);
+    }
+    std::chrono::duration<double> lookups = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << size / inserts.count() / 1e6 << " M inserts/s, " << size / lookups.count() / 1e6
+              << " M lookups/s" << std::endl;
+  };
+
+  {
+    ArtIndex index(new IndexMetadata("foo_idx", "foo", schema, {0}));
+    run("ArtIndex", &index);
+  }
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(4096, &disk_manager);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+    BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(new IndexMetadata("foo_idx", "foo", schema, {0}),
+                                                                   &bpm);
+    run("BPlusTreeIndex", &index);
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+  }
+
+  delete schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,156 @@
+/**
+ * b_epsilon_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_epsilon_tree.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using EpsilonTree = BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+TEST(BEpsilonTreeTest, BufferedMessagesForOneKeyCombine) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  // small enough that flushes evict and read back pages
+  BufferPoolManager *bpm = new BufferPoolManager(32, disk_manager);
+  // tiny leaves and fanout, so buffers overflow and nodes split on every level
+  EpsilonTree tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // a few hot keys get many messages each, which meet in a buffer and are combined there, or end up in the buffers
+  // of different levels when updates of the other keys flush them down in between
+  const int64_t num_hot_keys = 8;
+  const int64_t key_range = 2000;
+  std::map<int64_t, int64_t> expected;
+  std::mt19937 generator(15445);
+  std::vector<RID> result;
+  auto check = [&](int64_t key) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    auto it = expected.find(key);
+    ASSERT_EQ(tree.GetValue(index_key, &result, transaction), it != expected.end()) << key;
+    if (it != expected.end()) {
+      ASSERT_EQ(result.size(), 1);
+      EXPECT_EQ(result[0].GetSlotNum(), it->second) << key;
+    }
+  };
+  for (int i = 0; i < 20000; i++) {
+    bool hot = i % 3 == 0;
+    int64_t key = hot ? generator() % num_hot_keys : num_hot_keys + generator() % (key_range - num_hot_keys);
+    index_key.SetFromInteger(key);
+    switch (generator() % 3) {
+      case 0:
+        // only takes effect if the newest older message for the key leaves it absent
+        tree.Insert(index_key, RID(0, i), transaction);
+        expected.emplace(key, i);
+        break;
+      case 1:
+        tree.Upsert(index_key, RID(0, i), transaction);
+        expected[key] = i;
+        break;
+      default:
+        tree.Remove(index_key, transaction);
+        expected.erase(key);
+        break;
+    }
+    if (hot) {
+      check(key);
+    }
+  }
+  EXPECT_FALSE(tree.IsEmpty());
+
+  for (int64_t key = 0; key < key_range; key++) {
+    check(key);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+/*
+ * Random inserts into an index about ten times the size of the buffer pool,
+ * where nearly every BPlusTree insert lands on a leaf that has been evicted.
+ * Reports time and the number of pages written back for both trees.
+ */
+TEST(BEpsilonTreeTest, DISABLED_BenchmarkRandomInsert) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  const size_t pool_size = 64;
+  // a leaf of 8 byte keys holds about 250 entries at fill factor 1
+  const int64_t size = pool_size * 10 * 250;
+  std::vector<int64_t> keys(size);
+  for (int64_t key = 0; key < size; key++) {
+    keys[key] = key;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+  auto run = [&](const char *name, auto *tree, DiskManager *disk_manager) {
+    GenericKey<8> index_key;
+    auto start = std::chrono::steady_clock::now();
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree->Insert(index_key, RID(0, key));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << size / elapsed.count() / 1e3 << " Kinserts/s, " << disk_manager->GetNumWrites()
+              << " page writes" << std::endl;
+
+    std::vector<RID> result;
+    for (int64_t key = 0; key < size; key += 997) {
+      result.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree->GetValue(index_key, &result));
+      EXPECT_EQ(result[0].GetSlotNum(), key);
+    }
+  };
+
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(pool_size, &disk_manager);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+    EpsilonTree tree("foo_pk", &bpm, comparator);
+    run("BEpsilonTree", &tree, &disk_manager);
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+  }
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(pool_size, &disk_manager);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", &bpm, comparator);
+    run("BPlusTree", &tree, &disk_manager);
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+  }
+
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,267 @@
+/**
+ * b_link_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <mutex>  // NOLINT
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_link_tree.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using LinkTree = BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// helper function to launch multiple threads
+template <typename... Args>
+void LaunchParallelTest(uint64_t num_threads, Args &&... args) {
+  std::vector<std::thread> thread_group;
+  for (uint64_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
+    thread_group.push_back(std::thread(args..., thread_itr));
+  }
+  for (uint64_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
+    thread_group[thread_itr].join();
+  }
+}
+
+// every key must be found with the rid derived from it
+void CheckAllKeys(LinkTree *tree, int64_t first, int64_t last) {
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (int64_t key = first; key <= last; key++) {
+    result.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree->GetValue(index_key, &result)) << key;
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].GetSlotNum(), key);
+  }
+}
+
+TEST(BLinkTreeTest, InsertScanRemove) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  LinkTree tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  EXPECT_TRUE(tree.IsEmpty());
+
+  const int64_t size = 1000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= size; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  index_key.SetFromInteger(size / 2);
+  EXPECT_FALSE(tree.Insert(index_key, RID(0, 0), transaction));
+  EXPECT_FALSE(tree.IsEmpty());
+  CheckAllKeys(&tree, 1, size);
+
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  low_key.SetFromInteger(100);
+  high_key.SetFromInteger(299);
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  tree.ScanRange(low_key, high_key, &entries);
+  ASSERT_EQ(entries.size(), 200);
+  for (size_t i = 0; i < entries.size(); i++) {
+    EXPECT_EQ(entries[i].first.ToString(), 100 + static_cast<int64_t>(i));
+  }
+
+  // remove the odd keys
+  for (int64_t key = 1; key <= size; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  std::vector<RID> result;
+  for (int64_t key = 1; key <= size; key++) {
+    result.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &result), key % 2 == 0);
+  }
+  entries.clear();
+  low_key.SetFromInteger(0);
+  high_key.SetFromInteger(size);
+  tree.ScanRange(low_key, high_key, &entries);
+  EXPECT_EQ(entries.size(), size / 2);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BLinkTreeTest, ConcurrentInsertAndRead) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  // small enough that pages get evicted and read back while threads race
+  BufferPoolManager *bpm = new BufferPoolManager(64, disk_manager);
+  // tiny nodes, so splits propagate up to the root all the time
+  LinkTree tree("foo_pk", bpm, comparator, 4, 4);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t size = 4000;
+  const uint64_t num_writers = 8;
+  std::atomic<bool> done{false};
+  std::atomic<int64_t> lookups{0};
+
+  std::thread reader([&] {
+    GenericKey<8> index_key;
+    std::vector<RID> result;
+    std::mt19937 generator(0);
+    while (!done) {
+      int64_t key = generator() % size + 1;
+      result.clear();
+      index_key.SetFromInteger(key);
+      if (tree.GetValue(index_key, &result)) {
+        EXPECT_EQ(result[0].GetSlotNum(), key);
+      }
+      lookups++;
+    }
+  });
+
+  auto insert_task = [&](uint64_t thread_itr) {
+    GenericKey<8> index_key;
+    Transaction transaction(thread_itr);
+    for (int64_t key = 1; key <= size; key++) {
+      if (static_cast<uint64_t>(key) % num_writers == thread_itr) {
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.Insert(index_key, RID(0, key), &transaction));
+      }
+    }
+  };
+  LaunchParallelTest(num_writers, insert_task);
+  done = true;
+  reader.join();
+  EXPECT_GT(lookups.load(), 0);
+
+  CheckAllKeys(&tree, 1, size);
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  low_key.SetFromInteger(0);
+  high_key.SetFromInteger(size);
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  tree.ScanRange(low_key, high_key, &entries);
+  ASSERT_EQ(entries.size(), size);
+  for (size_t i = 0; i < entries.size(); i++) {
+    EXPECT_EQ(entries[i].first.ToString(), static_cast<int64_t>(i) + 1);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+/*
+ * Mixed insert/lookup throughput of the B-link tree against BPlusTree. The
+ * latter does not implement latch crabbing, so it runs behind a tree-wide
+ * mutex, which is what callers have to do with it today.
+ */
+TEST(BLinkTreeTest, DISABLED_BenchmarkAgainstBPlusTree) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  const uint64_t num_threads = std::max<uint64_t>(32, std::thread::hardware_concurrency());
+  const int64_t keys_per_thread = 10000;
+  const int lookups_per_insert = 4;
+
+  // each thread inserts its own keys and looks up random keys of the others
+  auto run = [&](const char *name, const std::function<void(int64_t)> &insert,
+                 const std::function<void(int64_t)> &lookup) {
+    auto start = std::chrono::steady_clock::now();
+    LaunchParallelTest(num_threads, [&](uint64_t thread_itr) {
+      std::mt19937_64 generator(thread_itr);
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        insert(i * static_cast<int64_t>(num_threads) + static_cast<int64_t>(thread_itr));
+        for (int j = 0; j < lookups_per_insert; j++) {
+          lookup(static_cast<int64_t>(generator() % (keys_per_thread * num_threads)));
+        }
+      }
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double ops = static_cast<double>(num_threads * keys_per_thread * (1 + lookups_per_insert));
+    std::cout << name << ": " << num_threads << " threads, " << ops / elapsed.count() / 1e6 << " Mops/s" << std::endl;
+  };
+
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(4096, &disk_manager);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+    LinkTree tree("foo_pk", &bpm, comparator);
+    run(
+        "BLinkTree",
+        [&](int64_t key) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, RID(0, key));
+        },
+        [&](int64_t key) {
+          GenericKey<8> index_key;
+          std::vector<RID> result;
+          index_key.SetFromInteger(key);
+          tree.GetValue(index_key, &result);
+        });
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+  }
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(4096, &disk_manager);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", &bpm, comparator);
+    std::mutex tree_latch;
+    run(
+        "BPlusTree",
+        [&](int64_t key) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          std::lock_guard<std::mutex> guard(tree_latch);
+          tree.Insert(index_key, RID(0, key));
+        },
+        [&](int64_t key) {
+          GenericKey<8> index_key;
+          std::vector<RID> result;
+          index_key.SetFromInteger(key);
+          std::lock_guard<std::mutex> guard(tree_latch);
+          tree.GetValue(index_key, &result);
+        });
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+  }
+
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
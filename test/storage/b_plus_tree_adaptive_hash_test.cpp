@@ -0,0 +1,222 @@
+/**
+ * b_plus_tree_adaptive_hash_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/adaptive_hash_index.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+namespace {
+
+// draws ranks 0..n-1 with probability proportional to 1 / (rank + 1)^s
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t n, double s) : cdf_(n) {
+    double sum = 0;
+    for (size_t rank = 0; rank < n; rank++) {
+      sum += 1 / std::pow(rank + 1, s);
+      cdf_[rank] = sum;
+    }
+    uniform_ = std::uniform_real_distribution<double>(0, sum);
+  }
+
+  size_t operator()(std::mt19937 *generator) {
+    return std::upper_bound(cdf_.begin(), cdf_.end(), uniform_(*generator)) - cdf_.begin();
+  }
+
+ private:
+  std::vector<double> cdf_;
+  std::uniform_real_distribution<double> uniform_;
+};
+
+}  // namespace
+
+TEST(BPlusTreeAdaptiveHashTest, MatchesTraversal) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  {
+    // small leaves, so that inserts into hot leaves keep splitting them
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 8, true);
+    tree.EnableAdaptiveHashIndex(1024);
+    GenericKey<8> index_key;
+    std::map<int64_t, std::vector<RID>> expected;
+    for (int64_t key = 0; key < 2000; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key));
+      expected[key].push_back(RID(0, key));
+    }
+
+    std::mt19937 generator(15445);
+    ZipfGenerator zipf(2000, 0.99);
+    std::vector<RID> result;
+    for (int i = 0; i < 50000; i++) {
+      auto key = static_cast<int64_t>(zipf(&generator));
+      index_key.SetFromInteger(key);
+      auto it = expected.find(key);
+      switch (generator() % 20) {
+        case 0:
+          // a new key or a second value, splitting the leaf when it is full
+          if (tree.Insert(index_key, RID(1, key))) {
+            expected[key].push_back(RID(1, key));
+          }
+          break;
+        case 1:
+          if (it != expected.end()) {
+            RID value = it->second.back();
+            ASSERT_TRUE(tree.Remove(index_key, value));
+            it->second.pop_back();
+            if (it->second.empty()) {
+              expected.erase(it);
+            }
+          }
+          break;
+        default:
+          result.clear();
+          ASSERT_EQ(it != expected.end(), tree.GetValue(index_key, &result)) << key;
+          if (it != expected.end()) {
+            std::vector<RID> values = it->second;
+            std::sort(values.begin(), values.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+            std::sort(result.begin(), result.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+            ASSERT_EQ(values, result) << key;
+          }
+      }
+    }
+    // the hot keys are answered without traversals
+    EXPECT_GT(tree.GetNumAdaptiveHashHits(), 10000);
+    CheckNoPinnedPages(bpm);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeAdaptiveHashTest, LeafStateIsBounded) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(10, disk_manager);
+  {
+    const size_t num_entries = 16;
+    AdaptiveHashIndex<GenericKey<8>, RID, GenericComparator<8>> adaptive_hash_index(comparator, num_entries);
+    page_id_t page_id;
+    auto *leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+        bpm->NewPage(&page_id)->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, 8);
+    GenericKey<8> index_key;
+    for (int64_t key = 0; key < 8; key++) {
+      index_key.SetFromInteger(key);
+      leaf->Insert(index_key, RID(0, key), comparator);
+    }
+    // make many distinct leaves hot, as if the tree kept splitting, and traverse many more leaves once
+    for (page_id_t leaf_page_id = 0; leaf_page_id < 1000; leaf_page_id++) {
+      leaf->SetPageId(leaf_page_id);
+      for (int i = 0; i < (leaf_page_id % 2 == 0 ? ADAPTIVE_HASH_BUILD_THRESHOLD : 1); i++) {
+        adaptive_hash_index.RecordTraversal(leaf, index_key, 7);
+      }
+      if (leaf_page_id % 3 == 0) {
+        adaptive_hash_index.InvalidateLeaf(leaf_page_id);
+      }
+      ASSERT_LE(adaptive_hash_index.GetNumLeaves(), 2 * num_entries);
+    }
+    // the entries of the last hot leaf are still found
+    page_id_t found_page_id;
+    int slot;
+    EXPECT_TRUE(adaptive_hash_index.Find(index_key, &found_page_id, &slot));
+    EXPECT_EQ(998, found_page_id);
+    bpm->UnpinPage(page_id, false);
+  }
+
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+/*
+ * Point lookups with Zipf-distributed (s = 0.99) keys, before and after the
+ * adaptive hash index is enabled.
+ */
+TEST(BPlusTreeAdaptiveHashTest, DISABLED_BenchmarkZipfLookups) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  const int64_t size = 200000;
+  const size_t num_lookups = 1 << 19;
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  // large enough to hold the whole tree
+  BufferPoolManager *bpm = new BufferPoolManager(size / 100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  {
+    // small internal nodes give the tree four levels, as for a large table
+    const int leaf_max_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>) - 1;
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_max_size, 16);
+    GenericKey<8> index_key;
+    for (int64_t key = 0; key < size; key++) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key));
+    }
+    std::mt19937 generator(15445);
+    ZipfGenerator zipf(size, 0.99);
+    // spread the hot keys over the key space
+    std::vector<int64_t> permutation(size);
+    for (int64_t key = 0; key < size; key++) {
+      permutation[key] = key;
+    }
+    std::shuffle(permutation.begin(), permutation.end(), generator);
+    std::vector<GenericKey<8>> keys(num_lookups);
+    for (auto &key : keys) {
+      key.SetFromInteger(permutation[zipf(&generator)]);
+    }
+
+    auto run = [&](const char *name) {
+      std::vector<RID> result;
+      auto start = std::chrono::steady_clock::now();
+      for (const auto &key : keys) {
+        result.clear();
+        tree.GetValue(key, &result);
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << name << ": " << num_lookups / elapsed.count() / 1e6 << " Mlookups/s" << std::endl;
+    };
+    run("without adaptive hash index");
+    tree.EnableAdaptiveHashIndex();
+    run("with adaptive hash index, warming up");
+    size_t hits = tree.GetNumAdaptiveHashHits();
+    run("with adaptive hash index");
+    std::cout << "hit rate " << static_cast<double>(tree.GetNumAdaptiveHashHits() - hits) / num_lookups << std::endl;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
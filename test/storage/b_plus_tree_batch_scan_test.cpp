@@ -0,0 +1,230 @@
+/**
+ * b_plus_tree_batch_scan_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+TEST(BPlusTreeBatchScanTest, ScanAllLeaves) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  int64_t size = 200;
+  for (int64_t key = size; key > 0; key--) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  CheckNoPinnedPages(bpm);
+
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  int64_t current_key = 1;
+  size_t num_batches = 0;
+  auto iterator = tree.begin();
+  while (iterator.NextBatch(&batch, comparator, nullptr, true) > 0) {
+    // a batch never spans more than a single leaf
+    EXPECT_LE(batch.size(), 5);
+    for (const auto &entry : batch) {
+      EXPECT_EQ(entry.first.ToString(), current_key);
+      EXPECT_EQ(entry.second.GetSlotNum(), current_key);
+      current_key++;
+    }
+    num_batches++;
+  }
+  EXPECT_EQ(current_key, size + 1);
+  EXPECT_GT(num_batches, 1);
+  EXPECT_TRUE(iterator.isEnd());
+  EXPECT_EQ(iterator.NextBatch(&batch, comparator), 0);
+  CheckNoPinnedPages(bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeBatchScanTest, UpperBound) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only, so bounds can fall between two stored keys
+  for (int64_t key = 2; key <= 100; key += 2) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  std::vector<std::pair<int64_t, int64_t>> ranges = {{10, 40}, {11, 41}, {1, 2}, {99, 1000}, {51, 51}, {0, 100}};
+  for (const auto &range : ranges) {
+    low_key.SetFromInteger(range.first);
+    high_key.SetFromInteger(range.second);
+    int64_t expected = range.first % 2 == 0 ? range.first : range.first + 1;
+    expected = std::max<int64_t>(expected, 2);
+    auto iterator = tree.Begin(low_key);
+    while (iterator.NextBatch(&batch, comparator, &high_key) > 0) {
+      for (const auto &entry : batch) {
+        EXPECT_EQ(entry.first.ToString(), expected);
+        expected += 2;
+      }
+    }
+    int64_t last = std::min<int64_t>(range.second, 100);
+    EXPECT_EQ(expected, (last % 2 == 0 ? last : last - 1) + 2) << range.first << "-" << range.second;
+    EXPECT_TRUE(iterator.isEnd());
+  }
+  CheckNoPinnedPages(bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeBatchScanTest, MultiKeyLookup) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  for (bool allow_duplicates : {false, true}) {
+    // small nodes, so that the groups descend through several levels
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, allow_duplicates);
+    GenericKey<8> index_key;
+    std::vector<GenericKey<8>> keys;
+    std::vector<std::vector<RID>> results;
+    tree.GetValues(keys, &results);
+    EXPECT_TRUE(results.empty());
+
+    // even keys only, odd keys are missing
+    for (int64_t key = 2; key <= 1000; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key));
+      if (allow_duplicates && key % 10 == 0) {
+        tree.Insert(index_key, RID(1, key));
+      }
+    }
+    for (int64_t key = 1003; key > 0; key -= 3) {
+      index_key.SetFromInteger(key);
+      keys.push_back(index_key);
+    }
+    tree.GetValues(keys, &results);
+    ASSERT_EQ(keys.size(), results.size());
+    std::vector<RID> expected;
+    for (size_t i = 0; i < keys.size(); i++) {
+      expected.clear();
+      tree.GetValue(keys[i], &expected);
+      EXPECT_EQ(expected, results[i]) << keys[i];
+    }
+    CheckNoPinnedPages(bpm);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+/*
+ * Lookups of random keys one at a time and in batches of increasing size.
+ */
+TEST(BPlusTreeBatchScanTest, DISABLED_BenchmarkMultiKeyLookup) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  const int64_t size = 100000;
+  const size_t num_lookups = 1 << 18;
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  // large enough to hold the whole tree
+  BufferPoolManager *bpm = new BufferPoolManager(size / 100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < size; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  std::mt19937 generator(15445);
+  std::vector<GenericKey<8>> keys(num_lookups);
+  for (auto &key : keys) {
+    key.SetFromInteger(generator() % size);
+  }
+
+  std::vector<RID> result;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &key : keys) {
+    result.clear();
+    tree.GetValue(key, &result);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "GetValue: " << num_lookups / elapsed.count() / 1e6 << " Mlookups/s" << std::endl;
+
+  std::vector<GenericKey<8>> batch;
+  std::vector<std::vector<RID>> results;
+  for (size_t batch_size = 1; batch_size <= 1024; batch_size *= 4) {
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_lookups; i += batch_size) {
+      batch.assign(keys.begin() + i, keys.begin() + i + batch_size);
+      results.clear();
+      tree.GetValues(batch, &results);
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "GetValues, batches of " << batch_size << ": " << num_lookups / elapsed.count() / 1e6
+              << " Mlookups/s" << std::endl;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
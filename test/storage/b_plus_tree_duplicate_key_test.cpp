@@ -0,0 +1,261 @@
+/**
+ * b_plus_tree_duplicate_key_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+TEST(BPlusTreeDuplicateKeyTest, UniqueTreeRejectsDuplicates) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  index_key.SetFromInteger(7);
+  EXPECT_TRUE(tree.Insert(index_key, RID(0, 1), transaction));
+  EXPECT_FALSE(tree.Insert(index_key, RID(0, 2), transaction));
+
+  std::vector<RID> result;
+  tree.GetValue(index_key, &result);
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result[0], RID(0, 1));
+
+  // removing a pair that is not stored leaves the key alone
+  EXPECT_FALSE(tree.Remove(index_key, RID(0, 2), transaction));
+  EXPECT_TRUE(tree.Remove(index_key, RID(0, 1), transaction));
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(index_key, &result));
+  CheckNoPinnedPages(bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeDuplicateKeyTest, PostingLists) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, true);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // key k gets k values, except for a hot key whose list spans several posting pages
+  const int64_t num_keys = 30;
+  const int64_t hot_key = 13;
+  const int64_t hot_count = 5000;
+  auto count_of = [&](int64_t key) { return key == hot_key ? hot_count : key; };
+  for (int64_t key = 1; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    // insert in descending rid order spread over many table pages to exercise sorted insertion
+    for (int64_t i = count_of(key); i > 0; i--) {
+      EXPECT_TRUE(tree.Insert(index_key, RID(static_cast<page_id_t>(i % 17), static_cast<uint32_t>(i)), transaction));
+    }
+    // the same pair twice is still rejected
+    EXPECT_FALSE(tree.Insert(index_key, RID(1, 1), transaction));
+  }
+  CheckNoPinnedPages(bpm);
+
+  for (int64_t key = 1; key <= num_keys; key++) {
+    std::vector<RID> result;
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &result));
+    ASSERT_EQ(result.size(), count_of(key));
+    EXPECT_TRUE(std::is_sorted(result.begin(), result.end(),
+                               [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); }));
+  }
+
+  // the iterator and the batch scan both expand posting lists into one entry per value
+  size_t expected_total = 0;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    expected_total += count_of(key);
+  }
+  size_t total = 0;
+  int64_t last_key = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    int64_t key = (*iterator).first.ToString();
+    EXPECT_GE(key, last_key);
+    EXPECT_FALSE(BPlusTreePostingPage::IsReference((*iterator).second));
+    last_key = key;
+    total++;
+  }
+  EXPECT_EQ(total, expected_total);
+  CheckNoPinnedPages(bpm);
+
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  total = 0;
+  auto iterator = tree.begin();
+  ++iterator;
+  ++iterator;
+  // start the batch scan in the middle of key 2's inline values
+  EXPECT_EQ((*iterator).first.ToString(), 2);
+  while (iterator.NextBatch(&batch, comparator) > 0) {
+    total += batch.size();
+  }
+  EXPECT_EQ(total, expected_total - 2);
+  CheckNoPinnedPages(bpm);
+
+  // drain most of the hot key until its posting list collapses to an inline value, then drop key 2
+  index_key.SetFromInteger(hot_key);
+  for (int64_t i = 1; i < hot_count; i++) {
+    EXPECT_TRUE(tree.Remove(index_key, RID(static_cast<page_id_t>(i % 17), static_cast<uint32_t>(i)), transaction));
+  }
+  EXPECT_FALSE(tree.Remove(index_key, RID(1, 1), transaction));
+  std::vector<RID> result;
+  tree.GetValue(index_key, &result);
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result[0], RID(static_cast<page_id_t>(hot_count % 17), static_cast<uint32_t>(hot_count)));
+
+  index_key.SetFromInteger(2);
+  EXPECT_TRUE(tree.Remove(index_key, RID(1, 1), transaction));
+  EXPECT_TRUE(tree.Remove(index_key, RID(2, 2), transaction));
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(index_key, &result));
+
+  // dropping a whole key also drops its posting list
+  index_key.SetFromInteger(num_keys);
+  tree.Remove(index_key, transaction);
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(index_key, &result));
+  CheckNoPinnedPages(bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeDuplicateKeyTest, ShortListsStayInline) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 64, 64, true);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // page ids are handed out in order, so the id of a fresh page tells how many pages the tree allocated
+  auto pages_allocated = [&]() {
+    page_id_t probe_page_id;
+    bpm->NewPage(&probe_page_id);
+    bpm->UnpinPage(probe_page_id, false);
+    bpm->DeletePage(probe_page_id);
+    return probe_page_id;
+  };
+
+  // every key gets a full inline list, inserted in an order that interleaves the keys so that leaves split in
+  // between the entries of a key
+  const int64_t num_keys = 200;
+  const int64_t dups = BPLUSTREE_INLINE_POSTING_SIZE;
+  for (int64_t i = 0; i < dups; i++) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      RID rid(static_cast<page_id_t>(dups - i), static_cast<uint32_t>(key));
+      EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+    }
+  }
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(tree.Insert(index_key, RID(1, 0), transaction));
+  CheckNoPinnedPages(bpm);
+  // 1600 entries in leaves of at most 64 take a few dozen pages instead of one posting page per key
+  page_id_t before = pages_allocated();
+  EXPECT_LT(before, num_keys / 4);
+
+  for (int64_t key = 0; key < num_keys; key++) {
+    std::vector<RID> result;
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &result));
+    ASSERT_EQ(result.size(), dups);
+    for (int64_t i = 0; i < dups; i++) {
+      EXPECT_EQ(result[i], RID(static_cast<page_id_t>(i + 1), static_cast<uint32_t>(key)));
+    }
+  }
+  size_t total = 0;
+  int64_t last_key = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    int64_t key = (*iterator).first.ToString();
+    EXPECT_GE(key, last_key);
+    last_key = key;
+    total++;
+  }
+  EXPECT_EQ(total, num_keys * dups);
+
+  // one value past the inline limit moves the key to a posting page, the only page this insert allocates
+  index_key.SetFromInteger(7);
+  EXPECT_TRUE(tree.Insert(index_key, RID(0, 7), transaction));
+  EXPECT_EQ(pages_allocated(), before + 2);
+  std::vector<RID> result;
+  EXPECT_TRUE(tree.GetValue(index_key, &result));
+  ASSERT_EQ(result.size(), dups + 1);
+  EXPECT_EQ(result[0], RID(0, 7));
+  auto iterator = tree.begin();
+  while ((*iterator).first.ToString() < 7) {
+    ++iterator;
+  }
+  for (int64_t i = 0; i <= dups; i++, ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), 7);
+    EXPECT_FALSE(BPlusTreePostingPage::IsReference((*iterator).second));
+  }
+  EXPECT_EQ((*iterator).first.ToString(), 8);
+
+  // inline values are removed one at a time, and the key goes away with the last one
+  index_key.SetFromInteger(8);
+  EXPECT_FALSE(tree.Remove(index_key, RID(0, 8), transaction));
+  for (int64_t i = dups; i > 0; i--) {
+    EXPECT_TRUE(tree.Remove(index_key, RID(static_cast<page_id_t>(i), 8), transaction));
+  }
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(index_key, &result));
+  index_key.SetFromInteger(9);
+  tree.Remove(index_key, transaction);
+  result.clear();
+  EXPECT_FALSE(tree.GetValue(index_key, &result));
+  index_key.SetFromInteger(10);
+  result.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &result));
+  EXPECT_EQ(result.size(), dups);
+  CheckNoPinnedPages(bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -19,10 +19,12 @@
 #include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/util/string_util.h"
+#include "gtest/gtest.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -87,4 +89,14 @@ Schema *ParseCreateStatement(const std::string &sql_base) {
   return schema;
 }
 
+/* Checks that every page except the header page is unpinned, as it must be once an operation is done. */
+void CheckNoPinnedPages(BufferPoolManager *bpm) {
+  Page *pages = bpm->GetPages();
+  for (size_t i = 0; i < bpm->GetPoolSize(); i++) {
+    if (pages[i].GetPageId() != HEADER_PAGE_ID) {
+      EXPECT_EQ(pages[i].GetPinCount(), 0) << "page " << pages[i].GetPageId() << " is still pinned";
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,221 @@
+/**
+ * lsm_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/lsm_tree.h"
+
+namespace bustub {
+
+using LSMTree8 = LSMTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+TEST(LSMTreeTest, TombstonesHideOlderLevels) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(32, disk_manager);
+  GenericKey<8> index_key;
+  {
+    // tiny memtables and levels, so that there are many flushes and compactions into several levels
+    LSMTree8 tree("foo_pk", bpm, comparator, 200, 3, 3);
+
+    const int64_t key_range = 3000;
+    std::map<int64_t, int64_t> expected;
+    std::vector<RID> result;
+    auto check_all = [&] {
+      for (int64_t key = 0; key < key_range; key++) {
+        index_key.SetFromInteger(key);
+        result.clear();
+        auto it = expected.find(key);
+        ASSERT_EQ(tree.GetValue(index_key, &result), it != expected.end()) << key;
+        if (it != expected.end()) {
+          ASSERT_EQ(result.size(), 1);
+          EXPECT_EQ(result[0].GetSlotNum(), it->second) << key;
+        }
+      }
+    };
+
+    // every key in the deeper levels
+    for (int64_t key = 0; key < key_range; key++) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key));
+      expected[key] = key;
+    }
+    tree.WaitForBackgroundWork();
+    std::vector<size_t> sizes = tree.GetLevelSizes();
+    ASSERT_GE(sizes.size(), 3);
+    EXPECT_LT(sizes[0], 3 * 200);
+    check_all();
+
+    // tombstones for every third key, first in the memtable and then in level 0, above the records they hide
+    for (int64_t key = 0; key < key_range; key += 3) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+      expected.erase(key);
+    }
+    check_all();
+    tree.WaitForBackgroundWork();
+    check_all();
+
+    // newer records above the tombstones of half of the removed keys
+    for (int64_t key = 0; key < key_range; key += 6) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key_range + key));
+      expected[key] = key_range + key;
+    }
+    check_all();
+
+    // overwrite other keys until the tombstones are compacted into the levels below, and into the last one
+    for (int64_t round = 0; round < 4; round++) {
+      for (int64_t key = 1; key < key_range; key += 3) {
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, RID(round, key));
+        expected[key] = key;
+      }
+      tree.WaitForBackgroundWork();
+      check_all();
+    }
+    // compaction keeps at most one record per key in a level
+    sizes = tree.GetLevelSizes();
+    EXPECT_GT(sizes.back(), 0);
+    EXPECT_LE(sizes.back(), key_range);
+  }
+
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(LSMTreeTest, ConcurrentWritersAndReaders) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(32, disk_manager);
+  {
+    LSMTree8 tree("foo_pk", bpm, comparator, 500, 2, 4);
+    const int64_t num_writers = 4;
+    const int64_t keys_per_writer = 5000;
+
+    std::vector<std::thread> threads;
+    for (int64_t writer = 0; writer < num_writers; writer++) {
+      threads.emplace_back([&, writer] {
+        GenericKey<8> index_key;
+        for (int64_t key = writer; key < num_writers * keys_per_writer; key += num_writers) {
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, RID(0, key));
+        }
+        for (int64_t key = writer; key < num_writers * keys_per_writer; key += 2 * num_writers) {
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key);
+        }
+      });
+    }
+    threads.emplace_back([&] {
+      GenericKey<8> index_key;
+      std::mt19937 generator(0);
+      std::vector<RID> result;
+      for (int i = 0; i < 20000; i++) {
+        int64_t key = generator() % (num_writers * keys_per_writer);
+        index_key.SetFromInteger(key);
+        result.clear();
+        if (tree.GetValue(index_key, &result)) {
+          EXPECT_EQ(result[0].GetSlotNum(), key);
+        }
+      }
+    });
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    GenericKey<8> index_key;
+    std::vector<RID> result;
+    for (int64_t key = 0; key < num_writers * keys_per_writer; key++) {
+      index_key.SetFromInteger(key);
+      result.clear();
+      ASSERT_EQ(tree.GetValue(index_key, &result), key % (2 * num_writers) >= num_writers) << key;
+    }
+  }
+
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+/*
+ * Random inserts into an index about ten times the size of the buffer pool.
+ * Reports time and the number of pages written, including the writes of
+ * flushes and compactions that finish after the last insert.
+ */
+TEST(LSMTreeTest, DISABLED_BenchmarkRandomInsert) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  const size_t pool_size = 64;
+  // a leaf of 8 byte keys holds about 250 entries at fill factor 1
+  const int64_t size = pool_size * 10 * 250;
+  std::vector<int64_t> keys(size);
+  for (int64_t key = 0; key < size; key++) {
+    keys[key] = key;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+  auto run = [&](const char *name, auto *tree, DiskManager *disk_manager, auto &&wait) {
+    GenericKey<8> index_key;
+    auto start = std::chrono::steady_clock::now();
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree->Insert(index_key, RID(0, key));
+    }
+    wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << size / elapsed.count() / 1e3 << " Kinserts/s, " << disk_manager->GetNumWrites()
+              << " page writes" << std::endl;
+
+    std::vector<RID> result;
+    for (int64_t key = 0; key < size; key += 997) {
+      result.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree->GetValue(index_key, &result));
+      EXPECT_EQ(result[0].GetSlotNum(), key);
+    }
+  };
+
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(pool_size, &disk_manager);
+    LSMTree8 tree("foo_pk", &bpm, comparator);
+    run("LSMTree", &tree, &disk_manager, [&] { tree.WaitForBackgroundWork(); });
+  }
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManager bpm(pool_size, &disk_manager);
+    page_id_t page_id;
+    bpm.NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", &bpm, comparator);
+    run("BPlusTree", &tree, &disk_manager, [] {});
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+  }
+
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub